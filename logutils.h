@@ -36,8 +36,10 @@
 #if ENABLE_ASSESSMENT
 extern guint assess_number;
 #define ASSESS(name, ...) (g_string_append_printf (desc, "! assess n=%d name="#name " ", assess_number++, ##__VA_ARGS__))
+#define ASSESS_BUILDER(builder, name) (gst_worker_builder_add ((builder), "assess", #name, "n", assess_number++, NULL))
 #else
 #define ASSESS(name, ...) ((void) FALSE);
+#define ASSESS_BUILDER(builder, name) ((void) FALSE);
 #endif //ENABLE_ASSESSMENT
 #define LOW_RES_W 300 /* 100 */ /* 160 */       /* 320 */
 #define LOW_RES_H 200 /* 56 */ /* 120 */        /* 240 */
@@ -0,0 +1,703 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE             /* O_DIRECT, fallocate */
+#endif
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "gstasyncfilesink.h"
+#include "../logutils.h"
+
+GST_DEBUG_CATEGORY_STATIC (asyncfilesink_debug);
+#define GST_CAT_DEFAULT asyncfilesink_debug
+
+#define ASYNC_FILE_SINK_ALIGN 4096
+#define ASYNC_FILE_SINK_IDLE_WAKEUP (100 * G_TIME_SPAN_MILLISECOND)
+
+#define DEFAULT_RING_SIZE 64    /* MB */
+#define DEFAULT_WRITE_SIZE 1024 /* KB */
+#define DEFAULT_PREALLOCATE 64  /* MB */
+#define DEFAULT_SYNC_INTERVAL 1000      /* ms */
+#define DEFAULT_STALL_THRESHOLD 100     /* ms */
+
+enum
+{
+  PROP_0,
+  PROP_LOCATION,
+  PROP_RING_SIZE,
+  PROP_WRITE_SIZE,
+  PROP_DIRECT,
+  PROP_PREALLOCATE,
+  PROP_SYNC_INTERVAL,
+  PROP_STALL_THRESHOLD,
+  PROP_STALLS,
+  PROP_RING_FULL,
+};
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+G_DEFINE_TYPE (GstAsyncFileSink, gst_async_file_sink, GST_TYPE_BASE_SINK);
+
+static void
+gst_async_file_sink_init (GstAsyncFileSink * sink)
+{
+  sink->location = NULL;
+  sink->ring_size = DEFAULT_RING_SIZE;
+  sink->write_size = DEFAULT_WRITE_SIZE;
+  sink->preallocate = DEFAULT_PREALLOCATE;
+  sink->sync_interval = DEFAULT_SYNC_INTERVAL;
+  sink->stall_threshold = DEFAULT_STALL_THRESHOLD;
+  sink->direct = FALSE;
+  sink->fd = -1;
+
+  g_mutex_init (&sink->lock);
+  g_cond_init (&sink->cond);
+
+  gst_base_sink_set_sync (GST_BASE_SINK (sink), FALSE);
+}
+
+static void
+gst_async_file_sink_finalize (GstAsyncFileSink * sink)
+{
+  g_free (sink->location);
+  g_mutex_clear (&sink->lock);
+  g_cond_clear (&sink->cond);
+
+  if (G_OBJECT_CLASS (gst_async_file_sink_parent_class)->finalize)
+    (*G_OBJECT_CLASS (gst_async_file_sink_parent_class)->finalize)
+        (G_OBJECT (sink));
+}
+
+static void
+gst_async_file_sink_set_property (GstAsyncFileSink * sink, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GST_OBJECT_LOCK (sink);
+  switch (prop_id) {
+    case PROP_LOCATION:
+      g_free (sink->location);
+      sink->location = g_value_dup_string (value);
+      break;
+    case PROP_RING_SIZE:
+      sink->ring_size = g_value_get_uint (value);
+      break;
+    case PROP_WRITE_SIZE:
+      sink->write_size = g_value_get_uint (value);
+      break;
+    case PROP_DIRECT:
+      sink->direct = g_value_get_boolean (value);
+      break;
+    case PROP_PREALLOCATE:
+      sink->preallocate = g_value_get_uint (value);
+      break;
+    case PROP_SYNC_INTERVAL:
+      sink->sync_interval = g_value_get_uint (value);
+      break;
+    case PROP_STALL_THRESHOLD:
+      sink->stall_threshold = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (sink), prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (sink);
+}
+
+static void
+gst_async_file_sink_get_property (GstAsyncFileSink * sink, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (prop_id) {
+    case PROP_LOCATION:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_string (value, sink->location);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_RING_SIZE:
+      g_value_set_uint (value, sink->ring_size);
+      break;
+    case PROP_WRITE_SIZE:
+      g_value_set_uint (value, sink->write_size);
+      break;
+    case PROP_DIRECT:
+      g_value_set_boolean (value, sink->direct);
+      break;
+    case PROP_PREALLOCATE:
+      g_value_set_uint (value, sink->preallocate);
+      break;
+    case PROP_SYNC_INTERVAL:
+      g_value_set_uint (value, sink->sync_interval);
+      break;
+    case PROP_STALL_THRESHOLD:
+      g_value_set_uint (value, sink->stall_threshold);
+      break;
+    case PROP_STALLS:
+      g_mutex_lock (&sink->lock);
+      g_value_set_uint64 (value, sink->stalls);
+      g_mutex_unlock (&sink->lock);
+      break;
+    case PROP_RING_FULL:
+      g_mutex_lock (&sink->lock);
+      g_value_set_uint64 (value, sink->ring_full);
+      g_mutex_unlock (&sink->lock);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (sink), prop_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @brief Turn O_DIRECT off for the rest of the file.
+ *
+ * Needed for an unaligned tail or after a seek, the caller must make sure
+ * the writer is idle.
+ */
+static void
+gst_async_file_sink_disable_direct (GstAsyncFileSink * sink)
+{
+#ifdef O_DIRECT
+  if (sink->direct_active) {
+    int flags = fcntl (sink->fd, F_GETFL);
+    if (flags != -1)
+      fcntl (sink->fd, F_SETFL, flags & ~O_DIRECT);
+    sink->direct_active = FALSE;
+  }
+#endif
+}
+
+/**
+ * @brief Reserve disk blocks ahead of the write position.
+ *
+ * FALLOC_FL_KEEP_SIZE leaves the file size alone, the reserved tail is
+ * trimmed again when the file is closed.
+ */
+static void
+gst_async_file_sink_preallocate (GstAsyncFileSink * sink, guint64 offset,
+    gsize len)
+{
+#ifdef FALLOC_FL_KEEP_SIZE
+  guint64 chunk = (guint64) sink->preallocate * 1024 * 1024;
+  guint64 start = MAX (sink->allocated, offset);
+
+  if (chunk == 0 || offset + len <= sink->allocated)
+    return;
+
+  chunk = MAX (chunk, offset + len - start);
+  if (fallocate (sink->fd, FALLOC_FL_KEEP_SIZE, start, chunk) == 0) {
+    sink->allocated = start + chunk;
+  } else {
+    GST_DEBUG_OBJECT (sink, "fallocate: %s", g_strerror (errno));
+    sink->preallocate = 0;
+  }
+#endif
+}
+
+static gboolean
+gst_async_file_sink_pwrite (GstAsyncFileSink * sink, const guint8 * data,
+    gsize len, guint64 offset)
+{
+  while (len > 0) {
+    ssize_t n = pwrite (sink->fd, data, len, offset);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return FALSE;
+    }
+    data += n;
+    len -= n;
+    offset += n;
+  }
+  return TRUE;
+}
+
+/**
+ * @brief The writer thread.
+ *
+ * Writes whole blocks from the ring as soon as they are filled, and
+ * whatever there is when idle or draining. The lock is never held during
+ * disk I/O, so the streaming thread only waits for a memcpy unless the
+ * ring is full.
+ */
+static gpointer
+gst_async_file_sink_writer (GstAsyncFileSink * sink)
+{
+  gsize block = (gsize) sink->write_size * 1024;
+  gint64 sync_time = (gint64) sink->sync_interval * G_TIME_SPAN_MILLISECOND;
+  gint64 stall_time = (gint64) sink->stall_threshold * G_TIME_SPAN_MILLISECOND;
+  gint64 last_sync = g_get_monotonic_time ();
+  gboolean dirty = FALSE, timeout = FALSE;
+
+  g_mutex_lock (&sink->lock);
+  while (!sink->quit && sink->error == GST_FLOW_OK) {
+    guint64 avail = sink->head - sink->tail;
+    gsize index = sink->tail % sink->ring_bytes;
+    gsize len = MIN (avail, sink->ring_bytes - index);
+    guint64 offset = sink->offset;
+    gint64 now = g_get_monotonic_time ();
+    gint64 start, elapsed;
+    gboolean ok;
+    int errsv;
+
+    if (dirty && sync_time > 0 && sync_time <= now - last_sync) {
+      g_mutex_unlock (&sink->lock);
+      fdatasync (sink->fd);
+      g_mutex_lock (&sink->lock);
+      last_sync = now;
+      dirty = FALSE;
+      continue;
+    }
+
+    if (len > block)
+      len = block;
+    if (sink->direct_active && len % ASYNC_FILE_SINK_ALIGN) {
+      if (sink->draining && len == avail)
+        gst_async_file_sink_disable_direct (sink);
+      else
+        len -= len % ASYNC_FILE_SINK_ALIGN;
+    }
+
+    if (len == 0 || (len < block && !sink->draining && !timeout)) {
+      gint64 deadline = now + ASYNC_FILE_SINK_IDLE_WAKEUP;
+      if (dirty && sync_time > 0)
+        deadline = last_sync + sync_time;
+      timeout = !g_cond_wait_until (&sink->cond, &sink->lock, deadline);
+      continue;
+    }
+    timeout = FALSE;
+    g_mutex_unlock (&sink->lock);
+
+    start = g_get_monotonic_time ();
+    gst_async_file_sink_preallocate (sink, offset, len);
+    ok = gst_async_file_sink_pwrite (sink, sink->ring + index, len, offset);
+    errsv = errno;
+    elapsed = g_get_monotonic_time () - start;
+
+    g_mutex_lock (&sink->lock);
+    if (!ok) {
+      sink->error = GST_FLOW_ERROR;
+      g_cond_broadcast (&sink->cond);
+      g_mutex_unlock (&sink->lock);
+      GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+          ("Error while writing to file \"%s\".", sink->location),
+          ("%s", g_strerror (errsv)));
+      g_mutex_lock (&sink->lock);
+      break;
+    }
+
+    sink->tail += len;
+    sink->offset += len;
+    sink->length = MAX (sink->length, sink->offset);
+    if (sink->max_write_time < elapsed)
+      sink->max_write_time = elapsed;
+    if (stall_time > 0 && stall_time <= elapsed) {
+      sink->stalls += 1;
+      WARN ("%s: write of %d bytes stalled for %d ms (%d%% of ring used)",
+          sink->location, (gint) len, (gint) (elapsed / 1000),
+          (gint) ((sink->head - sink->tail) * 100 / sink->ring_bytes));
+    }
+    dirty = TRUE;
+    g_cond_broadcast (&sink->cond);
+  }
+  g_mutex_unlock (&sink->lock);
+  return NULL;
+}
+
+/**
+ * @brief Wait for the writer to empty the ring, called with the lock held.
+ * @return TRUE if everything queued is on disk
+ */
+static gboolean
+gst_async_file_sink_drain (GstAsyncFileSink * sink)
+{
+  sink->draining = TRUE;
+  g_cond_broadcast (&sink->cond);
+  while (sink->tail != sink->head && sink->error == GST_FLOW_OK &&
+      !sink->flushing && sink->writer != NULL)
+    g_cond_wait (&sink->cond, &sink->lock);
+  sink->draining = FALSE;
+  return sink->tail == sink->head;
+}
+
+static gboolean
+gst_async_file_sink_start (GstBaseSink * basesink)
+{
+  GstAsyncFileSink *sink = GST_ASYNC_FILE_SINK (basesink);
+  gsize block, ring;
+  int flags = O_WRONLY | O_CREAT | O_TRUNC;
+  gpointer mem = NULL;
+  GError *error = NULL;
+
+  if (sink->location == NULL || sink->location[0] == '\0') {
+    GST_ELEMENT_ERROR (sink, RESOURCE, NOT_FOUND,
+        ("No file name specified for writing."), (NULL));
+    return FALSE;
+  }
+
+  block = MAX (sink->write_size, 4) * 1024;
+  block -= block % ASYNC_FILE_SINK_ALIGN;
+  ring = (gsize) sink->ring_size * 1024 * 1024;
+  ring = MAX (ring - ring % block, 2 * block);
+  sink->write_size = block / 1024;
+
+  if (posix_memalign (&mem, ASYNC_FILE_SINK_ALIGN, ring) != 0) {
+    GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT,
+        ("Could not allocate a %d MB write ring.", (gint) (ring >> 20)),
+        (NULL));
+    return FALSE;
+  }
+
+  sink->direct_active = FALSE;
+#ifdef O_DIRECT
+  if (sink->direct) {
+    sink->fd = open (sink->location, flags | O_DIRECT, 0644);
+    if (sink->fd == -1 && errno == EINVAL)
+      WARN ("%s: O_DIRECT not supported, using buffered writes",
+          sink->location);
+    sink->direct_active = sink->fd != -1;
+  }
+#endif
+  if (sink->fd == -1)
+    sink->fd = open (sink->location, flags, 0644);
+  if (sink->fd == -1) {
+    GST_ELEMENT_ERROR (sink, RESOURCE, OPEN_WRITE,
+        ("Could not open file \"%s\" for writing.", sink->location),
+        ("%s", g_strerror (errno)));
+    free (mem);
+    return FALSE;
+  }
+
+  sink->ring = mem;
+  sink->ring_bytes = ring;
+  sink->head = sink->tail = 0;
+  sink->offset = sink->length = sink->allocated = 0;
+  sink->flushing = sink->draining = sink->quit = FALSE;
+  sink->overrun = FALSE;
+  sink->error = GST_FLOW_OK;
+  sink->max_write_time = 0;
+
+  sink->writer = g_thread_try_new ("asyncfilesink",
+      (GThreadFunc) gst_async_file_sink_writer, sink, &error);
+  if (sink->writer == NULL) {
+    GST_ELEMENT_ERROR (sink, RESOURCE, FAILED,
+        ("Could not start the writer thread."), ("%s", error->message));
+    g_error_free (error);
+    close (sink->fd);
+    sink->fd = -1;
+    free (sink->ring);
+    sink->ring = NULL;
+    return FALSE;
+  }
+
+  INFO ("%s: %d MB ring, %d KB writes%s", sink->location,
+      (gint) (ring >> 20), (gint) (block >> 10),
+      sink->direct_active ? ", O_DIRECT" : "");
+  return TRUE;
+}
+
+static gboolean
+gst_async_file_sink_stop (GstBaseSink * basesink)
+{
+  GstAsyncFileSink *sink = GST_ASYNC_FILE_SINK (basesink);
+  GThread *writer;
+
+  g_mutex_lock (&sink->lock);
+  sink->flushing = FALSE;
+  if (!gst_async_file_sink_drain (sink))
+    WARN ("%s: %" G_GUINT64_FORMAT " bytes lost on close", sink->location,
+        sink->head - sink->tail);
+  sink->quit = TRUE;
+  g_cond_broadcast (&sink->cond);
+  writer = sink->writer;
+  sink->writer = NULL;
+  g_mutex_unlock (&sink->lock);
+
+  if (writer)
+    g_thread_join (writer);
+
+  if (sink->fd != -1) {
+    if (sink->allocated > sink->length)
+      if (ftruncate (sink->fd, sink->length) != 0)
+        GST_DEBUG_OBJECT (sink, "ftruncate: %s", g_strerror (errno));
+    fdatasync (sink->fd);
+    close (sink->fd);
+    sink->fd = -1;
+  }
+
+  if (sink->stalls || sink->ring_full) {
+    INFO ("%s: %" G_GUINT64_FORMAT " write stalls (worst %d ms), ring full %"
+        G_GUINT64_FORMAT " times", sink->location, sink->stalls,
+        (gint) (sink->max_write_time / 1000), sink->ring_full);
+  }
+
+  free (sink->ring);
+  sink->ring = NULL;
+  return TRUE;
+}
+
+/**
+ * @brief Queue a buffer for the writer.
+ *
+ * If the ring has no room the streaming thread waits for the writer, the
+ * muxed stream must not have holes. The recorder sheds load before the
+ * muxer with a leaky queue instead, see gst_recorder_build_pipeline().
+ */
+static GstFlowReturn
+gst_async_file_sink_render (GstBaseSink * basesink, GstBuffer * buffer)
+{
+  GstAsyncFileSink *sink = GST_ASYNC_FILE_SINK (basesink);
+  GstFlowReturn ret = GST_FLOW_OK;
+  gboolean overrun = FALSE;
+  GstMapInfo info;
+  gsize done = 0;
+
+  if (!gst_buffer_map (buffer, &info, GST_MAP_READ))
+    return GST_FLOW_ERROR;
+
+  g_mutex_lock (&sink->lock);
+  while (done < info.size) {
+    gsize room = sink->ring_bytes - (sink->head - sink->tail);
+    gsize index = sink->head % sink->ring_bytes;
+    gsize len = MIN (info.size - done, room);
+    gsize first = MIN (len, sink->ring_bytes - index);
+
+    if (sink->error != GST_FLOW_OK) {
+      ret = sink->error;
+      break;
+    }
+    if (sink->flushing) {
+      ret = GST_FLOW_FLUSHING;
+      break;
+    }
+    if (room == 0) {
+      if (!sink->overrun) {
+        sink->ring_full++;
+        sink->overrun = overrun = TRUE;
+      }
+      g_cond_wait (&sink->cond, &sink->lock);
+      continue;
+    }
+
+    memcpy (sink->ring + index, info.data + done, first);
+    memcpy (sink->ring, info.data + done + first, len - first);
+    sink->head += len;
+    done += len;
+    g_cond_broadcast (&sink->cond);
+  }
+  if (done == info.size && sink->head - sink->tail < sink->ring_bytes)
+    sink->overrun = FALSE;
+  g_mutex_unlock (&sink->lock);
+  gst_buffer_unmap (buffer, &info);
+
+  if (overrun) {
+    GST_ELEMENT_WARNING (sink, RESOURCE, WRITE,
+        ("Disk too slow, waiting to write \"%s\".", sink->location),
+        ("write ring of %d MB is full", (gint) (sink->ring_bytes >> 20)));
+  }
+  return ret;
+}
+
+static gboolean
+gst_async_file_sink_event (GstBaseSink * basesink, GstEvent * event)
+{
+  GstAsyncFileSink *sink = GST_ASYNC_FILE_SINK (basesink);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_SEGMENT:{
+      const GstSegment *segment;
+
+      gst_event_parse_segment (event, &segment);
+      if (segment->format != GST_FORMAT_BYTES)
+        break;
+
+      /* A muxer rewriting its headers, everything queued must be on disk
+       * before the write position can move. */
+      g_mutex_lock (&sink->lock);
+      if (segment->start != sink->offset + (sink->head - sink->tail)) {
+        gst_async_file_sink_drain (sink);
+        gst_async_file_sink_disable_direct (sink);
+        sink->offset = segment->start;
+      }
+      g_mutex_unlock (&sink->lock);
+      break;
+    }
+    case GST_EVENT_EOS:
+      g_mutex_lock (&sink->lock);
+      gst_async_file_sink_drain (sink);
+      g_mutex_unlock (&sink->lock);
+      break;
+    default:
+      break;
+  }
+
+  return GST_BASE_SINK_CLASS (gst_async_file_sink_parent_class)->event
+      (basesink, event);
+}
+
+static gboolean
+gst_async_file_sink_query (GstBaseSink * basesink, GstQuery * query)
+{
+  GstAsyncFileSink *sink = GST_ASYNC_FILE_SINK (basesink);
+  GstFormat format;
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_POSITION:
+      gst_query_parse_position (query, &format, NULL);
+      if (format != GST_FORMAT_BYTES && format != GST_FORMAT_DEFAULT)
+        return FALSE;
+      g_mutex_lock (&sink->lock);
+      gst_query_set_position (query, GST_FORMAT_BYTES,
+          sink->offset + (sink->head - sink->tail));
+      g_mutex_unlock (&sink->lock);
+      return TRUE;
+    case GST_QUERY_SEEKING:
+      gst_query_parse_seeking (query, &format, NULL, NULL, NULL);
+      gst_query_set_seeking (query, format,
+          format == GST_FORMAT_BYTES || format == GST_FORMAT_DEFAULT, 0, -1);
+      return TRUE;
+    case GST_QUERY_FORMATS:
+      gst_query_set_formats (query, 2, GST_FORMAT_DEFAULT, GST_FORMAT_BYTES);
+      return TRUE;
+    default:
+      break;
+  }
+
+  return GST_BASE_SINK_CLASS (gst_async_file_sink_parent_class)->query
+      (basesink, query);
+}
+
+static gboolean
+gst_async_file_sink_unlock (GstBaseSink * basesink)
+{
+  GstAsyncFileSink *sink = GST_ASYNC_FILE_SINK (basesink);
+
+  g_mutex_lock (&sink->lock);
+  sink->flushing = TRUE;
+  g_cond_broadcast (&sink->cond);
+  g_mutex_unlock (&sink->lock);
+  return TRUE;
+}
+
+static gboolean
+gst_async_file_sink_unlock_stop (GstBaseSink * basesink)
+{
+  GstAsyncFileSink *sink = GST_ASYNC_FILE_SINK (basesink);
+
+  g_mutex_lock (&sink->lock);
+  sink->flushing = FALSE;
+  g_mutex_unlock (&sink->lock);
+  return TRUE;
+}
+
+static void
+gst_async_file_sink_class_init (GstAsyncFileSinkClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBaseSinkClass *basesink_class = GST_BASE_SINK_CLASS (klass);
+
+  object_class->set_property =
+      (GObjectSetPropertyFunc) gst_async_file_sink_set_property;
+  object_class->get_property =
+      (GObjectGetPropertyFunc) gst_async_file_sink_get_property;
+  object_class->finalize = (GObjectFinalizeFunc) gst_async_file_sink_finalize;
+
+  g_object_class_install_property (object_class, PROP_LOCATION,
+      g_param_spec_string ("location", "File Location",
+          "Location of the file to write", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_RING_SIZE,
+      g_param_spec_uint ("ring-size", "Ring Size",
+          "Size of the RAM ring absorbing disk stalls, in MB",
+          1, 4096, DEFAULT_RING_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_WRITE_SIZE,
+      g_param_spec_uint ("write-size", "Write Size",
+          "Size of each disk write, in KB", 4, 65536, DEFAULT_WRITE_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_DIRECT,
+      g_param_spec_boolean ("direct", "Direct I/O",
+          "Bypass the page cache with O_DIRECT where supported", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_PREALLOCATE,
+      g_param_spec_uint ("preallocate", "Preallocate",
+          "Reserve disk space this many MB ahead of the writes (0=off)",
+          0, 65536, DEFAULT_PREALLOCATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_SYNC_INTERVAL,
+      g_param_spec_uint ("sync-interval", "Sync Interval",
+          "Milliseconds between fdatasync calls (0=only on close)",
+          0, G_MAXUINT, DEFAULT_SYNC_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_STALL_THRESHOLD,
+      g_param_spec_uint ("stall-threshold", "Stall Threshold",
+          "Milliseconds after which a single write counts as a stall",
+          0, G_MAXUINT, DEFAULT_STALL_THRESHOLD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_STALLS,
+      g_param_spec_uint64 ("stalls", "Stalls",
+          "Number of writes slower than the stall threshold",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_RING_FULL,
+      g_param_spec_uint64 ("ring-full", "Ring Full",
+          "Number of times the ring was full and upstream had to wait",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&sinktemplate));
+
+  gst_element_class_set_static_metadata (element_class,
+      "Asynchronous file sink", "Sink/File",
+      "Write a stream to a file from a RAM ring on a writer thread",
+      "agent <agent@local>");
+
+  basesink_class->start = GST_DEBUG_FUNCPTR (gst_async_file_sink_start);
+  basesink_class->stop = GST_DEBUG_FUNCPTR (gst_async_file_sink_stop);
+  basesink_class->render = GST_DEBUG_FUNCPTR (gst_async_file_sink_render);
+  basesink_class->event = GST_DEBUG_FUNCPTR (gst_async_file_sink_event);
+  basesink_class->query = GST_DEBUG_FUNCPTR (gst_async_file_sink_query);
+  basesink_class->unlock = GST_DEBUG_FUNCPTR (gst_async_file_sink_unlock);
+  basesink_class->unlock_stop =
+      GST_DEBUG_FUNCPTR (gst_async_file_sink_unlock_stop);
+
+  GST_DEBUG_CATEGORY_INIT (asyncfilesink_debug, "asyncfilesink", 0,
+      "Asynchronous file sink");
+}
@@ -0,0 +1,94 @@
+/* gst-switch							      -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_ASYNC_FILE_SINK_H__
+#define __GST_ASYNC_FILE_SINK_H__
+
+#include <gst/gst.h>
+#include <gst/base/gstbasesink.h>
+
+G_BEGIN_DECLS
+#define GST_TYPE_ASYNC_FILE_SINK \
+  (gst_async_file_sink_get_type ())
+#define GST_ASYNC_FILE_SINK(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj),GST_TYPE_ASYNC_FILE_SINK,GstAsyncFileSink))
+#define GST_ASYNC_FILE_SINK_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass),GST_TYPE_ASYNC_FILE_SINK,GstAsyncFileSinkClass))
+#define GST_IS_ASYNC_FILE_SINK(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_ASYNC_FILE_SINK))
+#define GST_IS_ASYNC_FILE_SINK_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_ASYNC_FILE_SINK))
+typedef struct _GstAsyncFileSink GstAsyncFileSink;
+typedef struct _GstAsyncFileSinkClass GstAsyncFileSinkClass;
+
+/**
+ * @brief File sink writing from a RAM ring on its own thread.
+ *
+ * The streaming thread only copies buffers into the ring, a writer thread
+ * drains it to disk in large aligned blocks. If the disk stalls for
+ * longer than the ring can absorb, upstream waits for the writer.
+ */
+struct _GstAsyncFileSink
+{
+  GstBaseSink base;
+
+  gchar *location;
+  guint ring_size;              /* MB */
+  guint write_size;             /* KB */
+  guint preallocate;            /* MB */
+  guint sync_interval;          /* ms */
+  guint stall_threshold;        /* ms */
+  gboolean direct;
+
+  GMutex lock;
+  GCond cond;                   /* data queued, space freed or drained */
+  GThread *writer;
+  int fd;
+  gboolean direct_active;
+
+  guint8 *ring;
+  gsize ring_bytes;
+  guint64 head;                 /* total bytes queued */
+  guint64 tail;                 /* total bytes written */
+  guint64 offset;               /* file offset of tail */
+  guint64 allocated;            /* end of the preallocated file range */
+  guint64 length;               /* end of the data written so far */
+  gboolean flushing;
+  gboolean draining;
+  gboolean quit;
+  gboolean overrun;
+  GstFlowReturn error;
+
+  guint64 stalls;
+  guint64 ring_full;            /* times upstream waited for room */
+  gint64 max_write_time;        /* us */
+};
+
+/**
+ * @brief GstAsyncFileSinkClass
+ */
+struct _GstAsyncFileSinkClass
+{
+  GstBaseSinkClass base_class;
+};
+
+GType gst_async_file_sink_get_type (void);
+
+G_END_DECLS
+#endif //__GST_ASYNC_FILE_SINK_H__
@@ -25,6 +25,7 @@
 #include "gsttcpmixsrc.h"
 #include "gstswitch.h"
 #include "gstconvbin.h"
+#include "gstasyncfilesink.h"
 #include "../logutils.h"
 
 static gboolean
@@ -44,6 +45,11 @@ plugin_init (GstPlugin * plugin)
     return FALSE;
   }
 
+  if (!gst_element_register (plugin, "asyncfilesink", GST_RANK_NONE,
+          GST_TYPE_ASYNC_FILE_SINK)) {
+    return FALSE;
+  }
+
   return TRUE;
 }
 
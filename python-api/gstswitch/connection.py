@@ -24,6 +24,15 @@ class Connection(object):
     """
     CONNECTION_FLAGS = Gio.DBusConnectionFlags.AUTHENTICATION_CLIENT
 
+    # The arguments of the methods which can be called in a batch
+    BATCH_SIGNATURES = {
+        'set_composite_mode': '(i)',
+        'adjust_pip': '(iiii)',
+        'switch': '(ii)',
+        'click_video': '(iiii)',
+        'new_record': '()',
+    }
+
     def __init__(
             self,
             address="tcp:host=127.0.0.1,port=5000",
@@ -279,6 +288,32 @@ class Connection(object):
             new_message = "{0}: {1}".format(message, "get_preview_ports")
             raise ConnectionError(new_message)
 
+    def get_previews(self):
+        """get_previews(out a(iii) previews);
+        Calls get_previews remotely
+
+        :param: None
+        :returns: tuple with first element the list of (port, serve, type)
+        of each preview
+        """
+        try:
+            connection = self.connection
+            previews = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_previews',
+                None,
+                GLib.VariantType.new("(a(iii))"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return previews
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_previews")
+            raise ConnectionError(new_message)
+
     def set_composite_mode(self, mode):
         """set_composite_mode(in  i channel,
                                 out b result);
@@ -382,6 +417,250 @@ class Connection(object):
             new_message = "{0}: {1}".format(message, "new_record")
             raise ConnectionError(new_message)
 
+    def get_sink_stats(self):
+        """get_sink_stats(out a(suuxxxtu) stats);
+        Calls get_sink_stats remotely
+
+        :returns: tuple with first element being the list of stats
+        """
+        try:
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_sink_stats',
+                None,
+                GLib.VariantType.new("(a(suuxxxtu))"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_sink_stats")
+            raise ConnectionError(new_message)
+
+    def set_record_encoder(self, encoder):
+        """set_record_encoder(in  s encoder,
+                              out b result);
+        Calls set_record_encoder remotely
+
+        :param encoder: encoder spec, e.g. "h264:crf=20,preset=veryfast"
+        :returns: tuple with first element True if the spec was accepted
+        """
+        try:
+            args = GLib.Variant('(s)', (encoder,))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'set_record_encoder',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "set_record_encoder")
+            raise ConnectionError(new_message)
+
+    def replay_save(self, port, start, end, filename):
+        """replay_save(in  i port,
+                       in  i start,
+                       in  i end,
+                       in  s filename,
+                       out b result);
+        Calls replay_save remotely
+
+        :param port: the video input port, 0 for the output
+        :param start: start of the range in milliseconds before now
+        :param end: end of the range in milliseconds before now
+        :param filename: the file to save to
+        :returns: tuple with first element True if saving started
+        """
+        try:
+            args = GLib.Variant('(iiis)', (port, start, end, filename,))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'replay_save',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "replay_save")
+            raise ConnectionError(new_message)
+
+    def replay_play(self, port, start, end):
+        """replay_play(in  i port,
+                       in  i start,
+                       in  i end,
+                       out b result);
+        Calls replay_play remotely
+
+        :param port: the video input port, 0 for the output
+        :param start: start of the range in milliseconds before now
+        :param end: end of the range in milliseconds before now
+        :returns: tuple with first element True if the replay started
+        """
+        try:
+            args = GLib.Variant('(iii)', (port, start, end,))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'replay_play',
+                args,
+                GLib.VariantType.new("(b)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "replay_play")
+            raise ConnectionError(new_message)
+
+    def get_worker_timings(self):
+        """get_worker_timings(out a(ssuuuuuau) timings);
+        Calls get_worker_timings remotely
+
+        :returns: tuple with first element being the list of timings
+        """
+        try:
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_worker_timings',
+                None,
+                GLib.VariantType.new("(a(ssuuuuuau))"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_worker_timings")
+            raise ConnectionError(new_message)
+
+    def get_bus_stats(self):
+        """get_bus_stats(out a(siuuuuu) stats);
+        Calls get_bus_stats remotely
+
+        :returns: tuple with first element being the list of stats
+        """
+        try:
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_bus_stats',
+                None,
+                GLib.VariantType.new("(a(siuuuuu))"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_bus_stats")
+            raise ConnectionError(new_message)
+
+    def get_queue_levels(self):
+        """get_queue_levels(out a(sttu) levels);
+        Calls get_queue_levels remotely
+
+        :returns: tuple with first element being the list of levels
+        """
+        try:
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_queue_levels',
+                None,
+                GLib.VariantType.new("(a(sttu))"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_queue_levels")
+            raise ConnectionError(new_message)
+
+    def get_method_stats(self):
+        """get_method_stats(out a(suuuau) stats);
+        Calls get_method_stats remotely
+
+        :returns: tuple with first element being the list of stats
+        """
+        try:
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'get_method_stats',
+                None,
+                GLib.VariantType.new("(a(suuuau))"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "get_method_stats")
+            raise ConnectionError(new_message)
+
+    def execute_batch(self, ops):
+        """execute_batch(in  a(sv) ops,
+                         out a(bv) results);
+        Calls execute_batch remotely
+
+        :param ops: list of (method, args) tuples, the methods being keys
+            of BATCH_SIGNATURES
+        :returns: tuple with first element being the list of results
+        """
+        try:
+            args = GLib.Variant('(a(sv))', ([
+                (name, GLib.Variant(self.BATCH_SIGNATURES[name], tuple(arg)))
+                for name, arg in ops],))
+        except KeyError as error:
+            raise ValueError("{0} cannot be batched".format(error))
+        try:
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'execute_batch',
+                args,
+                GLib.VariantType.new("(a(bv))"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "execute_batch")
+            raise ConnectionError(new_message)
+
     def adjust_pip(self, xpos, ypos, width, height):
         """adjust_pip(in i dx,
                            in  i dy,
@@ -416,6 +695,39 @@ class Connection(object):
             new_message = "{0}: {1}".format(message, "adjust_pip")
             raise ConnectionError(new_message)
 
+    def queue_adjust_pip(self, xpos, ypos, width, height):
+        """queue_adjust_pip(in  i dx,
+                            in  i dy,
+                            in  i dw,
+                            in  i dh,
+                            out u ticket);
+        Calls queue_adjust_pip remotely
+
+        :param xpos: the X position of the PIP
+        :param ypos: the Y position of the PIP
+        :param width: the width of the PIP
+        :param height: the height of the PIP
+        :returns: tuple with first element as the ticket of the adjustment
+        """
+        try:
+            args = GLib.Variant('(iiii)', (xpos, ypos, width, height,))
+            connection = self.connection
+            result = connection.call_sync(
+                self.bus_name,
+                self.object_path,
+                self.default_interface,
+                'queue_adjust_pip',
+                args,
+                GLib.VariantType.new("(u)"),
+                Gio.DBusCallFlags.NONE,
+                -1,
+                None)
+            return result
+        except GLib.GError as error:
+            message = error.message
+            new_message = "{0}: {1}".format(message, "queue_adjust_pip")
+            raise ConnectionError(new_message)
+
     def switch(self, channel, port):
         """switch(in  i channel,
                        in  i port,
@@ -8,7 +8,7 @@ from __future__ import absolute_import, print_function, unicode_literals
 
 import ast
 from .connection import Connection
-from .exception import ConnectionReturnError
+from .exception import ConnectionError, ConnectionReturnError
 
 __all__ = ["Controller", ]
 
@@ -53,9 +53,11 @@ class Controller(object):
         self.callbacks_preview_port_added = []
         self.callbacks_preview_port_removed = []
         self.callbacks_new_mode_online = []
+        self.callbacks_previews_degraded = []
         self.callbacks_show_face_marker = []
         self.callbacks_show_track_marker = []
         self.callbacks_select_face = []
+        self.callbacks_pip_adjusted = []
 
     @property
     def address(self):
@@ -238,11 +240,20 @@ class Controller(object):
         :param: None
         :returns: list of all preview ports
         """
-        conn = self.connection.get_preview_ports()
+        try:
+            conn = self.connection.get_previews()
+        except ConnectionError:
+            # Older servers only print the previews in get_preview_ports
+            conn = self.connection.get_preview_ports()
+            try:
+                return self.parse_preview_ports(conn.unpack()[0])
+            except AttributeError:
+                raise ConnectionReturnError('Connection returned invalid '
+                                            'values. Should return a '
+                                            'GVariant tuple')
         try:
             res = conn.unpack()[0]
-            preview_ports = self.parse_preview_ports(res)
-            return preview_ports
+            return [port for port, _, _ in res]
         except AttributeError:
             raise ConnectionReturnError('Connection returned invalid values. '
                                         'Should return a GVariant tuple')
@@ -334,6 +345,158 @@ class Controller(object):
                                         'Should return a GVariant tuple')
         return res
 
+    def get_sink_stats(self):
+        """Get how the clients of the output ports of the server fared
+
+        :returns: list of (worker, clients, first frames, last, max and
+            mean time to first frame, dropped buffers, slow clients)
+            tuples, the times in microseconds
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.get_sink_stats()
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
+    def set_record_encoder(self, encoder):
+        """Select the video encoder used from the next recording on
+
+        :param encoder: encoder spec, one of mjpeg:quality=N, ffv1 or
+            h264:crf=N,preset=NAME,threads=N
+        :returns: True when the encoder spec was accepted
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.set_record_encoder(encoder)
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
+    def replay_save(self, port, start, end, filename):
+        """Save a range of the instant replay ring into a file
+
+        :param port: the video input port, 0 for the output
+        :param start: start of the range in milliseconds before now
+        :param end: end of the range in milliseconds before now
+        :param filename: the file to save to
+        :returns: True when saving started
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.replay_save(port, start, end, filename)
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
+    def replay_play(self, port, start, end):
+        """Play a range of the instant replay ring back as a new input
+
+        :param port: the video input port, 0 for the output
+        :param start: start of the range in milliseconds before now
+        :param end: end of the range in milliseconds before now
+        :returns: True when the replay started
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.replay_play(port, start, end)
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
+    def get_worker_timings(self):
+        """Get how long each phase of starting the server pipelines took
+
+        :returns: list of (worker, phase, count, min, median, p95, max,
+            histogram) tuples, the times in microseconds over the last 64
+            times, the histogram counts up to 1, 2, 5, 10, 20, 50, 100,
+            200, 500, 1000, 2000 ms and beyond
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.get_worker_timings()
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
+    def get_bus_stats(self):
+        """Get how the pipeline messages of the server are dispatched
+
+        :returns: list of (worker, thread, depth, max depth, dispatched,
+            mean latency, max latency) tuples, the thread -1 for the main
+            loop, the latencies in microseconds
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.get_bus_stats()
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
+    def get_queue_levels(self):
+        """Get how much media the queues of the server pipelines hold
+
+        :returns: list of (worker, bytes, time, buffers) tuples, the time
+            of the fullest queue in microseconds
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.get_queue_levels()
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
+    def get_method_stats(self):
+        """Get how many calls of each D-Bus method the server handled
+
+        :returns: list of (method, calls, mean latency, max latency,
+            histogram) tuples, the latencies in microseconds, the histogram
+            counting calls under 10, 20, 50 ... 20000 us and above
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.get_method_stats()
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
+    def execute_batch(self, ops):
+        """Call several methods in one round trip. The composite mode
+        changes and PIP adjustments among them reconfigure the composite
+        only once.
+
+        :param ops: list of (method, args) tuples in the order to call them,
+            e.g. [('set_composite_mode', (Controller.COMPOSITE_PIP,)),
+            ('switch', (Controller.VIDEO_CHANNEL_A, 3004))]
+        :returns: list of (called, result) tuples, the result being what
+            the method returns or why it was not called. None is called
+            if any operation is invalid.
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.execute_batch(ops)
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
     def adjust_pip(self, xpos, ypos, width, height):
         """Change the PIP position and size
 
@@ -353,6 +516,26 @@ class Controller(object):
         # to-do - parse
         return res
 
+    def queue_adjust_pip(self, xpos, ypos, width, height):
+        """Queue a change of the PIP position and size and return at once.
+        The server sums the changes queued and applies them at most once
+        per frame, then fires the pip_adjusted Signal.
+
+        :param xpos: the x position of the PIP
+        :param ypos: the y position of the PIP
+        :param width: the width of the PIP
+        :param height: the height of the PIP
+        :returns: ticket - the number of the change
+        """
+        self.establish_connection()
+        try:
+            conn = self.connection.queue_adjust_pip(xpos, ypos, width, height)
+            res = conn.unpack()[0]
+        except AttributeError:
+            raise ConnectionReturnError('Connection returned invalid values. '
+                                        'Should return a GVariant tuple')
+        return res
+
     def switch(self, channel, port):
         """Switch the channel to the target port
 
@@ -417,7 +600,8 @@ class Controller(object):
 
     @classmethod
     def parse_preview_ports(cls, res):
-        """Parses the preview_ports string"""
+        """Parses the string of the get_preview_ports method, which older
+        servers return instead of get_previews"""
         # res = '[(a, b, c), (a, b, c)*]'
         try:
             liststr = ast.literal_eval(res)
@@ -489,6 +673,23 @@ class Controller(object):
 
         self.callbacks_new_mode_online.append(callback)
 
+    def on_previews_degraded(self, callback):
+        """Register a Callback for the previews_degraded Signal
+        which is fired, when the Server degrades or restores the Previews
+        by a Step because the Output is late or has recovered.
+
+        The Callback takes the following Arguments:
+            int level - The new Level, 0 when the Previews are restored
+            str step  - The Name of the Step, one of none, half-rate,
+                        half-size, quarter-rate, quarter-size and
+                        idle-paused
+        """
+
+        if not callable(callback):
+            raise ValueError('Provided argument callback is not callable')
+
+        self.callbacks_previews_degraded.append(callback)
+
     def on_show_face_marker(self, callback):
         """Register a Callback for the show_face_marker Signal
         which is fired, when a Client has successfully set a face-marker
@@ -519,6 +720,24 @@ class Controller(object):
 
         self.callbacks_show_track_marker.append(callback)
 
+    def on_pip_adjusted(self, callback):
+        """Register a Callback for the pip_adjusted Signal
+        which is fired, when the Server has applied the PIP changes
+        queued by calling queue_adjust_pip.
+
+        The Callback takes the following Arguments:
+            int ticket - The Ticket of the last Change applied
+            int x      - The x Position of the PIP
+            int y      - The y Position of the PIP
+            int w      - The Width of the PIP
+            int h      - The Height of the PIP
+        """
+
+        if not callable(callback):
+            raise ValueError('Provided argument callback is not callable')
+
+        self.callbacks_pip_adjusted.append(callback)
+
     def on_select_face(self, callback):
         """Register a Callback for the select_face Signal
         which is fired, when a Client has successfully selected a face
@@ -378,3 +378,51 @@ class TestAdjustPip(object):
         delay = 0.2
         num = 20
         permutate_adjust_pip(num, delay)
+
+
+def call_rate(num):
+    """Call cheap methods num times each as fast as possible
+    :returns: the calls per second and the server's method stats
+    """
+    video_port = 8000
+    serv = Server(path=PATH, video_port=video_port)
+    try:
+        serv.run()
+        controller = Controller()
+        controller.establish_connection()
+        calls = [controller.get_compose_port, controller.get_encode_port,
+                 controller.get_audio_port]
+
+        start = time.time()
+        for _ in range(num):
+            for call in calls:
+                call()
+        rate = num * len(calls) / (time.time() - start)
+
+        stats = controller.get_method_stats()
+        return rate, [stat for stat in stats if stat[1] > 0]
+    finally:
+        if serv.proc:
+                poll = serv.proc.poll()
+                if poll == -11:
+                    print("SEGMENTATION FAULT OCCURRED")
+                print("ERROR CODE - {0}".format(poll))
+                serv.terminate(1)
+
+
+class TestCallRate(object):
+    """Dispatch latency of the server at high call rates"""
+
+    def test_10000(self):
+        """Call 3 methods 10000 times each and print the figures"""
+        number_test_runs = 10000
+        rate, stats = call_rate(number_test_runs)
+
+        print("\n{0:.0f} calls/s".format(rate))
+        print("{0:<20} {1:>8} {2:>8} {3:>8}".format(
+            'method', 'calls', 'mean us', 'max us'))
+        for name, calls, mean, worst, _ in stats:
+            print("{0:<20} {1:>8} {2:>8} {3:>8}".format(
+                name, calls, mean, worst))
+            assert mean <= worst
+        assert sum(stat[1] for stat in stats) >= 3 * number_test_runs
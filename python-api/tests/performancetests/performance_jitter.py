@@ -0,0 +1,129 @@
+"""
+Performance test for the program output under CPU pressure
+
+Keeps every processor busy, reads the composite output port and prints the
+jitter of the frame intervals with and without streaming thread priorities.
+"""
+
+from __future__ import absolute_import, print_function, unicode_literals
+
+import sys
+import os
+sys.path.insert(0, os.path.abspath(os.path.join(__file__, "../../../")))
+
+from gstswitch.server import Server
+from gstswitch.helpers import TestSources
+import multiprocessing
+import socket
+import struct
+import time
+
+PATH = '../tools/'
+
+MEASURE_SECONDS = 30
+
+FRAME_INTERVAL = 1.0 / 60
+
+CONFIGS = [
+    ('default', ''),
+    ('preview-nice', '--priority=preview:19'),
+    ('program-rt', '--priority=program:rt10,preview:19'),
+]
+
+GDP_HEADER_SIZE = 62
+GDP_TYPE_BUFFER = 1
+
+
+def burn(stop):
+    """Keep a processor busy until stop is set"""
+    while not stop.is_set():
+        pass
+
+
+def read_exactly(sock, size):
+    """Read size bytes from a socket"""
+    data = b''
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise IOError('output port closed')
+        data += chunk
+    return data
+
+
+def frame_times(port, seconds):
+    """Read the gdp stream of the output port
+    :returns: the arrival times of the buffers
+    """
+    times = []
+    sock = socket.create_connection(('localhost', port))
+    try:
+        end = time.time() + seconds
+        while time.time() < end:
+            header = read_exactly(sock, GDP_HEADER_SIZE)
+            kind, length = struct.unpack('>HI', header[4:10])
+            read_exactly(sock, length)
+            if kind == GDP_TYPE_BUFFER:
+                times.append(time.time())
+    finally:
+        sock.close()
+    return times
+
+
+def jitter(times):
+    """Deviation of the frame intervals from the nominal interval
+    :returns: (median, 99th percentile, max) in milliseconds
+    """
+    deviations = sorted(abs(later - earlier - FRAME_INTERVAL) * 1000.0
+                        for earlier, later in zip(times, times[1:]))
+    count = len(deviations)
+    return (deviations[count // 2], deviations[count * 99 // 100],
+            deviations[-1])
+
+
+def measure(option, seconds=MEASURE_SECONDS):
+    """Measure the output jitter of one server configuration
+    :returns: (median, p99, max) jitter in milliseconds
+    """
+    video_port = 8000
+    serv = Server(path=PATH, video_port=video_port)
+    stop = multiprocessing.Event()
+    burners = [multiprocessing.Process(target=burn, args=(stop,))
+               for _ in range(multiprocessing.cpu_count())]
+    try:
+        serv.run(option)
+        sources = TestSources(video_port=video_port)
+        sources.new_test_video(pattern=4)
+        sources.new_test_video(pattern=18)
+        time.sleep(5)
+
+        for burner in burners:
+            burner.start()
+        times = frame_times(video_port + 1, seconds)
+
+        sources.terminate_video()
+        return jitter(times)
+    finally:
+        stop.set()
+        for burner in burners:
+            if burner.is_alive():
+                burner.join()
+        if serv.proc:
+            serv.terminate(1)
+
+
+class TestOutputJitter(object):
+    """Output jitter of each priority configuration"""
+
+    def test_jitter(self):
+        """Measure each configuration and print the figures"""
+        results = []
+        for name, option in CONFIGS:
+            results.append((name,) + measure(option))
+
+        print("\n{0:<16} {1:>10} {2:>10} {3:>10}".format(
+            'config', 'p50 ms', 'p99 ms', 'max ms'))
+        for name, median, p99, worst in results:
+            print("{0:<16} {1:>10.2f} {2:>10.2f} {3:>10.2f}".format(
+                name, median, p99, worst))
+            assert median >= 0
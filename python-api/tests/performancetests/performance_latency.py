@@ -0,0 +1,123 @@
+"""
+Performance test for the glass-to-glass latency of each latency profile
+
+Switches the picture of a video input between black and white and times
+how long it takes for the change to reach the composite output port.
+"""
+
+from __future__ import absolute_import, print_function, unicode_literals
+
+import sys
+import os
+sys.path.insert(0, os.path.abspath(os.path.join(__file__, "../../../")))
+
+from gstswitch.server import Server
+from gstswitch.helpers import TestSources
+from gstswitch.testsource import VideoSrc
+import socket
+import struct
+import time
+
+PATH = '../tools/'
+
+SWITCHES = 20
+
+TIMEOUT = 10
+
+PROFILES = ['ultra-low', 'balanced', 'safe']
+
+GDP_HEADER_SIZE = 62
+GDP_TYPE_BUFFER = 1
+
+# Bytes of a frame averaged, every SAMPLE_STEP-th one
+SAMPLE_STEP = 4099
+
+# Mean of the samples of raw I420 halfway between black and white
+THRESHOLD = 128
+
+
+def read_exactly(sock, size):
+    """Read size bytes from a socket"""
+    data = b''
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise IOError('output port closed')
+        data += chunk
+    return data
+
+
+def next_frame(sock):
+    """Read the gdp stream of the output port up to the next buffer
+    :returns: True if the frame is bright
+    """
+    while True:
+        header = read_exactly(sock, GDP_HEADER_SIZE)
+        kind, length = struct.unpack('>HI', header[4:10])
+        payload = read_exactly(sock, length)
+        if kind == GDP_TYPE_BUFFER:
+            samples = bytearray(payload[::SAMPLE_STEP])
+            return sum(samples) > THRESHOLD * len(samples)
+
+
+def wait_for(sock, bright):
+    """Read frames until one is as bright as asked
+    :returns: the arrival time of the frame
+    """
+    end = time.time() + TIMEOUT
+    while time.time() < end:
+        if next_frame(sock) == bright:
+            return time.time()
+    raise IOError('the output did not change')
+
+
+def measure(profile, switches=SWITCHES):
+    """Measure the glass-to-glass latency of one latency profile
+    :returns: (median, max) latency in milliseconds
+    """
+    video_port = 8000
+    serv = Server(path=PATH, video_port=video_port)
+    latencies = []
+    try:
+        serv.run('--latency-profile={0}'.format(profile))
+        sources = TestSources(video_port=video_port)
+        sources.new_test_video(pattern=VideoSrc.PATTERN_BLACK)
+        source = sources.running_tests_video[0].pipeline.get_by_name('src')
+        time.sleep(5)
+
+        sock = socket.create_connection(('localhost', video_port + 1))
+        try:
+            wait_for(sock, False)
+            for switch in range(switches):
+                bright = switch % 2 == 0
+                source.set_property('pattern', VideoSrc.PATTERN_WHITE
+                                    if bright else VideoSrc.PATTERN_BLACK)
+                start = time.time()
+                latencies.append((wait_for(sock, bright) - start) * 1000.0)
+        finally:
+            sock.close()
+
+        sources.terminate_video()
+    finally:
+        if serv.proc:
+            serv.terminate(1)
+
+    latencies.sort()
+    return latencies[len(latencies) // 2], latencies[-1]
+
+
+class TestGlassToGlass(object):
+    """Glass-to-glass latency of each latency profile"""
+
+    def test_latency(self):
+        """Measure each profile and print the figures"""
+        results = []
+        for profile in PROFILES:
+            results.append((profile,) + measure(profile))
+
+        print("\n{0:<16} {1:>10} {2:>10}".format(
+            'profile', 'p50 ms', 'max ms'))
+        for profile, median, worst in results:
+            print("{0:<16} {1:>10.2f} {2:>10.2f}".format(
+                profile, median, worst))
+            assert median >= 0
@@ -0,0 +1,85 @@
+"""
+Performance test for the recording encoder profiles
+
+Records the same test sources with each profile and prints the server CPU
+usage and the bytes written per minute of recording.
+"""
+
+from __future__ import absolute_import, print_function, unicode_literals
+
+import sys
+import os
+sys.path.insert(0, os.path.abspath(os.path.join(__file__, "../../../")))
+
+from gstswitch.server import Server
+from gstswitch.helpers import TestSources
+import time
+
+PATH = '../tools/'
+
+RECORD_SECONDS = 30
+
+PROFILES = [
+    ('mjpeg-q100', 'mjpeg:quality=100'),
+    ('mjpeg-q85', 'mjpeg:quality=85'),
+    ('ffv1', 'ffv1'),
+    ('x264-crf20-veryfast', 'h264:crf=20,preset=veryfast,threads=4'),
+    ('x264-crf23-ultrafast', 'h264:crf=23,preset=ultrafast,threads=2'),
+]
+
+
+def cpu_seconds(pid):
+    """Return the user+system CPU time used by a process"""
+    with open('/proc/{0}/stat'.format(pid)) as stat:
+        fields = stat.read().rsplit(')', 1)[1].split()
+    return (int(fields[11]) + int(fields[12])) / \
+        float(os.sysconf(os.sysconf_names['SC_CLK_TCK']))
+
+
+def record_profile(name, encoder, seconds=RECORD_SECONDS):
+    """Record the test sources with one encoder profile
+    :returns: (cpu percent, bytes per minute)
+    """
+    video_port = 8000
+    filename = 'bench-{0}.mkv'.format(name)
+    if os.path.exists(filename):
+        os.remove(filename)
+    serv = Server(path=PATH, video_port=video_port, record_file=filename)
+    try:
+        serv.run('--record-encoder={0}'.format(encoder))
+        sources = TestSources(video_port=video_port)
+        sources.new_test_video(pattern=4)
+        sources.new_test_video(pattern=18)
+        time.sleep(5)
+
+        cpu_start = cpu_seconds(serv.pid)
+        size_start = os.path.getsize(filename)
+        time.sleep(seconds)
+        cpu = cpu_seconds(serv.pid) - cpu_start
+        size = os.path.getsize(filename) - size_start
+
+        sources.terminate_video()
+        return (100.0 * cpu / seconds, size * 60.0 / seconds)
+    finally:
+        if serv.proc:
+            serv.terminate(1)
+        if os.path.exists(filename):
+            os.remove(filename)
+
+
+class TestRecordProfiles(object):
+    """CPU and disk usage of each recording profile"""
+
+    def test_profiles(self):
+        """Record with each profile and print the figures"""
+        results = []
+        for name, encoder in PROFILES:
+            cpu, bytes_per_minute = record_profile(name, encoder)
+            results.append((name, cpu, bytes_per_minute))
+
+        print("\n{0:<24} {1:>8} {2:>14}".format('profile', 'cpu %',
+                                                'MB/minute'))
+        for name, cpu, bytes_per_minute in results:
+            print("{0:<24} {1:>8.1f} {2:>14.1f}".format(
+                name, cpu, bytes_per_minute / 1e6))
+            assert bytes_per_minute > 0
@@ -218,11 +218,22 @@ class MockConnection(object):
         'get_encode_port': (3002,),
         'get_audio_port': (4000,),
         'get_preview_ports': ('[(3002, 1, 7), (3003, 1, 8)]',),
+        'get_previews': ([(3002, 1, 7), (3003, 1, 8)],),
         'set_composite_mode': (False,),
         'get_composite_mode': (0,),
         'set_encode_mode': (False,),
         'new_record': (False,),
+        'get_sink_stats': ([],),
+        'set_record_encoder': (True,),
+        'replay_save': (True,),
+        'replay_play': (True,),
+        'get_worker_timings': ([],),
+        'get_bus_stats': ([],),
+        'get_queue_levels': ([],),
+        'get_method_stats': ([],),
+        'execute_batch': ([],),
         'adjust_pip': (1,),
+        'queue_adjust_pip': (7,),
         'switch': (True,),
         'click_video': (True,),
         'mark_face': None,
@@ -308,6 +319,20 @@ def test_get_preview_ports():
     assert conn.get_preview_ports() == ('[(3002, 1, 7), (3003, 1, 8)]',)
 
 
+def test_get_previews():
+    """Test the get_previews method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_previews')
+    with pytest.raises(ConnectionError):
+        conn.get_previews()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_previews')
+    assert conn.get_previews() == ([(3002, 1, 7), (3003, 1, 8)],)
+
+
 def test_set_composite_mode():
     """Test the set_composite_mode method"""
     default_interface = "us.timvideos.gstswitch"
@@ -364,6 +389,135 @@ def test_new_record():
     assert conn.new_record() == (False,)
 
 
+def test_get_sink_stats():
+    """Test the get_sink_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_sink_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_sink_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_sink_stats')
+    assert conn.get_sink_stats() == ([],)
+
+
+def test_set_record_encoder():
+    """Test the set_record_encoder method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('set_record_encoder')
+    with pytest.raises(ConnectionError):
+        conn.set_record_encoder('ffv1')
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('set_record_encoder')
+    assert conn.set_record_encoder('ffv1') == (True,)
+
+
+def test_replay_save():
+    """Test the replay_save method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_save')
+    with pytest.raises(ConnectionError):
+        conn.replay_save(0, 10000, 0, 'replay.mkv')
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_save')
+    assert conn.replay_save(0, 10000, 0, 'replay.mkv') == (True,)
+
+
+def test_replay_play():
+    """Test the replay_play method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_play')
+    with pytest.raises(ConnectionError):
+        conn.replay_play(0, 5000, 0)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('replay_play')
+    assert conn.replay_play(0, 5000, 0) == (True,)
+
+
+def test_get_worker_timings():
+    """Test the get_worker_timings method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_worker_timings')
+    with pytest.raises(ConnectionError):
+        conn.get_worker_timings()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_worker_timings')
+    assert conn.get_worker_timings() == ([],)
+
+
+def test_get_bus_stats():
+    """Test the get_bus_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_bus_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_bus_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_bus_stats')
+    assert conn.get_bus_stats() == ([],)
+
+
+def test_get_queue_levels():
+    """Test the get_queue_levels method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_queue_levels')
+    with pytest.raises(ConnectionError):
+        conn.get_queue_levels()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_queue_levels')
+    assert conn.get_queue_levels() == ([],)
+
+
+def test_get_method_stats():
+    """Test the get_method_stats method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_method_stats')
+    with pytest.raises(ConnectionError):
+        conn.get_method_stats()
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('get_method_stats')
+    assert conn.get_method_stats() == ([],)
+
+
+def test_execute_batch():
+    """Test the execute_batch method"""
+    ops = [('set_composite_mode', (1,)), ('switch', (65, 3004))]
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('execute_batch')
+    with pytest.raises(ConnectionError):
+        conn.execute_batch(ops)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('execute_batch')
+    assert conn.execute_batch(ops) == ([],)
+    with pytest.raises(ValueError):
+        conn.execute_batch([('get_compose_port', ())])
+
+
 def test_adjust_pip():
     """Test the adjust_pip method"""
     default_interface = "us.timvideos.gstswitch"
@@ -378,6 +532,20 @@ def test_adjust_pip():
     assert conn.adjust_pip(1, 2, 3, 4) == (1,)
 
 
+def test_queue_adjust_pip():
+    """Test the queue_adjust_pip method"""
+    default_interface = "us.timvideos.gstswitch"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('queue_adjust_pip')
+    with pytest.raises(ConnectionError):
+        conn.queue_adjust_pip(1, 2, 3, 4)
+
+    default_interface = "us.timvideos.gstswitch.SwitchControllerInterface"
+    conn = Connection(default_interface=default_interface)
+    conn.connection = MockConnection('queue_adjust_pip')
+    assert conn.queue_adjust_pip(1, 2, 3, 4) == (7,)
+
+
 def test_switch():
     """Test the switch method"""
     default_interface = "us.timvideos.gstswitch"
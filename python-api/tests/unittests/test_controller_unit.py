@@ -4,7 +4,7 @@ import os
 sys.path.insert(0, os.path.abspath(os.path.join(__file__, "../../../")))
 
 from gstswitch.controller import Controller
-from gstswitch.exception import ConnectionReturnError
+from gstswitch.exception import ConnectionError, ConnectionReturnError
 import pytest
 from mock import Mock
 from gstswitch.connection import Connection
@@ -145,7 +145,8 @@ class TestSignalHandler(object):
 
         for signal in ('preview_port_added', 'preview_port_removed',
                        'new_mode_online', 'show_face_marker',
-                       'show_track_marker', 'select_face'):
+                       'show_track_marker', 'select_face',
+                       'previews_degraded', 'pip_adjusted'):
             test_cb = 123
             controller = Controller(address='unix:abstract=abcd')
             with pytest.raises(ValueError):
@@ -157,7 +158,8 @@ class TestSignalHandler(object):
 
         for signal in ('preview_port_added', 'preview_port_removed',
                        'new_mode_online', 'show_face_marker',
-                       'show_track_marker', 'select_face'):
+                       'show_track_marker', 'select_face',
+                       'previews_degraded', 'pip_adjusted'):
             test_cb = Mock()
             controller = Controller(address='unix:abstract=abcd')
             getattr(controller, 'on_' + signal)(test_cb)
@@ -179,7 +181,8 @@ class TestSignalHandler(object):
 
         signals = ('preview_port_added', 'preview_port_removed',
                    'new_mode_online', 'show_face_marker',
-                   'show_track_marker', 'select_face')
+                   'show_track_marker', 'select_face',
+                   'previews_degraded', 'pip_adjusted')
         test_cbs = {}
         for signal in signals:
             test_cbs[signal] = Mock()
@@ -249,6 +252,13 @@ class MockConnection(object):
         else:
             return (0,)
 
+    def get_previews(self):
+        """mock of get_previews"""
+        if self.return_variant:
+            return GLib.Variant('(a(iii))', ([(3002, 1, 7), (3003, 1, 8)],))
+        else:
+            return (0,)
+
     def set_composite_mode(self, mode):
         """mock of set_composite_mode"""
         if self.return_variant:
@@ -277,6 +287,76 @@ class MockConnection(object):
         else:
             return (not self.should_fail,)
 
+    def get_sink_stats(self):
+        """mock of get_sink_stats"""
+        stats = [('output', 2, 2, 4000, 9000, 6500, 12, 1)]
+        if self.return_variant:
+            return GLib.Variant('(a(suuxxxtu))', (stats,))
+        else:
+            return (stats,)
+
+    def set_record_encoder(self, encoder):
+        """mock of set_record_encoder"""
+        if self.return_variant:
+            return GLib.Variant('(b)', (not self.should_fail,))
+        else:
+            return (not self.should_fail,)
+
+    def replay_save(self, port, start, end, filename):
+        """mock of replay_save"""
+        if self.return_variant:
+            return GLib.Variant('(b)', (not self.should_fail,))
+        else:
+            return (not self.should_fail,)
+
+    def replay_play(self, port, start, end):
+        """mock of replay_play"""
+        if self.return_variant:
+            return GLib.Variant('(b)', (not self.should_fail,))
+        else:
+            return (not self.should_fail,)
+
+    def get_worker_timings(self):
+        """mock of get_worker_timings"""
+        timings = [('output', 'build', 1, 900, 900, 900, 900,
+                    [1] + [0] * 11)]
+        if self.return_variant:
+            return GLib.Variant('(a(ssuuuuuau))', (timings,))
+        else:
+            return (timings,)
+
+    def get_bus_stats(self):
+        """mock of get_bus_stats"""
+        stats = [('composite', 0, 0, 3, 120, 80, 900)]
+        if self.return_variant:
+            return GLib.Variant('(a(siuuuuu))', (stats,))
+        else:
+            return (stats,)
+
+    def get_queue_levels(self):
+        """mock of get_queue_levels"""
+        levels = [('composite', 6220800, 33000, 2)]
+        if self.return_variant:
+            return GLib.Variant('(a(sttu))', (levels,))
+        else:
+            return (levels,)
+
+    def get_method_stats(self):
+        """mock of get_method_stats"""
+        stats = [('get_compose_port', 3, 40, 90, [0, 0, 2, 1] + [0] * 8)]
+        if self.return_variant:
+            return GLib.Variant('(a(suuuau))', (stats,))
+        else:
+            return (stats,)
+
+    def execute_batch(self, ops):
+        """mock of execute_batch"""
+        results = [(True, GLib.Variant('(b)', (True,))) for _ in ops]
+        if self.return_variant:
+            return GLib.Variant('(a(bv))', (results,))
+        else:
+            return (results,)
+
     def adjust_pip(self, xpos, ypos, width, height):
         """mock of adjust_pip"""
         if self.return_variant:
@@ -284,6 +364,13 @@ class MockConnection(object):
         else:
             return (1,)
 
+    def queue_adjust_pip(self, xpos, ypos, width, height):
+        """mock of queue_adjust_pip"""
+        if self.return_variant:
+            return GLib.Variant('(u)', (7,))
+        else:
+            return (7,)
+
     def switch(self, channel, port):
         """mock of switch"""
         if self.return_variant:
@@ -376,8 +463,14 @@ class TestGetPreviewPorts(object):
         """Test if valid"""
         controller = Controller(address='unix:abstract=abcdef')
         controller.connection = MockConnection(return_variant=True)
-        controller.parse_preview_ports = Mock(return_value=[3001, 3002])
-        assert controller.get_preview_ports() == [3001, 3002]
+        assert controller.get_preview_ports() == [3002, 3003]
+
+    def test_older_server(self):
+        """Test if the printed ports are parsed without get_previews"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.connection = MockConnection(return_variant=True)
+        controller.connection.get_previews = Mock(side_effect=ConnectionError)
+        assert controller.get_preview_ports() == [3002, 3003]
 
 
 class TestSetCompositeMode(object):
@@ -476,6 +569,196 @@ class TestNewRecord(object):
         assert controller.new_record() is True
 
 
+class TestGetSinkStats(object):
+
+    """Test the get_sink_stats method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.get_sink_stats()
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        stats = controller.get_sink_stats()
+        assert stats[0] == ('output', 2, 2, 4000, 9000, 6500, 12, 1)
+
+
+class TestSetRecordEncoder(object):
+
+    """Test the set_record_encoder method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.set_record_encoder('ffv1')
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        assert controller.set_record_encoder('ffv1') is True
+
+
+class TestReplaySave(object):
+
+    """Test the replay_save method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.replay_save(0, 10000, 0, 'replay.mkv')
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        assert controller.replay_save(0, 10000, 0, 'replay.mkv') is True
+
+
+class TestReplayPlay(object):
+
+    """Test the replay_play method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.replay_play(0, 5000, 0)
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        assert controller.replay_play(0, 5000, 0) is True
+
+
+class TestGetWorkerTimings(object):
+
+    """Test the get_worker_timings method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.get_worker_timings()
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        timings = controller.get_worker_timings()
+        assert timings[0][:2] == ('output', 'build')
+        assert len(timings[0][7]) == 12
+
+
+class TestGetBusStats(object):
+
+    """Test the get_bus_stats method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.get_bus_stats()
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        stats = controller.get_bus_stats()
+        assert stats[0][:2] == ('composite', 0)
+
+
+class TestGetQueueLevels(object):
+
+    """Test the get_queue_levels method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.get_queue_levels()
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        levels = controller.get_queue_levels()
+        assert levels[0] == ('composite', 6220800, 33000, 2)
+
+
+class TestGetMethodStats(object):
+
+    """Test the get_method_stats method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.get_method_stats()
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        stats = controller.get_method_stats()
+        assert stats[0][:2] == ('get_compose_port', 3)
+
+
+class TestExecuteBatch(object):
+
+    """Test the execute_batch method"""
+
+    ops = [('set_composite_mode', (Controller.COMPOSITE_PIP,)),
+           ('switch', (Controller.VIDEO_CHANNEL_A, 3004))]
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.execute_batch(self.ops)
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        results = controller.execute_batch(self.ops)
+        assert results == [(True, (True,)), (True, (True,))]
+
+
 class TestAdjustPIP(object):
 
     """Test the adjust_pip method"""
@@ -496,6 +779,26 @@ class TestAdjustPIP(object):
         assert controller.adjust_pip(1, 2, 3, 4) == 1
 
 
+class TestQueueAdjustPIP(object):
+
+    """Test the queue_adjust_pip method"""
+
+    def test_unpack(self):
+        """Test if unpack fails"""
+        controller = Controller(address='unix:abstract=abcde')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=False)
+        with pytest.raises(ConnectionReturnError):
+            controller.queue_adjust_pip(1, 2, 3, 4)
+
+    def test_normal_unpack(self):
+        """Test if valid"""
+        controller = Controller(address='unix:abstract=abcdef')
+        controller.establish_connection = Mock(return_value=None)
+        controller.connection = MockConnection(return_variant=True)
+        assert controller.queue_adjust_pip(1, 2, 3, 4) == 7
+
+
 class TestSwitch(object):
 
     """Test the switch method"""
@@ -0,0 +1,178 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Time-to-PLAYING of a pipeline shaped like a composite case, created
+ * with gst_parse_launch() as the workers used to, with the builder, and
+ * reused by updating it in place as a reset worker does.
+ *
+ *   ./bench-worker-build [ITERATIONS]
+ */
+
+#include <stdlib.h>
+#include "../tools/gstworkerbuilder.h"
+
+#define BENCH_CAPS "video/x-raw,format=I420,width=1280,height=720,framerate=25/1"
+
+typedef struct
+{
+  const gchar *name;
+  gint64 build;
+  gint64 playing;
+  gint64 build_max;
+  gint64 playing_max;
+} BenchResult;
+
+static GstElement *
+bench_parse (void)
+{
+  GError *error = NULL;
+  GstElement *pipeline = gst_parse_launch ("videotestsrc name=source "
+      "is-live=true ! " BENCH_CAPS " ! tee name=s "
+      "s. ! queue ! fakesink name=sink1 sync=false "
+      "s. ! queue ! fakesink name=sink2 sync=false", &error);
+
+  if (error) {
+    g_printerr ("parse error: %s\n", error->message);
+    g_error_free (error);
+  }
+  return pipeline;
+}
+
+static GstElement *bench_pipeline = NULL;
+
+static void
+bench_describe (GstWorkerBuilder * builder)
+{
+  gst_worker_builder_add (builder, "videotestsrc", "source",
+      "is-live", TRUE, NULL);
+  gst_worker_builder_caps (builder, "%s", BENCH_CAPS);
+  gst_worker_builder_add (builder, "tee", "s", NULL);
+  gst_worker_builder_add (builder, "queue", NULL, NULL);
+  gst_worker_builder_add (builder, "fakesink", "sink1", "sync", FALSE, NULL);
+  gst_worker_builder_from (builder, "s");
+  gst_worker_builder_add (builder, "queue", NULL, NULL);
+  gst_worker_builder_add (builder, "fakesink", "sink2", "sync", FALSE, NULL);
+}
+
+static GstElement *
+bench_build (void)
+{
+  GstWorkerBuilder *builder = gst_worker_builder_new ("bench");
+  GstElement *pipeline;
+
+  bench_describe (builder);
+  pipeline = gst_worker_builder_finish (builder);
+  if (pipeline == NULL)
+    g_printerr ("build error: %s\n", builder->desc->str);
+  gst_worker_builder_free (builder);
+  return pipeline;
+}
+
+static GstElement *
+bench_update (void)
+{
+  GstWorkerBuilder *builder;
+  GstElement *pipeline;
+
+  if (bench_pipeline == NULL && (bench_pipeline = bench_build ()) == NULL)
+    return NULL;
+
+  builder = gst_worker_builder_new_update (bench_pipeline);
+  bench_describe (builder);
+  pipeline = gst_worker_builder_finish (builder);
+  if (pipeline == NULL)
+    g_printerr ("update error: %s\n", builder->desc->str);
+  gst_worker_builder_free (builder);
+  return pipeline;
+}
+
+static gboolean
+bench_run (BenchResult * result, GstElement * (*create) (void), gint n)
+{
+  gint i;
+
+  for (i = 0; i < n; ++i) {
+    gint64 start = g_get_monotonic_time ();
+    gint64 built, playing;
+    GstElement *pipeline = create ();
+
+    if (pipeline == NULL)
+      return FALSE;
+    built = g_get_monotonic_time ();
+
+    gst_element_set_state (pipeline, GST_STATE_PLAYING);
+    if (gst_element_get_state (pipeline, NULL, NULL,
+            5 * GST_SECOND) == GST_STATE_CHANGE_FAILURE) {
+      g_printerr ("%s: failed to reach PLAYING\n", result->name);
+      gst_element_set_state (pipeline, GST_STATE_NULL);
+      gst_object_unref (pipeline);
+      return FALSE;
+    }
+    playing = g_get_monotonic_time ();
+
+    gst_element_set_state (pipeline, GST_STATE_NULL);
+    gst_object_unref (pipeline);
+
+    result->build += built - start;
+    result->playing += playing - start;
+    result->build_max = MAX (result->build_max, built - start);
+    result->playing_max = MAX (result->playing_max, playing - start);
+  }
+  return TRUE;
+}
+
+static void
+bench_print (BenchResult * result, gint n)
+{
+  g_print ("%-8s build %6" G_GINT64_FORMAT " us (max %6" G_GINT64_FORMAT
+      ")  to PLAYING %6" G_GINT64_FORMAT " us (max %6" G_GINT64_FORMAT ")\n",
+      result->name, result->build / n, result->build_max,
+      result->playing / n, result->playing_max);
+}
+
+int
+main (int argc, char **argv)
+{
+  BenchResult parse = { "parse", 0, 0, 0, 0 };
+  BenchResult build = { "builder", 0, 0, 0, 0 };
+  BenchResult update = { "update", 0, 0, 0, 0 };
+  gint n = argc > 1 ? atoi (argv[1]) : 200;
+  GstElement *warmup;
+
+  gst_init (&argc, &argv);
+  if (n <= 0)
+    n = 200;
+
+  // Load the plugins once so neither run pays for it
+  warmup = bench_parse ();
+  if (warmup)
+    gst_object_unref (warmup);
+
+  if (!bench_run (&parse, bench_parse, n) ||
+      !bench_run (&build, bench_build, n) ||
+      !bench_run (&update, bench_update, n))
+    return 1;
+
+  g_print ("%d pipelines each\n", n);
+  bench_print (&parse, n);
+  bench_print (&build, n);
+  bench_print (&update, n);
+  return 0;
+}
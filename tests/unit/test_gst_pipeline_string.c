@@ -39,6 +39,12 @@ gst_switch_server_get_video_caps_str (void)
   return caps;
 }
 
+void
+gst_sink_policy_apply (GstElement * sink, const gchar * label,
+    gboolean muxed)
+{
+}
+
 gint
 gst_composite_default_width ()
 {
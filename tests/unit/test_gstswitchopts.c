@@ -51,6 +51,93 @@ test_strings_bad (void)
 //  g_assert_cmpint (parse_format("pal@75", NULL, NULL), ==, -1);
 }
 
+static void
+test_encoder_good (void)
+{
+  GstSwitchEncoder enc;
+
+  g_assert_cmpint (parse_encoder ("raw", &enc, NULL), ==, 0);
+  g_assert_cmpint (enc.type, ==, GST_SWITCH_ENCODER_RAW);
+  g_assert (gst_switch_encoder_is_valid (&enc));
+
+  g_assert_cmpint (parse_encoder ("mjpeg:quality=75", &enc, NULL), ==, 0);
+  g_assert_cmpint (enc.type, ==, GST_SWITCH_ENCODER_MJPEG);
+  g_assert_cmpuint (enc.quality, ==, 75);
+
+  g_assert_cmpint (parse_encoder ("h264:bitrate=2000,threads=2,zerolatency=0",
+          &enc, NULL), ==, 0);
+  g_assert_cmpint (enc.type, ==, GST_SWITCH_ENCODER_H264);
+  g_assert_cmpuint (enc.bitrate, ==, 2000);
+  g_assert_cmpuint (enc.threads, ==, 2);
+  g_assert (!enc.zerolatency);
+  g_assert (gst_switch_encoder_is_valid (&enc));
+
+  enc.crf = 52;
+  g_assert (!gst_switch_encoder_is_valid (&enc));
+  enc.crf = 0;
+  strcpy (enc.preset, "warp");
+  g_assert (!gst_switch_encoder_is_valid (&enc));
+
+  g_assert_cmpint (parse_encoder ("H264", &enc, NULL), ==, 0);
+  g_assert (enc.zerolatency);
+}
+
+static void
+test_encoder_bad (void)
+{
+  g_assert_cmpint (parse_encoder ("", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_encoder ("vp8", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_encoder ("h264:bitrate", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_encoder ("h264:bitrate=fast", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_encoder ("h264:preset=warp", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_encoder ("h264:crf=0", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_encoder ("mjpeg:quality=101", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_encoder ("mjpeg:colour=blue", NULL, NULL), ==, -1);
+}
+
+static void
+test_burst (void)
+{
+  GstSwitchBurst burst;
+
+  g_assert_cmpint (parse_burst ("none", &burst, NULL), ==, 0);
+  g_assert_cmpint (burst.mode, ==, GST_SWITCH_BURST_NONE);
+  g_assert_cmpint (parse_burst ("keyframe", &burst, NULL), ==, 0);
+  g_assert_cmpint (burst.mode, ==, GST_SWITCH_BURST_KEYFRAME);
+  g_assert_cmpint (parse_burst ("frames:5", &burst, NULL), ==, 0);
+  g_assert_cmpint (burst.mode, ==, GST_SWITCH_BURST_FRAMES);
+  g_assert_cmpuint (burst.frames, ==, 5);
+
+  g_assert_cmpint (parse_burst ("frames:", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_burst ("frames:0", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_burst ("everything", NULL, NULL), ==, -1);
+}
+
+static void
+test_client_limit (void)
+{
+  GstSwitchClientLimit limit = { 0 };
+
+  g_assert_cmpint (parse_client_limit ("none", &limit, NULL), ==, 0);
+  g_assert_cmpint (limit.unit, ==, GST_SWITCH_CLIENT_LIMIT_NONE);
+  g_assert_cmpint (parse_client_limit ("buffers:50", &limit, NULL), ==, 0);
+  g_assert_cmpint (limit.unit, ==, GST_SWITCH_CLIENT_LIMIT_BUFFERS);
+  g_assert_cmpuint (limit.soft, ==, 50);
+  g_assert_cmpuint (limit.hard, ==, 100);
+  g_assert_cmpint (parse_client_limit ("time:500:3000", &limit, NULL), ==, 0);
+  g_assert_cmpint (limit.unit, ==, GST_SWITCH_CLIENT_LIMIT_TIME);
+  g_assert_cmpuint (limit.soft, ==, 500);
+  g_assert_cmpuint (limit.hard, ==, 3000);
+  g_assert_cmpint (parse_client_drop ("keyframe", &limit, NULL), ==, 0);
+  g_assert_cmpint (limit.drop, ==, GST_SWITCH_CLIENT_DROP_TO_KEYFRAME);
+
+  g_assert_cmpint (parse_client_limit ("bytes", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_client_limit ("bytes:0", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_client_limit ("time:500:100", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_client_limit ("frames:5", NULL, NULL), ==, -1);
+  g_assert_cmpint (parse_client_drop ("newest", NULL, NULL), ==, -1);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -59,5 +146,9 @@ main (int argc, char *argv[])
   g_test_set_nonfatal_assertions ();
   g_test_add_func ("/gstswitch/options/format/good", test_strings_good);
   g_test_add_func ("/gstswitch/options/format/bad", test_strings_bad);
+  g_test_add_func ("/gstswitch/options/encoder/good", test_encoder_good);
+  g_test_add_func ("/gstswitch/options/encoder/bad", test_encoder_bad);
+  g_test_add_func ("/gstswitch/options/burst", test_burst);
+  g_test_add_func ("/gstswitch/options/client-limit", test_client_limit);
   return g_test_run ();
 }
@@ -61,6 +61,7 @@ gst_audio_visual_init (GstAudioVisual * visual)
 {
   visual->port = 0;
   visual->handle = 0;
+  GST_WORKER (visual)->priority = GST_WORKER_PRIORITY_UI;
   visual->active = FALSE;
   visual->endtime = 0;
 
@@ -218,41 +219,48 @@ gst_audio_visual_missing (GstWorker * worker, gchar ** elements)
 }
 
 /**
- * @brief Getting the pipeline strings invoked by the parent class.
+ * @brief Building the pipeline, invoked by the parent class.
  * @param visual The GstAudioVisual instance.
+ * @param builder The builder.
  * @memberof GstAudioVisual
- * @return a GString instance of the pipeline string, need to free after used
+ * @return TRUE if the pipeline was built
  */
-static GString *
-gst_audio_visual_get_pipeline_string (GstAudioVisual * visual)
+static gboolean
+gst_audio_visual_build_pipeline (GstAudioVisual * visual,
+    GstWorkerBuilder * builder)
 {
-  GString *desc;
-
   INFO ("display audio %d", visual->port);
 
-  desc = g_string_new ("");
-
-  g_string_append_printf (desc, "tcpclientsrc name=source port=%d ",
-      visual->port);
-  g_string_append_printf (desc, "! gdpdepay ! tee name=a\n");
+  gst_worker_builder_add (builder, "tcpclientsrc", "source",
+      "port", (gint) visual->port, NULL);
+  gst_worker_builder_add (builder, "gdpdepay", NULL, NULL);
+  gst_worker_builder_add (builder, "tee", "a", NULL);
 
   if (visual->active) {
-    g_string_append_printf (desc,
-        "a. ! queue ! audioconvert ! level name=level message=true !"
-        " autoaudiosink name=play sync=false\n");
+    gst_worker_builder_add (builder, "queue", NULL, NULL);
+    gst_worker_builder_add (builder, "audioconvert", NULL, NULL);
+    gst_worker_builder_add (builder, "level", "level",
+        "message", TRUE, NULL);
+    gst_worker_builder_add (builder, "autoaudiosink", "play",
+        "sync", FALSE, NULL);
+    gst_worker_builder_from (builder, "a");
   }
 
-  g_string_append_printf (desc, "a. ! queue ! audioconvert ! monoscope ");
+  gst_worker_builder_add (builder, "queue", NULL, NULL);
+  gst_worker_builder_add (builder, "audioconvert", NULL, NULL);
+  gst_worker_builder_add (builder, "monoscope", NULL, NULL);
   if (visual->active) {
-    g_string_append_printf (desc, "! textoverlay text=\"active\" "
-        "font-desc=\"Sans 50\" " "shaded-background=true " "auto-resize=true ");
+    gst_worker_builder_add (builder, "textoverlay", NULL,
+        "text", "active", "font-desc", "Sans 50",
+        "shaded-background", TRUE, "auto-resize", TRUE, NULL);
   }
-  g_string_append_printf (desc, "! videoconvert ");
-  g_string_append_printf (desc, "! xvimagesink name=visual sync=false ");
+  gst_worker_builder_add (builder, "videoconvert", NULL, NULL);
+  gst_worker_builder_add (builder, "xvimagesink", "visual",
+      "sync", FALSE, NULL);
 
-  INFO ("Audio preview: %s", desc->str);
+  INFO ("Audio preview: %s", builder->desc->str);
 
-  return desc;
+  return TRUE;
 }
 
 /**
@@ -412,6 +420,6 @@ gst_audio_visual_class_init (GstAudioVisualClass * klass)
   worker_class->missing = gst_audio_visual_missing;
   worker_class->prepare = (GstWorkerPrepareFunc) gst_audio_visual_prepare;
   worker_class->message = (GstWorkerMessageFunc) gst_audio_visual_message;
-  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
-      gst_audio_visual_get_pipeline_string;
+  worker_class->build_pipeline = (GstWorkerBuildPipelineFunc)
+      gst_audio_visual_build_pipeline;
 }
@@ -27,6 +27,7 @@
 #include <string.h>
 #include "gstswitchserver.h"
 #include "gstcase.h"
+#include "gstsinkpolicy.h"
 
 enum
 {
@@ -56,6 +57,28 @@ extern gboolean verbose;
 #define gst_case_parent_class parent_class
 G_DEFINE_TYPE (GstCase, gst_case, GST_TYPE_WORKER);
 
+/**
+ * @param type The case type.
+ * @return The priority class of the streaming threads of the case.
+ */
+static GstWorkerPriority
+gst_case_priority (GstCaseType type)
+{
+  switch (type) {
+    case GST_CASE_INPUT_AUDIO:
+    case GST_CASE_INPUT_VIDEO:
+      return GST_WORKER_PRIORITY_INGEST;
+    case GST_CASE_PREVIEW:
+    case GST_CASE_BRANCH_PREVIEW:
+      return GST_WORKER_PRIORITY_PREVIEW;
+    case GST_CASE_UNKNOWN:
+      return GST_WORKER_PRIORITY_NONE;
+    default:
+      /* Feeding the composite or the output */
+      return GST_WORKER_PRIORITY_PROGRAM;
+  }
+}
+
 /**
  * @param cas The GstCase instance.
  * @memberof GstCase
@@ -69,6 +92,7 @@ gst_case_init (GstCase * cas)
 {
   cas->type = GST_CASE_UNKNOWN;
   cas->stream = NULL;
+  GST_WORKER (cas)->task_class = "case";
   cas->input = NULL;
   cas->branch = NULL;
   cas->serve_type = GST_SERVE_NOTHING;
@@ -79,6 +103,9 @@ gst_case_init (GstCase * cas)
   cas->a_height = 0;
   cas->b_width = 0;
   cas->b_height = 0;
+  cas->degrade_rate = 1;
+  cas->degrade_scale = 1;
+  cas->degrade_idle = FALSE;
 
   //INFO ("init %p", cas);
 }
@@ -220,6 +247,7 @@ gst_case_set_property (GstCase * cas, guint property_id,
   switch (property_id) {
     case PROP_TYPE:
       cas->type = (GstCaseType) g_value_get_uint (value);
+      GST_WORKER (cas)->priority = gst_case_priority (cas->type);
       break;
     case PROP_SERVE:
       cas->serve_type = (GstSwitchServeStreamType) g_value_get_uint (value);
@@ -275,94 +303,277 @@ gst_case_set_property (GstCase * cas, guint property_id,
   }
 }
 
+/**
+ * @param builder The builder.
+ * @param factory The inter element, e.g. intervideosrc.
+ * @param name The element name.
+ * @param format The channel name format.
+ * @param port The port in the channel name.
+ * @memberof GstCase
+ *
+ * Add an inter element on the channel of a port.
+ */
+static void
+gst_case_add_inter (GstWorkerBuilder * builder, const gchar * factory,
+    const gchar * name, const gchar * format, gint port)
+{
+  gchar *channel = g_strdup_printf (format, port);
+  gst_worker_builder_inter (builder, factory, name, channel);
+  g_free (channel);
+}
+
+/**
+ * @param builder The builder.
+ * @memberof GstCase
+ *
+ * Parse the raw audio stream of the inter elements.
+ */
+static void
+gst_case_add_audioparse (GstWorkerBuilder * builder)
+{
+  if (gst_worker_builder_add (builder, "audioparse", NULL, NULL)) {
+    gst_worker_builder_set_arg (builder, "raw-format", "s16le");
+    gst_worker_builder_set (builder, "rate", (gint) 48000, NULL);
+  }
+}
+
 /**
  * @param cas The GstCase instance.
+ * @param builder The builder.
  * @memberof GstCase
- * @return A GString instance representing the pipeline string.
+ * @return TRUE if the pipeline was built.
  *
- * Retreiving the GstCase pipeline string, it's invoked by GstWorker.
+ * Building the GstCase pipeline, it's invoked by GstWorker.
  */
-static GString *
-gst_case_get_pipeline_string (GstCase * cas)
+static gboolean
+gst_case_build_pipeline (GstCase * cas, GstWorkerBuilder * builder)
 {
   gboolean is_audiostream = cas->serve_type == GST_SERVE_AUDIO_STREAM;
-  GString *desc = g_string_new ("");
+  gboolean audio = cas->type == GST_CASE_INPUT_AUDIO ||
+      cas->type == GST_CASE_COMPOSITE_AUDIO ||
+      cas->type == GST_CASE_BRANCH_AUDIO ||
+      (cas->type == GST_CASE_PREVIEW && is_audiostream);
   const gchar *caps =
       is_audiostream ?
       gst_switch_server_get_audio_caps_str () :
       gst_switch_server_get_video_caps_str ();
+  const gchar *inter_src = audio ? "interaudiosrc" : "intervideosrc";
+  const gchar *inter_sink = audio ? "interaudiosink" : "intervideosink";
 
   switch (cas->type) {
     case GST_CASE_INPUT_AUDIO:
-      g_string_append_printf (desc,
-          "giostreamsrc name=source ! gdpdepay ! %s ! interaudiosink name=sink channel=input_%d",
-          caps, cas->sink_port);
-      break;
-
     case GST_CASE_INPUT_VIDEO:
-      g_string_append_printf (desc,
-          "giostreamsrc name=source ! gdpdepay ! %s ! intervideosink name=sink channel=input_%d",
-          caps, cas->sink_port);
+      gst_worker_builder_add (builder, "giostreamsrc", "source", NULL);
+      gst_worker_builder_add (builder, "gdpdepay", NULL, NULL);
+      gst_worker_builder_caps (builder, "%s", caps);
+      gst_case_add_inter (builder, inter_sink, "sink", "input_%d",
+          cas->sink_port);
       break;
 
     case GST_CASE_PREVIEW:
-      if (is_audiostream) {
-        g_string_append_printf (desc,
-            "interaudiosrc name=source channel=input_%d ! %s ! audioparse raw-format=s16le rate=48000 ! interaudiosink name=sink channel=branch_%d",
-            cas->sink_port, caps, cas->sink_port);
-      } else {
-        g_string_append_printf (desc,
-            "intervideosrc name=source channel=input_%d ! %s ! intervideosink name=sink channel=branch_%d",
-            cas->sink_port, caps, cas->sink_port);
-      }
+      gst_case_add_inter (builder, inter_src, "source", "input_%d",
+          cas->sink_port);
+      gst_worker_builder_caps (builder, "%s", caps);
+      if (audio)
+        gst_case_add_audioparse (builder);
+      gst_case_add_inter (builder, inter_sink, "sink", "branch_%d",
+          cas->sink_port);
       break;
 
     case GST_CASE_COMPOSITE_AUDIO:
-      g_string_append_printf (desc,
-          "interaudiosrc name=source channel=input_%d ! %s ! audioparse raw-format=s16le rate=48000 ! tee name=s "
-          "s. ! queue ! interaudiosink name=sink1 channel=branch_%d "
-          "s. ! queue ! interaudiosink name=sink2 channel=composite_audio",
-          cas->sink_port, caps, cas->sink_port);
-      break;
-
     case GST_CASE_COMPOSITE_VIDEO_A:
     case GST_CASE_COMPOSITE_VIDEO_B:
     {
-      gchar *channel = cas->type == GST_CASE_COMPOSITE_VIDEO_A ? "a" : "b";
-      g_string_append_printf (desc,
-          "intervideosrc name=source channel=input_%d ! %s ! tee name=s "
-          "s. ! queue ! intervideosink name=sink1 channel=branch_%d "
-          "s. ! queue ! intervideosink name=sink2 channel=composite_%s",
-          cas->sink_port, caps, cas->sink_port, channel);
+      const gchar *composite = "composite_audio";
+      if (cas->type == GST_CASE_COMPOSITE_VIDEO_A)
+        composite = "composite_a";
+      else if (cas->type == GST_CASE_COMPOSITE_VIDEO_B)
+        composite = "composite_b";
+
+      gst_case_add_inter (builder, inter_src, "source", "input_%d",
+          cas->sink_port);
+      gst_worker_builder_caps (builder, "%s", caps);
+      if (audio)
+        gst_case_add_audioparse (builder);
+      gst_worker_builder_add (builder, "tee", "s", NULL);
+      gst_worker_builder_queue (builder, NULL, !audio);
+      gst_case_add_inter (builder, inter_sink, "sink1", "branch_%d",
+          cas->sink_port);
+      gst_worker_builder_from (builder, "s");
+      gst_worker_builder_queue (builder, NULL, !audio);
+      gst_worker_builder_inter (builder, inter_sink, "sink2", composite);
       break;
     }
 
     case GST_CASE_BRANCH_AUDIO:
-      g_string_append_printf (desc,
-          "interaudiosrc name=source channel=branch_%d ! %s ! audioparse raw-format=s16le rate=48000 ! gdppay ! tcpserversink name=sink port=%d",
-          cas->sink_port, caps, cas->sink_port);
-      break;
-
     case GST_CASE_BRANCH_VIDEO_A:
     case GST_CASE_BRANCH_VIDEO_B:
-      g_string_append_printf (desc,
-          "intervideosrc name=source channel=branch_%d ! %s ! gdppay ! tcpserversink name=sink port=%d",
-          cas->sink_port, caps, cas->sink_port);
-      break;
-
     case GST_CASE_BRANCH_PREVIEW:
-      g_string_append_printf (desc,
-          "intervideosrc name=source channel=branch_%d ! %s ! gdppay ! tcpserversink name=sink port=%d",
-          cas->sink_port, caps, cas->sink_port);
+      gst_case_add_inter (builder, inter_src, "source", "branch_%d",
+          cas->sink_port);
+      gst_worker_builder_caps (builder, "%s", caps);
+      if (audio)
+        gst_case_add_audioparse (builder);
+      /* Where the load governor sheds the work of the branch */
+      gst_worker_builder_add (builder, "valve", "idle", NULL);
+      if (!audio) {
+        gst_worker_builder_add (builder, "videorate", NULL,
+            "drop-only", TRUE, NULL);
+        gst_worker_builder_add (builder, "videoscale", NULL, NULL);
+        gst_worker_builder_add (builder, "capsfilter", "degrade", NULL);
+      }
+      gst_worker_builder_add (builder, "gdppay", NULL, NULL);
+      gst_worker_builder_add (builder, "tcpserversink", "sink",
+          "port", (gint) cas->sink_port, NULL);
+      gst_worker_builder_serve_sync (builder);
       break;
 
     default:
       ERROR ("unknown case (%d)", cas->type);
-      break;
+      return FALSE;
   }
 
-  INFO ("pipeline(%p): %s\n", cas, desc->str);
-  return desc;
+  INFO ("pipeline(%p): %s\n", cas, builder->desc->str);
+  return TRUE;
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @memberof GstCase
+ * @return A GString instance representing the pipeline string.
+ *
+ * Retreiving the GstCase pipeline as a string, for debugging only.
+ */
+static GString *
+gst_case_get_pipeline_string (GstCase * cas)
+{
+  return gst_worker_get_pipeline_dump (GST_WORKER (cas));
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @memberof GstCase
+ * @return The caps limiting the rate and size of the branch.
+ */
+static GstCaps *
+gst_case_degrade_caps (GstCase * cas)
+{
+  GstStructure *video;
+  GstCaps *caps;
+  gint width, height, num, den;
+
+  caps = gst_caps_new_empty_simple ("video/x-raw");
+  video = gst_caps_get_structure (gst_switch_server_getcaps (), 0);
+  if (cas->degrade_rate > 1 &&
+      gst_structure_get_fraction (video, "framerate", &num, &den) && num > 0) {
+    gst_caps_set_simple (caps, "framerate", GST_TYPE_FRACTION, num,
+        den * (gint) cas->degrade_rate, NULL);
+  }
+  if (cas->degrade_scale > 1 &&
+      gst_structure_get_int (video, "width", &width) &&
+      gst_structure_get_int (video, "height", &height)) {
+    /* Even sizes, for the subsampled formats */
+    gst_caps_set_simple (caps,
+        "width", G_TYPE_INT, MAX (width / (gint) cas->degrade_scale, 2) & ~1,
+        "height", G_TYPE_INT, MAX (height / (gint) cas->degrade_scale, 2) & ~1,
+        NULL);
+  }
+  return caps;
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @param sink The sink of the branch.
+ * @param valve The valve of the branch.
+ * @memberof GstCase
+ *
+ * Let the branch through, or drop everything if it should be idle and no
+ * client is watching it.
+ */
+static void
+gst_case_update_idle (GstCase * cas, GstElement * sink, GstElement * valve)
+{
+  guint clients = 0;
+
+  if (cas->degrade_idle)
+    g_object_get (sink, "num-handles", &clients, NULL);
+
+  g_object_set (valve, "drop", cas->degrade_idle && clients == 0, NULL);
+}
+
+/**
+ * @param sink The sink of a branch.
+ * @param name The name of another element of the branch.
+ * @return The element, or NULL.
+ *
+ * Find an element next to the sink, without the lock of the worker, as
+ * the signals of the sink are emitted while the worker may hold it.
+ */
+static GstElement *
+gst_case_get_sibling (GstElement * sink, const gchar * name)
+{
+  GstObject *parent = gst_object_get_parent (GST_OBJECT (sink));
+  GstElement *element = NULL;
+
+  if (parent) {
+    element = gst_bin_get_by_name (GST_BIN (parent), name);
+    gst_object_unref (parent);
+  }
+  return element;
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @param sink The sink of the branch.
+ * @memberof GstCase
+ *
+ * Apply the degradation of the branch to its pipeline.
+ */
+static void
+gst_case_apply_degrade (GstCase * cas, GstElement * sink)
+{
+  GstElement *valve = gst_case_get_sibling (sink, "idle");
+  GstElement *filter = gst_case_get_sibling (sink, "degrade");
+
+  if (filter) {
+    GstCaps *caps = gst_case_degrade_caps (cas);
+    g_object_set (filter, "caps", caps, NULL);
+    gst_caps_unref (caps);
+    gst_object_unref (filter);
+  }
+  if (valve) {
+    gst_case_update_idle (cas, sink, valve);
+    gst_object_unref (valve);
+  }
+}
+
+/**
+ * @param cas The GstCase instance.
+ * @param rate The framerate divisor of video branches.
+ * @param scale The size divisor of video branches.
+ * @param idle TRUE to drop everything while no client is watching.
+ * @memberof GstCase
+ *
+ * Degrade a branch serving a preview to save processing time, or restore
+ * it with 1, 1, FALSE.
+ */
+void
+gst_case_degrade (GstCase * cas, guint rate, guint scale, gboolean idle)
+{
+  GstElement *sink;
+
+  g_return_if_fail (GST_IS_CASE (cas));
+
+  cas->degrade_rate = MAX (rate, 1);
+  cas->degrade_scale = MAX (scale, 1);
+  cas->degrade_idle = idle;
+
+  // A branch not started yet is degraded when prepared
+  sink = gst_worker_get_element (GST_WORKER (cas), "sink");
+  if (sink) {
+    gst_case_apply_degrade (cas, sink);
+    gst_object_unref (sink);
+  }
 }
 
 /**
@@ -377,9 +588,18 @@ static void
 gst_case_client_socket_added (GstElement * element,
     GSocket * socket, GstCase * cas)
 {
+  GstElement *valve;
+
   g_return_if_fail (G_IS_SOCKET (socket));
 
   //INFO ("client-socket-added: %d", g_socket_get_fd (socket));
+
+  /* An idle branch is watched again */
+  valve = gst_case_get_sibling (element, "idle");
+  if (valve) {
+    g_object_set (valve, "drop", FALSE, NULL);
+    gst_object_unref (valve);
+  }
 }
 
 /**
@@ -399,6 +619,14 @@ gst_case_client_socket_removed (GstElement * element,
   //INFO ("client-socket-removed: %d", g_socket_get_fd (socket));
 
   g_socket_close (socket, NULL);
+
+  if (cas->degrade_idle) {
+    GstElement *valve = gst_case_get_sibling (element, "idle");
+    if (valve) {
+      gst_case_update_idle (cas, element, valve);
+      gst_object_unref (valve);
+    }
+  }
 }
 
 /**
@@ -437,11 +665,15 @@ gst_case_prepare (GstCase * cas)
 
       g_return_val_if_fail (GST_IS_ELEMENT (sink), FALSE);
 
-      g_signal_connect (sink, "client-added",
+      gst_worker_connect_element (worker, sink, "client-added",
           G_CALLBACK (gst_case_client_socket_added), cas);
 
-      g_signal_connect (sink, "client-socket-removed",
+      gst_worker_connect_element (worker, sink, "client-socket-removed",
           G_CALLBACK (gst_case_client_socket_removed), cas);
+
+      gst_sink_policy_apply (sink, worker->name, FALSE);
+      gst_case_apply_degrade (cas, sink);
+      gst_object_unref (sink);
     }
       break;
 
@@ -548,6 +780,8 @@ gst_case_class_init (GstCaseClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   worker_class->prepare = (GstWorkerPrepareFunc) gst_case_prepare;
+  worker_class->build_pipeline = (GstWorkerBuildPipelineFunc)
+      gst_case_build_pipeline;
   worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
       gst_case_get_pipeline_string;
   worker_class->close = (GstWorkerCloseFunc) gst_case_close;
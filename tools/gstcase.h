@@ -95,6 +95,9 @@ typedef struct _GstCase
   guint a_height;
   guint b_width;
   guint b_height;
+  guint degrade_rate;           /*!< Framerate divisor of a branch. */
+  guint degrade_scale;          /*!< Size divisor of a branch. */
+  gboolean degrade_idle;        /*!< Drop a branch nobody is watching. */
 } GstCase;
 
 /**
@@ -110,5 +113,7 @@ typedef struct _GstCaseClass
 } GstCaseClass;
 
 GType gst_case_get_type (void);
+void gst_case_degrade (GstCase * cas, guint rate, guint scale,
+    gboolean idle);
 
 #endif //__GST_CASE_H__
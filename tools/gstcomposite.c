@@ -84,6 +84,11 @@ gst_composite_init (GstComposite * composite)
   composite->adjusting = FALSE;
   composite->transition = FALSE;
   composite->deprecated = FALSE;
+  composite->held = FALSE;
+  composite->held_transition = FALSE;
+  composite->held_adjustment = FALSE;
+  GST_WORKER (composite)->task_class = "composite";
+  GST_WORKER (composite)->priority = GST_WORKER_PRIORITY_PROGRAM;
 
   g_mutex_init (&composite->lock);
   g_mutex_init (&composite->transition_lock);
@@ -212,6 +217,14 @@ gst_composite_set_mode (GstComposite * composite, GstCompositeMode mode)
      composite->b_width, composite->b_height);
    */
 
+  GST_COMPOSITE_LOCK (composite);
+  if (composite->held) {
+    composite->held_transition = TRUE;
+    GST_COMPOSITE_UNLOCK (composite);
+    return;
+  }
+  GST_COMPOSITE_UNLOCK (composite);
+
   gst_composite_start_transition (composite);
 }
 
@@ -406,160 +419,136 @@ gst_composite_apply_parameters (GstComposite * composite)
 }
 
 /**
- * gst_composite_get_pipeline_string:
+ * gst_composite_add_input:
  *
- * Fetching the composite pipeline string, it's invoked by %GstWorker when
- * preparing the worker.
+ * Add a scaled input of the composite.
  */
-static GString *
-gst_composite_get_pipeline_string (GstComposite * composite)
+static void
+gst_composite_add_input (GstWorkerBuilder * builder, const gchar * name,
+    const gchar * channel, guint width, guint height)
 {
-  GString *desc;
-
-  desc = g_string_new ("");
+  gst_worker_builder_inter (builder, "intervideosrc", name, channel);
+  gst_worker_builder_caps (builder, "video/x-raw,width=%d,height=%d",
+      width, height);
+}
 
-  g_string_append_printf (desc,
-      "intervideosrc name=source_a channel=composite_a_scaled ");
+/**
+ * gst_composite_build_pipeline:
+ *
+ * Building the composite pipeline, it's invoked by %GstWorker when
+ * preparing the worker.
+ */
+static gboolean
+gst_composite_build_pipeline (GstComposite * composite,
+    GstWorkerBuilder * builder)
+{
   if (composite->mode == COMPOSE_MODE_NONE) {
-    g_string_append_printf (desc,
-        "source_a. ! video/x-raw,width=%d,height=%d ",
+    gst_composite_add_input (builder, "source_a", "composite_a_scaled",
         composite->a_width, composite->a_height);
-    /*
-       ASSESS ("assess-compose-a-source");
-     */
-    g_string_append_printf (desc, "! queue ");
-    g_string_append_printf (desc, "! identity name=mix ");
+    gst_worker_builder_queue (builder, NULL, TRUE);
+    gst_worker_builder_add (builder, "identity", "mix", NULL);
   } else {
-    g_string_append_printf (desc,
-        "intervideosrc name=source_b channel=composite_b_scaled ");
-    g_string_append_printf (desc,
-        "videomixer name=mix "
-        "sink_0::xpos=%d "
-        "sink_0::ypos=%d "
-        "sink_0::zorder=0 "
-        "sink_1::xpos=%d "
-        "sink_1::ypos=%d "
-        "sink_1::zorder=1 ",
-        composite->a_x, composite->a_y, composite->b_x, composite->b_y);
+    gst_worker_builder_add (builder, "videomixer", "mix", NULL);
 
     // ===== B =====
-    g_string_append_printf (desc,
-        "source_b. ! video/x-raw,width=%d,height=%d ",
+    gst_worker_builder_from (builder, NULL);
+    gst_composite_add_input (builder, "source_b", "composite_b_scaled",
         composite->b_width, composite->b_height);
-    ASSESS ("assess-compose-b-source");
-    g_string_append_printf (desc, "! queue ");
-#if 0
-    if (composite->width != composite->b_width ||
-        composite->height != composite->b_height) {
-      g_string_append_printf (desc,
-          "! videoscale ! video/x-raw,width=%d,height=%d ",
-          composite->b_width, composite->b_height);
-      /*
-         ASSESS ("assess-compose-b-scaled");
-       */
-    }
-#endif
-    g_string_append_printf (desc, "! mix.sink_1 ");
+    ASSESS_BUILDER (builder, assess-compose-b-source);
+    gst_worker_builder_queue (builder, NULL, TRUE);
+    gst_worker_builder_link_to (builder, "mix", "sink_1");
+    gst_worker_builder_set_pad (builder, "mix", "sink_1",
+        "xpos", (gint) composite->b_x, "ypos", (gint) composite->b_y,
+        "zorder", (guint) 1, NULL);
 
     // ===== A =====
-    g_string_append_printf (desc,
-        "source_a. ! video/x-raw,width=%d,height=%d ",
+    gst_worker_builder_from (builder, NULL);
+    gst_composite_add_input (builder, "source_a", "composite_a_scaled",
         composite->a_width, composite->a_height);
-    ASSESS ("assess-compose-a-source");
-    g_string_append_printf (desc, "! queue ");
-#if 0
-    if (composite->width != composite->a_width ||
-        composite->height != composite->a_height) {
-      g_string_append_printf (desc,
-          "! videoscale ! video/x-raw,width=%d,height=%d ",
-          composite->a_width, composite->a_height);
-      /*
-         ASSESS ("assess-compose-b-scaled");
-       */
-    }
-#endif
-    g_string_append_printf (desc, "! mix.sink_0 ");
+    ASSESS_BUILDER (builder, assess-compose-a-source);
+    gst_worker_builder_queue (builder, NULL, TRUE);
+    gst_worker_builder_link_to (builder, "mix", "sink_0");
+    gst_worker_builder_set_pad (builder, "mix", "sink_0",
+        "xpos", (gint) composite->a_x, "ypos", (gint) composite->a_y,
+        "zorder", (guint) 0, NULL);
+
+    gst_worker_builder_from (builder, "mix");
   }
 
-  g_string_append_printf (desc, "mix. ! video/x-raw,width=%d,height=%d ",
+  gst_worker_builder_caps (builder, "video/x-raw,width=%d,height=%d",
       composite->width, composite->height);
-  ASSESS ("assess-compose-result");
-  g_string_append_printf (desc, "! tee name=result ");
+  ASSESS_BUILDER (builder, assess-compose-result);
+  gst_worker_builder_add (builder, "tee", "result", NULL);
 
-  g_string_append_printf (desc, "result. ! queue ");
-  /*
-     ASSESS ("assess-compose-to-output");
-   */
-  g_string_append_printf (desc, "! out. ");
-  g_string_append_printf (desc,
-      "intervideosink name=out channel=composite_out ");
+  gst_worker_builder_queue (builder, NULL, TRUE);
+  gst_worker_builder_inter (builder, "intervideosink", "out",
+      "composite_out");
 
   if (opts.record_filename) {
-    g_string_append_printf (desc, "result. ! queue ");
-    /*
-       ASSESS ("assess-compose-to-record");
-     */
-    g_string_append_printf (desc, "! record. ");
-    g_string_append_printf (desc, "intervideosink name=record "
-        "channel=composite_video ");
+    gst_worker_builder_from (builder, "result");
+    gst_worker_builder_queue (builder, NULL, TRUE);
+    gst_worker_builder_inter (builder, "intervideosink", "record",
+        "composite_video");
   }
 
-  return desc;
+  return TRUE;
 }
 
 /**
- * gst_composite_get_scaler_string:
+ * gst_composite_add_scaler:
  *
- * Getting the scaler pipeline string.
- *
- * <b>The Scaler Pipeline</b>
- *     The scaler pipeline is tending to scale the A/B inputs into the proper
- *     video size for composite.
+ * Add the scaler of one composite input.
  */
-static GString *
-gst_composite_get_scaler_string (GstWorker * worker, GstComposite * composite)
+static void
+gst_composite_add_scaler (GstWorkerBuilder * builder, const gchar * name,
+    GstComposite * composite, guint width, guint height)
 {
-  GString *desc;
+  gchar *element = g_strdup_printf ("source_%s", name);
+  gchar *channel = g_strdup_printf ("composite_%s", name);
 
-  desc = g_string_new ("");
-
-  g_string_append_printf (desc,
-      "intervideosrc name=source_a channel=composite_a ");
-  g_string_append_printf (desc,
-      "intervideosink name=sink_a sync=false channel=composite_a_scaled ");
-
-  g_string_append_printf (desc,
-      "source_a. ! video/x-raw,width=%d,height=%d ",
+  gst_worker_builder_inter (builder, "intervideosrc", element, channel);
+  gst_worker_builder_caps (builder, "video/x-raw,width=%d,height=%d",
       composite->width, composite->height);
-  g_string_append_printf (desc, "! queue ");
+  gst_worker_builder_queue (builder, NULL, TRUE);
   /*
-     g_string_append_printf (desc,
-     "! videoconvert ! facedetect2 ! speakertrack ! videoconvert ");
+     "! videoconvert ! facedetect2 ! speakertrack ! videoconvert "
    */
-  g_string_append_printf (desc,
-      "! videoscale ! video/x-raw,width=%d,height=%d ! sink_a. ",
+  gst_worker_builder_add (builder, "videoscale", NULL, NULL);
+  gst_worker_builder_caps (builder, "video/x-raw,width=%d,height=%d",
+      width, height);
+  g_free (element);
+  g_free (channel);
+
+  element = g_strdup_printf ("sink_%s", name);
+  channel = g_strdup_printf ("composite_%s_scaled", name);
+  gst_worker_builder_add (builder, "intervideosink", element,
+      "sync", FALSE, "channel", channel, NULL);
+  g_free (element);
+  g_free (channel);
+}
+
+/**
+ * gst_composite_build_scaler:
+ *
+ * Building the scaler pipeline.
+ *
+ * <b>The Scaler Pipeline</b>
+ *     The scaler pipeline is tending to scale the A/B inputs into the proper
+ *     video size for composite.
+ */
+static gboolean
+gst_composite_build_scaler (GstWorker * worker, GstWorkerBuilder * builder,
+    GstComposite * composite)
+{
+  gst_composite_add_scaler (builder, "a", composite,
       composite->a_width, composite->a_height);
 
-  if (composite->mode == COMPOSE_MODE_NONE) {
-  } else {
-    g_string_append_printf (desc,
-        "intervideosrc name=source_b channel=composite_b ");
-    g_string_append_printf (desc,
-        "intervideosink name=sink_b sync=false channel=composite_b_scaled ");
-
-    g_string_append_printf (desc,
-        "source_b. ! video/x-raw,width=%d,height=%d ",
-        composite->width, composite->height);
-    g_string_append_printf (desc, "! queue ");
-    /*
-       g_string_append_printf (desc,
-       "! videoconvert ! facedetect2 ! speakertrack ! videoconvert ");
-     */
-    g_string_append_printf (desc,
-        "! videoscale ! video/x-raw,width=%d,height=%d ! sink_b. ",
+  if (composite->mode != COMPOSE_MODE_NONE) {
+    gst_worker_builder_from (builder, NULL);
+    gst_composite_add_scaler (builder, "b", composite,
         composite->b_width, composite->b_height);
   }
-  return desc;
+  return TRUE;
 }
 
 /**
@@ -576,9 +565,11 @@ gst_composite_prepare (GstComposite * composite)
   if (composite->scaler == NULL) {
     composite->scaler = GST_WORKER (g_object_new (GST_TYPE_WORKER,
             "name", "scale", NULL));
-    composite->scaler->pipeline_func_data = composite;
-    composite->scaler->pipeline_func = (GstWorkerGetPipelineString)
-        gst_composite_get_scaler_string;
+    composite->scaler->task_class = "composite";
+    composite->scaler->priority = GST_WORKER_PRIORITY_PROGRAM;
+    composite->scaler->build_func_data = composite;
+    composite->scaler->build_func = (GstWorkerBuildPipeline)
+        gst_composite_build_scaler;
   } else {
     GstWorkerClass *worker_class;
     worker_class = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (composite->scaler));
@@ -905,6 +896,18 @@ gst_composite_adjust_pip (GstComposite * composite, gint x, gint y,
   composite->b_x = x;
   composite->b_y = y;
 
+  /* A held mode change rebuilds the pipeline with the new PIP anyway, a
+     held resize is done once on release. */
+  if (composite->held && (composite->held_transition ||
+          composite->b_width != w || composite->b_height != h)) {
+    composite->b_width = w;
+    composite->b_height = h;
+    if (!composite->held_transition)
+      composite->held_adjustment = TRUE;
+    result = TRUE;
+    goto end;
+  }
+
   if (composite->b_width != w || composite->b_height != h) {
     composite->b_width = w;
     composite->b_height = h;
@@ -963,6 +966,56 @@ end:
   return result;
 }
 
+/**
+ * gst_composite_hold:
+ *  @param composite The GstComposite instance
+ *
+ *  Hold back the mode changes and PIP resizes until gst_composite_release(),
+ *  so that a sequence of them restarts the pipeline only once.
+ */
+void
+gst_composite_hold (GstComposite * composite)
+{
+  g_return_if_fail (GST_IS_COMPOSITE (composite));
+
+  GST_COMPOSITE_LOCK (composite);
+  composite->held = TRUE;
+  GST_COMPOSITE_UNLOCK (composite);
+}
+
+/**
+ * gst_composite_release:
+ *  @param composite The GstComposite instance
+ *  @return TRUE if the held changes restarted the pipeline
+ *
+ *  Apply the changes held back since gst_composite_hold() in a single
+ *  transition, or a single PIP adjustment if the mode was not changed.
+ */
+gboolean
+gst_composite_release (GstComposite * composite)
+{
+  gboolean transition, adjustment;
+
+  g_return_val_if_fail (GST_IS_COMPOSITE (composite), FALSE);
+
+  GST_COMPOSITE_LOCK (composite);
+  transition = composite->held_transition;
+  adjustment = composite->held_adjustment && !composite->adjusting;
+  composite->held = FALSE;
+  composite->held_transition = FALSE;
+  composite->held_adjustment = FALSE;
+  if (!transition && adjustment) {
+    composite->adjusting = TRUE;
+    gst_worker_stop (GST_WORKER (composite));
+  }
+  GST_COMPOSITE_UNLOCK (composite);
+
+  if (transition)
+    gst_composite_start_transition (composite);
+
+  return transition || adjustment;
+}
+
 /**
  * gst_composite_retry_transition:
  * @return Always FALSE to allow glib to cleanup the timeout source
@@ -1195,6 +1248,6 @@ gst_composite_class_init (GstCompositeClass * klass)
   worker_class->start_worker = (GstWorkerAliveFunc) gst_composite_start;
   worker_class->end_worker = (GstWorkerAliveFunc) gst_composite_end;
   worker_class->message = (GstWorkerMessageFunc) gst_composite_message;
-  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
-      gst_composite_get_pipeline_string;
+  worker_class->build_pipeline = (GstWorkerBuildPipelineFunc)
+      gst_composite_build_pipeline;
 }
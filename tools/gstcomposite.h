@@ -101,6 +101,9 @@ typedef struct _GstCompositeClass GstCompositeClass;
  *  @param adjusting the status of adjusting PIP
  *  @param transition the status of transiting modes
  *  @param deprecated (deprecated)
+ *  @param held changes are held back by gst_composite_hold()
+ *  @param held_transition a mode change is waiting for the release
+ *  @param held_adjustment a PIP resize is waiting for the release
  *  @param scaler the scaler for A/B videos
  */
 struct _GstComposite
@@ -131,6 +134,9 @@ struct _GstComposite
   gboolean adjusting;
   gboolean transition;
   gboolean deprecated;
+  gboolean held;
+  gboolean held_transition;
+  gboolean held_adjustment;
 
   GstWorker *scaler;
 };
@@ -150,6 +156,8 @@ struct _GstCompositeClass
 GType gst_composite_get_type (void);
 gboolean gst_composite_adjust_pip (GstComposite * composite,
     gint x, gint y, gint w, gint h);
+void gst_composite_hold (GstComposite * composite);
+gboolean gst_composite_release (GstComposite * composite);
 gint gst_composite_default_width ();
 gint gst_composite_default_height ();
 gint gst_check_composite_min_pip_width (gint pip_w);
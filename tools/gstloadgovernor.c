@@ -0,0 +1,117 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstloadgovernor.h"
+#include "../logutils.h"
+
+/*!< @internal Late program buffers in an interval degrading the previews. */
+#define GST_LOAD_GOVERNOR_LATE 2
+
+/*!< @internal A program buffer this late degrades the previews, in ns. */
+#define GST_LOAD_GOVERNOR_JITTER (40 * GST_MSECOND)
+
+/*!< @internal Intervals without late buffers before restoring a step. */
+#define GST_LOAD_GOVERNOR_HOLD 5
+
+/*!< @internal The steps, each degrading the previews more. */
+static const GstLoadGovernorStep gst_load_governor_steps[] = {
+  {"none", 1, 1, FALSE},
+  {"half-rate", 2, 1, FALSE},
+  {"half-size", 2, 2, FALSE},
+  {"quarter-rate", 4, 2, FALSE},
+  {"quarter-size", 4, 4, FALSE},
+  {"idle-paused", 4, 4, TRUE},
+};
+
+/**
+ * @brief Take the QoS of the program and step the previews up or down.
+ * @return TRUE to keep governing.
+ */
+static gboolean
+gst_load_governor_tick (GstLoadGovernor * governor)
+{
+  GstWorkerQos qos;
+  gint level = g_atomic_int_get (&governor->level);
+  gint last = G_N_ELEMENTS (gst_load_governor_steps) - 1;
+
+  gst_worker_take_qos (GST_WORKER_PRIORITY_PROGRAM, &qos);
+
+  if (qos.late >= GST_LOAD_GOVERNOR_LATE ||
+      qos.max_jitter > GST_LOAD_GOVERNOR_JITTER) {
+    governor->calm = 0;
+    level = MIN (level + 1, last);
+  } else if (level > 0 && ++governor->calm >= GST_LOAD_GOVERNOR_HOLD) {
+    governor->calm = 0;
+    level -= 1;
+  }
+
+  if (level != g_atomic_int_get (&governor->level)) {
+    INFO ("previews %s (%u late, jitter %" G_GINT64_FORMAT " us, "
+        "proportion %.2f)", gst_load_governor_steps[level].name, qos.late,
+        qos.max_jitter / GST_USECOND, qos.max_proportion);
+    g_atomic_int_set (&governor->level, level);
+    governor->apply (level, &gst_load_governor_steps[level], governor->data);
+  }
+  return TRUE;
+}
+
+/**
+ * @param interval The interval in milliseconds.
+ * @param apply The function applying a new level.
+ * @param data The data passed to apply.
+ * @return A governor running in the default main context.
+ */
+GstLoadGovernor *
+gst_load_governor_new (guint interval, GstLoadGovernorFunc apply,
+    gpointer data)
+{
+  GstLoadGovernor *governor = g_new0 (GstLoadGovernor, 1);
+  GstWorkerQos qos;
+
+  governor->apply = apply;
+  governor->data = data;
+
+  /* Start from what the program reports from now on */
+  gst_worker_take_qos (GST_WORKER_PRIORITY_PROGRAM, &qos);
+  governor->source = g_timeout_add (interval, (GSourceFunc)
+      gst_load_governor_tick, governor);
+  return governor;
+}
+
+void
+gst_load_governor_free (GstLoadGovernor * governor)
+{
+  g_source_remove (governor->source);
+  g_free (governor);
+}
+
+/**
+ * @return The current degradation, for previews starting now.
+ */
+const GstLoadGovernorStep *
+gst_load_governor_get_step (GstLoadGovernor * governor)
+{
+  return &gst_load_governor_steps[g_atomic_int_get (&governor->level)];
+}
@@ -0,0 +1,75 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_LOAD_GOVERNOR_H__
+#define __GST_LOAD_GOVERNOR_H__
+
+#include "gstworker.h"
+
+typedef struct _GstLoadGovernor GstLoadGovernor;
+
+/**
+ *  @struct _GstLoadGovernorStep
+ *  @brief How much the previews are degraded at a level.
+ */
+typedef struct _GstLoadGovernorStep
+{
+  const gchar *name;            /*!< the step, as reported to clients */
+  guint rate;                   /*!< the framerate divisor of previews */
+  guint scale;                  /*!< the size divisor of previews */
+  gboolean idle;                /*!< drop previews nobody is watching */
+} GstLoadGovernorStep;
+
+/**
+ *  @brief Applies a level to the previews.
+ *  @param level The new level, 0 for none.
+ *  @param step The degradation at the level.
+ *  @param data User defined data pointer.
+ */
+typedef void (*GstLoadGovernorFunc) (guint level,
+    const GstLoadGovernorStep * step, gpointer data);
+
+/**
+ *  @struct _GstLoadGovernor
+ *  @brief Sheds the work of the previews while the program is late.
+ *
+ *  Every interval the governor takes the QoS of the program workers. If
+ *  their sinks got buffers late, it degrades the previews one step
+ *  further: a lower framerate, a smaller size, then dropping previews
+ *  nobody is watching. After a few intervals without, it restores them a
+ *  step back.
+ */
+struct _GstLoadGovernor
+{
+  gint level;                   /*!< the current step */
+  guint calm;                   /*!< intervals without late buffers */
+  guint source;                 /*!< the timeout in the main context */
+  GstLoadGovernorFunc apply;    /*!< applies a new level */
+  gpointer data;                /*!< the data passed to %apply */
+};
+
+GstLoadGovernor *gst_load_governor_new (guint interval,
+    GstLoadGovernorFunc apply, gpointer data);
+void gst_load_governor_free (GstLoadGovernor * governor);
+const GstLoadGovernorStep *gst_load_governor_get_step (GstLoadGovernor *
+    governor);
+
+#endif //__GST_LOAD_GOVERNOR_H__
@@ -31,6 +31,7 @@
 #include "gstswitchserver.h"
 #include "gstcomposite.h"
 #include "gstrecorder.h"
+#include "gstsinkpolicy.h"
 
 enum
 {
@@ -39,8 +40,19 @@ enum
   PROP_PORT,
   PROP_WIDTH,
   PROP_HEIGHT,
+  PROP_ENCODER,
+  PROP_CHANNEL,
+  PROP_PROXY_HEIGHT,
+  PROP_PROXY_ENCODER,
 };
 
+#define GST_RECORDER_LOCK_ENCODER(rec) (g_mutex_lock (&(rec)->encoder_lock))
+#define GST_RECORDER_UNLOCK_ENCODER(rec) (g_mutex_unlock (&(rec)->encoder_lock))
+
+#define GST_RECORDER_MIN_QUALITY 20     /* percent */
+#define GST_RECORDER_PENALTY_STEP 10    /* percent */
+#define GST_RECORDER_MAX_PENALTY 50     /* percent */
+
 enum
 {
   SIGNAL__LAST,
@@ -63,8 +75,20 @@ gst_recorder_init (GstRecorder * rec)
 {
   rec->sink_port = 0;
   rec->mode = 0;
+  GST_WORKER (rec)->task_class = "output";
+  GST_WORKER (rec)->priority = GST_WORKER_PRIORITY_PROGRAM;
   rec->width = 0;
   rec->height = 0;
+  g_mutex_init (&rec->encoder_lock);
+  rec->encoder_spec = g_strdup (GST_RECORDER_DEFAULT_ENCODER);
+  parse_encoder (rec->encoder_spec, &rec->encoder, NULL);
+  rec->channel = NULL;
+  rec->quality = 100;
+  rec->penalty = 0;
+  rec->last_overrun = 0;
+  rec->proxy_height = 0;
+  rec->proxy_encoder_spec = g_strdup (GST_RECORDER_DEFAULT_PROXY_ENCODER);
+  parse_encoder (rec->proxy_encoder_spec, &rec->proxy_encoder, NULL);
 
   // Recording pipeline needs clean shut-down
   // via EOS to close out each recording
@@ -96,6 +120,11 @@ gst_recorder_dispose (GstRecorder * rec)
 static void
 gst_recorder_finalize (GstRecorder * rec)
 {
+  g_free (rec->encoder_spec);
+  g_free (rec->channel);
+  g_free (rec->proxy_encoder_spec);
+  g_mutex_clear (&rec->encoder_lock);
+
   if (G_OBJECT_CLASS (parent_class)->finalize)
     (*G_OBJECT_CLASS (parent_class)->finalize) (G_OBJECT (rec));
 }
@@ -128,6 +157,22 @@ gst_recorder_get_property (GstRecorder * rec, guint property_id,
     case PROP_HEIGHT:
       g_value_set_uint (value, rec->height);
       break;
+    case PROP_ENCODER:
+      GST_RECORDER_LOCK_ENCODER (rec);
+      g_value_set_string (value, rec->encoder_spec);
+      GST_RECORDER_UNLOCK_ENCODER (rec);
+      break;
+    case PROP_CHANNEL:
+      g_value_set_string (value, rec->channel);
+      break;
+    case PROP_PROXY_HEIGHT:
+      g_value_set_uint (value, rec->proxy_height);
+      break;
+    case PROP_PROXY_ENCODER:
+      GST_RECORDER_LOCK_ENCODER (rec);
+      g_value_set_string (value, rec->proxy_encoder_spec);
+      GST_RECORDER_UNLOCK_ENCODER (rec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (rec, property_id, pspec);
       break;
@@ -162,6 +207,44 @@ gst_recorder_set_property (GstRecorder * rec, guint property_id,
     case PROP_HEIGHT:
       rec->height = g_value_get_uint (value);
       break;
+    case PROP_ENCODER:
+    {
+      const gchar *spec = g_value_get_string (value);
+      GstSwitchEncoder enc;
+      if (parse_encoder (spec, &enc, NULL) == 0) {
+        GST_RECORDER_LOCK_ENCODER (rec);
+        rec->encoder = enc;
+        rec->encoder_changed |= g_strcmp0 (spec, rec->encoder_spec) != 0;
+        g_free (rec->encoder_spec);
+        rec->encoder_spec = g_strdup (spec);
+        GST_RECORDER_UNLOCK_ENCODER (rec);
+      } else {
+        WARN ("invalid recording encoder: %s", spec);
+      }
+    }
+      break;
+    case PROP_CHANNEL:
+      g_free (rec->channel);
+      rec->channel = g_value_dup_string (value);
+      break;
+    case PROP_PROXY_HEIGHT:
+      rec->proxy_height = g_value_get_uint (value);
+      break;
+    case PROP_PROXY_ENCODER:
+    {
+      const gchar *spec = g_value_get_string (value);
+      GstSwitchEncoder enc;
+      if (parse_encoder (spec, &enc, NULL) == 0) {
+        GST_RECORDER_LOCK_ENCODER (rec);
+        rec->proxy_encoder = enc;
+        g_free (rec->proxy_encoder_spec);
+        rec->proxy_encoder_spec = g_strdup (spec);
+        GST_RECORDER_UNLOCK_ENCODER (rec);
+      } else {
+        WARN ("invalid proxy encoder: %s", spec);
+      }
+    }
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (rec), property_id, pspec);
       break;
@@ -268,52 +351,443 @@ gst_recorder_new_filename (const gchar * filename)
 
 /**
  * @param rec The GstRecorder instance.
+ * @param enc The encoder to fill in.
+ * @memberof GstRecorder
+ *
+ * The recording encoder with the current quality applied. ISO encoders
+ * get a single thread unless the spec asks for more.
+ */
+static void
+gst_recorder_scale_encoder (GstRecorder * rec, GstSwitchEncoder * enc)
+{
+  gint quality = rec->quality - g_atomic_int_get (&rec->penalty);
+
+  quality = MAX (quality, GST_RECORDER_MIN_QUALITY);
+  GST_RECORDER_LOCK_ENCODER (rec);
+  *enc = rec->encoder;
+  GST_RECORDER_UNLOCK_ENCODER (rec);
+  if (rec->channel && enc->threads == 0)
+    enc->threads = 1;
+
+  switch (enc->type) {
+    case GST_SWITCH_ENCODER_MJPEG:
+      enc->quality = MAX (enc->quality * quality / 100, 1);
+      break;
+    case GST_SWITCH_ENCODER_H264:
+      if (enc->crf)
+        enc->crf = MIN (enc->crf + (100 - quality) / 5, 51);
+      else
+        enc->bitrate = MAX (enc->bitrate * quality / 100, 100);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @param rec The GstRecorder instance.
+ * @param encoder The encoder element.
+ * @memberof GstRecorder
+ *
+ * Apply the current quality to a running encoder. Only the JPEG quality
+ * and the H.264 bitrate can change while playing, a constant rate factor
+ * takes effect with the next pipeline.
+ */
+static void
+gst_recorder_update_encoder (GstRecorder * rec, GstElement * encoder)
+{
+  GstSwitchEncoder enc;
+
+  gst_recorder_scale_encoder (rec, &enc);
+  switch (enc.type) {
+    case GST_SWITCH_ENCODER_MJPEG:
+      g_object_set (encoder, "quality", (gint) enc.quality, NULL);
+      break;
+    case GST_SWITCH_ENCODER_H264:
+      if (!enc.crf)
+        g_object_set (encoder, "bitrate", enc.bitrate, NULL);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @param builder The builder.
+ * @param name The splitmuxsink name.
+ * @param enc The encoder of the video recorded.
  * @memberof GstRecorder
- * @return The recorder pipeline string, needs freeing when used
  *
- * Fetching the recorder pipeline invoked by the GstWorker.
+ * Add a splitmuxsink which splits at the configured limits. Only the
+ * time limit makes it request keyframes from the encoder, a file cut by
+ * size ends at the next keyframe the encoder makes on its own.
  */
-static GString *
-gst_recorder_get_pipeline_string (GstRecorder * rec)
+static void
+gst_recorder_add_split (GstWorkerBuilder * builder, const gchar * name,
+    const GstSwitchEncoder * enc)
 {
-  const gchar *filename =
-      gst_recorder_new_filename (gst_switch_server_get_record_filename ());
-  GString *desc;
+  gst_worker_builder_add (builder, "splitmuxsink", name,
+      "max-size-time", (guint64) opts.record_split_time * GST_SECOND,
+      "max-size-bytes", (guint64) opts.record_split_size * 1024 * 1024, NULL);
+  if (opts.record_split_time && enc->type == GST_SWITCH_ENCODER_H264)
+    gst_worker_builder_set (builder, "send-keyframe-requests", TRUE, NULL);
+}
 
-  //INFO ("Recording to %s and port %d", filename, rec->sink_port);
+/**
+ * @param builder The builder.
+ * @param name The queue name, or NULL.
+ * @param max_buffers The most buffers the queue holds, 0 for the default.
+ * @memberof GstRecorder
+ *
+ * Add a queue which drops the oldest data when full instead of blocking.
+ */
+static void
+gst_recorder_add_leaky_queue (GstWorkerBuilder * builder, const gchar * name,
+    guint max_buffers)
+{
+  if (!gst_worker_builder_add (builder, "queue", name, NULL))
+    return;
+  gst_worker_builder_set_arg (builder, "leaky", "downstream");
+  if (max_buffers)
+    gst_worker_builder_set (builder, "max-size-buffers", max_buffers,
+        "max-size-bytes", (guint) 0, "max-size-time", (guint64) 0, NULL);
+}
 
-  desc = g_string_new ("");
+/**
+ * @param rec The GstRecorder instance.
+ * @param builder The builder.
+ * @memberof GstRecorder
+ * @return TRUE if the ISO recording pipeline was built
+ *
+ * The input channel is read through a leaky queue, so an encoder that
+ * can not keep up drops frames instead of delaying anything else.
+ */
+static gboolean
+gst_recorder_build_iso_pipeline (GstRecorder * rec, GstWorkerBuilder * builder)
+{
+  GstSwitchEncoder encoder;
+
+  g_atomic_int_set (&rec->penalty, 0);
+  GST_RECORDER_LOCK_ENCODER (rec);
+  rec->encoder_changed = FALSE;
+  GST_RECORDER_UNLOCK_ENCODER (rec);
+  gst_recorder_scale_encoder (rec, &encoder);
+
+  gst_worker_builder_inter (builder, "intervideosrc", "source_video",
+      rec->channel);
+  gst_worker_builder_caps (builder, "video/x-raw,width=%d,height=%d",
+      rec->width, rec->height);
+  gst_recorder_add_leaky_queue (builder, "iso_queue", 2);
+  if (encoder.type != GST_SWITCH_ENCODER_RAW)
+    gst_worker_builder_encoder (builder, &encoder, "encoder");
+  else
+    gst_worker_builder_add (builder, "identity", "encoder", NULL);
+  gst_recorder_add_split (builder, "split", &encoder);
+
+  INFO ("ISO recording pipeline\n----\n%s\n---", builder->desc->str);
+  return TRUE;
+}
 
-  // Encode the video with lossless jpeg
-  g_string_append_printf (desc,
-      "intervideosrc name=source_video channel=composite_video "
-      "! video/x-raw,width=%d,height=%d "
-      "! queue ! jpegenc quality=100 ! mux. \n", rec->width, rec->height);
+/**
+ * @param rec The GstRecorder instance.
+ * @param builder The builder.
+ * @memberof GstRecorder
+ *
+ * The proxy recording branch. It is fed the raw composite frames and the
+ * audio through leaky queues, so a slow proxy encoder drops frames of the
+ * proxy rather than holding back the master recording.
+ */
+static void
+gst_recorder_build_proxy (GstRecorder * rec, GstWorkerBuilder * builder)
+{
+  guint width = rec->width * rec->proxy_height / rec->height;
+  GstSwitchEncoder encoder;
+
+  GST_RECORDER_LOCK_ENCODER (rec);
+  encoder = rec->proxy_encoder;
+  GST_RECORDER_UNLOCK_ENCODER (rec);
+
+  // Scale down once, to an even width as most encoders require
+  width = MAX ((width + 1) & ~1, 2);
+
+  gst_worker_builder_from (builder, NULL);
+  gst_recorder_add_split (builder, "proxy_split", &encoder);
+
+  gst_worker_builder_from (builder, "raw");
+  gst_recorder_add_leaky_queue (builder, "proxy_queue", 5);
+  gst_worker_builder_add (builder, "videoscale", NULL, NULL);
+  gst_worker_builder_caps (builder, "video/x-raw,width=%u,height=%u",
+      width, rec->proxy_height);
+  gst_worker_builder_encoder (builder, &encoder, NULL);
+  gst_worker_builder_link_to (builder, "proxy_split", "video");
+
+  gst_worker_builder_from (builder, "audio");
+  gst_recorder_add_leaky_queue (builder, NULL, 0);
+  gst_worker_builder_link_to (builder, "proxy_split", "audio_%u");
+}
+
+/**
+ * @param rec The GstRecorder instance.
+ * @param builder The builder.
+ * @memberof GstRecorder
+ * @return TRUE if the recorder pipeline was built
+ *
+ * Building the recorder pipeline invoked by the GstWorker.
+ */
+static gboolean
+gst_recorder_build_pipeline (GstRecorder * rec, GstWorkerBuilder * builder)
+{
+  gboolean record = gst_switch_server_get_record_filename () != NULL;
+  gboolean proxy = record && rec->proxy_height > 0;
+  GstSwitchEncoder encoder;
+
+  if (rec->channel)
+    return gst_recorder_build_iso_pipeline (rec, builder);
+
+  // The encoder can be changed from D-Bus while the pipeline is built
+  GST_RECORDER_LOCK_ENCODER (rec);
+  encoder = rec->encoder;
+  rec->encoder_changed = FALSE;
+  GST_RECORDER_UNLOCK_ENCODER (rec);
+
+  // Encode the video with the selected recording encoder, the proxy
+  // recording shares the raw frames before it
+  gst_worker_builder_inter (builder, "intervideosrc", "source_video",
+      "composite_video");
+  gst_worker_builder_caps (builder, "video/x-raw,width=%d,height=%d",
+      rec->width, rec->height);
+  if (proxy)
+    gst_worker_builder_add (builder, "tee", "raw", NULL);
+  gst_worker_builder_queue (builder, NULL, TRUE);
+  if (record && !gst_worker_latency_get ()->leaky)
+    gst_worker_builder_set_arg (builder, "leaky", "downstream");
+  gst_worker_builder_encoder (builder, &encoder, NULL);
+  gst_worker_builder_add (builder, "tee", "video", NULL);
 
   // Don't encode the audio
-  g_string_append_printf (desc,
-      "interaudiosrc name=source_audio channel=composite_audio ! queue ! mux. \n");
+  gst_worker_builder_from (builder, NULL);
+  gst_worker_builder_inter (builder, "interaudiosrc", "source_audio",
+      "composite_audio");
+  gst_worker_builder_queue (builder, NULL, FALSE);
+  gst_worker_builder_add (builder, "tee", "audio", NULL);
+
+  // Record into files which are split at keyframes without stopping the
+  // encoder, see gst_recorder_split(). The muxer and file names are set
+  // up in gst_recorder_prepare(). A full file sink ring blocks the muxer
+  // and, once the record queue is full, the encoder. Raw frames are then
+  // dropped before the encoder, dropping encoded frames would break the
+  // delta frames after them.
+  if (record) {
+    gst_worker_builder_from (builder, NULL);
+    gst_recorder_add_split (builder, "split", &encoder);
+    gst_worker_builder_from (builder, "video");
+    gst_worker_builder_add (builder, "queue", "record_queue", NULL);
+    gst_worker_builder_link_to (builder, "split", "video");
+    gst_worker_builder_from (builder, "audio");
+    gst_recorder_add_leaky_queue (builder, NULL, 0);
+    gst_worker_builder_link_to (builder, "split", "audio_%u");
+  }
+  if (proxy)
+    gst_recorder_build_proxy (rec, builder);
 
   // Output in streamable mkv format
-  g_string_append_printf (desc,
-      "matroskamux name=mux streamable=true "
-      " writing-app='gst-switch' min-index-interval=1000000 ");
+  gst_worker_builder_from (builder, NULL);
+  gst_worker_builder_add (builder, "matroskamux", "mux",
+      "streamable", TRUE, "writing-app", "gst-switch",
+      "min-index-interval", (guint64) 1000000, NULL);
+  gst_worker_builder_add (builder, "queue", NULL,
+      "max-size-buffers", (guint) 1, NULL);
+  gst_worker_builder_add (builder, "gdppay", NULL, NULL);
+  gst_worker_builder_add (builder, "tcpserversink", "tcp_sink",
+      "sync", FALSE, "port", (gint) rec->sink_port, NULL);
+  gst_worker_builder_from (builder, "video");
+  gst_worker_builder_queue (builder, NULL, FALSE);
+  gst_worker_builder_link_to (builder, "mux", NULL);
+  gst_worker_builder_from (builder, "audio");
+  gst_worker_builder_queue (builder, NULL, FALSE);
+  gst_worker_builder_link_to (builder, "mux", NULL);
+
+  INFO ("Recording pipeline\n----\n%s\n---", builder->desc->str);
 
-  g_string_append_printf (desc, "! tee name=result ");
-  g_string_append_printf (desc, "\n");
+  return TRUE;
+}
+
+/**
+ * @param split The splitmuxsink.
+ * @param fragment_id
+ * @param rec The GstRecorder instance.
+ * @memberof GstRecorder
+ * @return the file name for the next recording file
+ *
+ * Invoked by the splitmuxsink whenever it starts a new file.
+ */
+static gchar *
+gst_recorder_format_location (GstElement * split, guint fragment_id,
+    GstRecorder * rec)
+{
+  const gchar *template = gst_switch_server_get_record_filename ();
+  const gchar *suffix = rec->channel;
+  const gchar *filename;
+  gchar *named = NULL;
+
+  if (g_strcmp0 (GST_ELEMENT_NAME (split), "proxy_split") == 0)
+    suffix = "proxy";
+
+  // ISO and proxy recordings are named after the composite recording
+  if (suffix && template) {
+    gsize len = strlen (template);
+    if (g_str_has_suffix (template, ".mkv"))
+      len -= strlen (".mkv");
+    named = g_strdup_printf ("%.*s-%s%s", (gint) len, template, suffix,
+        template + len);
+    template = named;
+  }
+  filename = gst_recorder_new_filename (template);
+  g_free (named);
+
+  INFO ("Recording to %s", filename);
+  return (gchar *) filename;
+}
+
+/**
+ * @param rec The GstRecorder instance.
+ * @param split The splitmuxsink.
+ * @memberof GstRecorder
+ *
+ * Write the recording files from a RAM ring on a separate thread, so a
+ * slow disk can not hold back the encoder. Falls back to the filesink
+ * splitmuxsink uses by default if asyncfilesink is not available.
+ */
+static void
+gst_recorder_set_file_sink (GstRecorder * rec, GstElement * split)
+{
+  GstElement *sink;
 
-  if (filename) {
-    g_string_append_printf (desc, "result. ! queue max-size-buffers=1 "
-        "! filesink name=disk_sink sync=false location=\"%s\" ", filename);
-    g_free ((gpointer) filename);
+  if (opts.record_ring <= 0)
+    return;
+
+  sink = gst_element_factory_make ("asyncfilesink", NULL);
+  if (sink == NULL) {
+    WARN ("asyncfilesink not found, recording with filesink");
+    return;
+  }
+
+  g_object_set (sink, "ring-size", (guint) opts.record_ring,
+      "direct", opts.record_direct_io, NULL);
+  g_object_set (split, "sink", sink, NULL);
+}
+
+/**
+ * @param rec The GstRecorder instance.
+ * @param quality The encoder quality in percent.
+ * @memberof GstRecorder
+ *
+ * Scale the quality of the recording encoder, used to share the CPU
+ * between ISO recordings. Applies to a running encoder where possible.
+ */
+void
+gst_recorder_set_quality (GstRecorder * rec, gint quality)
+{
+  GstElement *encoder = NULL;
+
+  g_return_if_fail (GST_IS_RECORDER (rec));
+
+  quality = CLAMP (quality, GST_RECORDER_MIN_QUALITY, 100);
+  if (rec->quality == quality)
+    return;
+  rec->quality = quality;
+
+  if (GST_WORKER (rec)->pipeline)
+    encoder = gst_worker_get_element (GST_WORKER (rec), "encoder");
+  if (encoder) {
+    gst_recorder_update_encoder (rec, encoder);
+    gst_object_unref (encoder);
+  }
+}
+
+/**
+ * @param queue The leaky queue in front of the ISO encoder.
+ * @param rec The GstRecorder instance.
+ * @memberof GstRecorder
+ *
+ * Invoked from the streaming thread when the ISO encoder falls behind.
+ * Lowers the quality one step, at most once a second, until the next
+ * pipeline is built.
+ */
+static void
+gst_recorder_iso_overrun (GstElement * queue, GstRecorder * rec)
+{
+  gint64 now = g_get_monotonic_time ();
+  GstObject *bin;
+  GstElement *encoder = NULL;
+  gint penalty;
+
+  if (now - rec->last_overrun < G_USEC_PER_SEC)
+    return;
+  rec->last_overrun = now;
+
+  penalty = g_atomic_int_get (&rec->penalty);
+  if (penalty >= GST_RECORDER_MAX_PENALTY)
+    return;
+  g_atomic_int_set (&rec->penalty, penalty + GST_RECORDER_PENALTY_STEP);
+
+  WARN ("%s: encoder too slow, quality down to %d%%",
+      GST_WORKER (rec)->name,
+      MAX (rec->quality - penalty - GST_RECORDER_PENALTY_STEP,
+          GST_RECORDER_MIN_QUALITY));
+
+  bin = gst_object_get_parent (GST_OBJECT (queue));
+  if (bin) {
+    encoder = gst_bin_get_by_name (GST_BIN (bin), "encoder");
+    gst_object_unref (bin);
   }
+  if (encoder) {
+    gst_recorder_update_encoder (rec, encoder);
+    gst_object_unref (encoder);
+  }
+}
+
+/**
+ * @param rec The GstRecorder instance.
+ * @memberof GstRecorder
+ * @return TRUE if a new recording file was started.
+ *
+ * Finish the current recording file at the next keyframe and continue in
+ * a new one, without stopping the pipeline. The proxy recording is split
+ * along with it. Not possible if the encoder was changed since the
+ * pipeline was built.
+ */
+gboolean
+gst_recorder_split (GstRecorder * rec)
+{
+  GstElement *split = NULL;
+  GstElement *proxy_split = NULL;
+  gboolean result = FALSE;
+  gboolean changed;
 
-  g_string_append_printf (desc, "result. ! queue max-size-buffers=1 ! gdppay "
-      "! tcpserversink name=tcp_sink sync=false port=%d ", rec->sink_port);
+  g_return_val_if_fail (GST_IS_RECORDER (rec), FALSE);
 
-  INFO ("Recording pipeline\n----\n%s\n---", desc->str);
+  GST_RECORDER_LOCK_ENCODER (rec);
+  changed = rec->encoder_changed;
+  GST_RECORDER_UNLOCK_ENCODER (rec);
 
-  return desc;
+  if (GST_WORKER (rec)->pipeline && !changed) {
+    split = gst_worker_get_element (GST_WORKER (rec), "split");
+    proxy_split = gst_worker_get_element (GST_WORKER (rec), "proxy_split");
+  }
+  if (split) {
+    if (GST_STATE (split) == GST_STATE_PLAYING) {
+      g_signal_emit_by_name (split, "split-now");
+      result = TRUE;
+    }
+    gst_object_unref (split);
+  }
+  if (proxy_split) {
+    if (result)
+      g_signal_emit_by_name (proxy_split, "split-now");
+    gst_object_unref (proxy_split);
+  }
+  return result;
 }
 
 /**
@@ -353,6 +827,41 @@ gst_recorder_client_socket_removed (GstElement * element,
   g_socket_close (socket, NULL);
 }
 
+/**
+ * @param rec The GstRecorder instance.
+ * @param name The name of the splitmuxsink.
+ * @memberof GstRecorder
+ * @return FALSE if the splitmuxsink could not be set up.
+ *
+ * Set up the muxer, file sink and file names of a splitmuxsink, if the
+ * pipeline has one of that name.
+ */
+static gboolean
+gst_recorder_prepare_split (GstRecorder * rec, const gchar * name)
+{
+  GstElement *split = NULL;
+  GstElement *mux = NULL;
+
+  split = gst_worker_get_element_unlocked (GST_WORKER (rec), name);
+  if (!split)
+    return TRUE;
+
+  mux = gst_element_factory_make ("matroskamux", NULL);
+  if (mux == NULL) {
+    ERROR ("matroskamux not found");
+    gst_object_unref (split);
+    return FALSE;
+  }
+  g_object_set (mux, "writing-app", "gst-switch",
+      "min-index-interval", (guint64) 1000000, NULL);
+  g_object_set (split, "muxer", mux, NULL);
+  gst_recorder_set_file_sink (rec, split);
+  gst_worker_connect_element (GST_WORKER (rec), split, "format-location",
+      G_CALLBACK (gst_recorder_format_location), rec);
+  gst_object_unref (split);
+  return TRUE;
+}
+
 /**
  * @param rec The GstRecorder instance.
  * @memberof GstRecorder
@@ -367,16 +876,33 @@ gst_recorder_prepare (GstRecorder * rec)
 
   g_return_val_if_fail (GST_IS_RECORDER (rec), FALSE);
 
+  if (!gst_recorder_prepare_split (rec, "split") ||
+      !gst_recorder_prepare_split (rec, "proxy_split"))
+    return FALSE;
+
+  if (rec->channel) {
+    GstElement *queue =
+        gst_worker_get_element_unlocked (GST_WORKER (rec), "iso_queue");
+    g_return_val_if_fail (GST_IS_ELEMENT (queue), FALSE);
+    gst_worker_connect_element (GST_WORKER (rec), queue, "overrun",
+        G_CALLBACK (gst_recorder_iso_overrun), rec);
+    gst_object_unref (queue);
+    return TRUE;
+  }
+
   tcp_sink = gst_worker_get_element_unlocked (GST_WORKER (rec), "tcp_sink");
 
   g_return_val_if_fail (GST_IS_ELEMENT (tcp_sink), FALSE);
 
-  g_signal_connect (tcp_sink, "client-added",
+  gst_worker_connect_element (GST_WORKER (rec), tcp_sink, "client-added",
       G_CALLBACK (gst_recorder_client_socket_added), rec);
 
-  g_signal_connect (tcp_sink, "client-socket-removed",
+  gst_worker_connect_element (GST_WORKER (rec), tcp_sink,
+      "client-socket-removed",
       G_CALLBACK (gst_recorder_client_socket_removed), rec);
 
+  gst_sink_policy_apply (tcp_sink, GST_WORKER (rec)->name, TRUE);
+
   gst_object_unref (tcp_sink);
   return TRUE;
 }
@@ -429,7 +955,29 @@ gst_recorder_class_init (GstRecorderClass * klass)
           gst_composite_default_height (),
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (object_class, PROP_ENCODER,
+      g_param_spec_string ("encoder", "Video Encoder",
+          "Video encoder spec used for new recordings",
+          GST_RECORDER_DEFAULT_ENCODER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_CHANNEL,
+      g_param_spec_string ("channel", "Channel",
+          "Input channel for an ISO recording, NULL for the composite",
+          NULL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_PROXY_HEIGHT,
+      g_param_spec_uint ("proxy-height", "Proxy Height",
+          "Height of the proxy recording, 0 for no proxy",
+          0, G_MAXINT, 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_PROXY_ENCODER,
+      g_param_spec_string ("proxy-encoder", "Proxy Encoder",
+          "Video encoder spec used for the proxy recording",
+          GST_RECORDER_DEFAULT_PROXY_ENCODER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   worker_class->prepare = (GstWorkerPrepareFunc) gst_recorder_prepare;
-  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
-      gst_recorder_get_pipeline_string;
+  worker_class->build_pipeline = (GstWorkerBuildPipelineFunc)
+      gst_recorder_build_pipeline;
 }
@@ -24,8 +24,13 @@
 
 #include "gstworker.h"
 #include "gstcomposite.h"
+#include "gstswitchopts.h"
 #include <gio/gio.h>
 
+#define GST_RECORDER_DEFAULT_ENCODER "mjpeg:quality=100"
+#define GST_RECORDER_DEFAULT_ISO_ENCODER "mjpeg:quality=80"
+#define GST_RECORDER_DEFAULT_PROXY_ENCODER "h264:preset=ultrafast,bitrate=1000,threads=1"
+
 #define GST_TYPE_RECORDER (gst_recorder_get_type ())
 #define GST_RECORDER(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_RECORDER, GstRecorder))
 #define GST_RECORDER_CLASS(class) (G_TYPE_CHECK_CLASS_CAST ((class), GST_TYPE_RECORDER, GstRecorderClass))
@@ -38,6 +43,11 @@ typedef struct _GstRecorderClass GstRecorderClass;
  *  @class GstRecorder
  *  @struct _GstRecorder
  *  @brief Recorder for recording composite result.
+ *
+ *  With a channel set it records that input channel on its own (ISO
+ *  recording) at a quality that is lowered before it can compete with the
+ *  composite recording for CPU. With a proxy height set the composite is
+ *  also recorded at that height with a cheap encoder, for editing.
  */
 struct _GstRecorder
 {
@@ -48,6 +58,20 @@ struct _GstRecorder
   guint height;                 /*!< the video height */
 
   GstCompositeMode mode;        /*!< the composite mode which is the same as in GstComposite */
+
+  GMutex encoder_lock;          /*!< Mutex for the encoder specs */
+  gchar *encoder_spec;          /*!< the video encoder spec, see parse_encoder() */
+  GstSwitchEncoder encoder;     /*!< the parsed video encoder */
+  gboolean encoder_changed;     /*!< the pipeline uses an older encoder */
+
+  gchar *channel;               /*!< the input channel of an ISO recording */
+  gint quality;                 /*!< the encoder quality in percent */
+  gint penalty;                 /*!< quality lost to encoder overruns */
+  gint64 last_overrun;          /*!< time of the last quality step down */
+
+  guint proxy_height;           /*!< the proxy recording height, 0 for none */
+  gchar *proxy_encoder_spec;    /*!< the proxy encoder spec, see parse_encoder() */
+  GstSwitchEncoder proxy_encoder;       /*!< the parsed proxy encoder */
 };
 
 /**
@@ -66,4 +90,7 @@ struct _GstRecorderClass
  */
 GType gst_recorder_get_type (void);
 
+gboolean gst_recorder_split (GstRecorder * rec);
+void gst_recorder_set_quality (GstRecorder * rec, gint quality);
+
 #endif //__GST_RECORDER_H__
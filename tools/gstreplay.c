@@ -0,0 +1,703 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include "gstswitchserver.h"
+#include "gstcomposite.h"
+#include "gstreplay.h"
+
+enum
+{
+  PROP_0,
+  PROP_CHANNEL,
+  PROP_WIDTH,
+  PROP_HEIGHT,
+  PROP_SECONDS,
+  PROP_SIZE,
+  PROP_ENCODER,
+};
+
+/**
+ * @brief A replay being saved or played back.
+ *
+ * The frames are copied out of the ring when the job is created, so the
+ * ring keeps recording while the job runs.
+ */
+typedef struct _GstReplayJob
+{
+  GPtrArray *buffers;
+  GstCaps *caps;
+  gchar *location;
+  gchar *host;
+  gint port;
+} GstReplayJob;
+
+#define parent_class gst_replay_parent_class
+
+G_DEFINE_TYPE (GstReplay, gst_replay, GST_TYPE_WORKER);
+
+/**
+ * @brief Initialize the GstReplay instance.
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ */
+static void
+gst_replay_init (GstReplay * replay)
+{
+  replay->channel = g_strdup ("composite_video");
+  GST_WORKER (replay)->task_class = "output";
+  GST_WORKER (replay)->priority = GST_WORKER_PRIORITY_PROGRAM;
+  replay->width = 0;
+  replay->height = 0;
+  replay->seconds = 10;
+  replay->size = 256;
+  replay->encoder_spec = g_strdup (GST_REPLAY_DEFAULT_ENCODER);
+  parse_encoder (replay->encoder_spec, &replay->encoder, NULL);
+
+  g_mutex_init (&replay->ring_lock);
+  replay->caps = NULL;
+  replay->ring = NULL;
+  replay->frames = NULL;
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ *
+ * Destroying the GstReplay instance.
+ *
+ * @see GObject
+ */
+static void
+gst_replay_finalize (GstReplay * replay)
+{
+  g_free (replay->channel);
+  g_free (replay->encoder_spec);
+  g_free (replay->ring);
+  g_free (replay->frames);
+  if (replay->caps)
+    gst_caps_unref (replay->caps);
+  g_mutex_clear (&replay->ring_lock);
+
+  if (G_OBJECT_CLASS (parent_class)->finalize)
+    (*G_OBJECT_CLASS (parent_class)->finalize) (G_OBJECT (replay));
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstReplay
+ *
+ * Fetching the GstReplay property.
+ *
+ * @see GObject
+ */
+static void
+gst_replay_get_property (GstReplay * replay, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_CHANNEL:
+      g_value_set_string (value, replay->channel);
+      break;
+    case PROP_WIDTH:
+      g_value_set_uint (value, replay->width);
+      break;
+    case PROP_HEIGHT:
+      g_value_set_uint (value, replay->height);
+      break;
+    case PROP_SECONDS:
+      g_value_set_uint (value, replay->seconds);
+      break;
+    case PROP_SIZE:
+      g_value_set_uint (value, replay->size);
+      break;
+    case PROP_ENCODER:
+      g_value_set_string (value, replay->encoder_spec);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (replay, property_id, pspec);
+      break;
+  }
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @param property_id
+ * @param value
+ * @param pspec
+ * @memberof GstReplay
+ *
+ * Changing the GstReplay properties. The ring size is fixed once the
+ * ring is allocated.
+ *
+ * @see GObject
+ */
+static void
+gst_replay_set_property (GstReplay * replay, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  switch (property_id) {
+    case PROP_CHANNEL:
+      g_free (replay->channel);
+      replay->channel = g_value_dup_string (value);
+      break;
+    case PROP_WIDTH:
+      replay->width = g_value_get_uint (value);
+      break;
+    case PROP_HEIGHT:
+      replay->height = g_value_get_uint (value);
+      break;
+    case PROP_SECONDS:
+      replay->seconds = g_value_get_uint (value);
+      break;
+    case PROP_SIZE:
+      replay->size = g_value_get_uint (value);
+      break;
+    case PROP_ENCODER:
+    {
+      const gchar *spec = g_value_get_string (value);
+      if (parse_encoder (spec, &replay->encoder, NULL) == 0) {
+        g_free (replay->encoder_spec);
+        replay->encoder_spec = g_strdup (spec);
+      } else {
+        WARN ("invalid replay encoder: %s", spec);
+      }
+    }
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (G_OBJECT (replay), property_id,
+          pspec);
+      break;
+  }
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @param builder The builder.
+ * @memberof GstReplay
+ * @return TRUE if the replay pipeline was built
+ *
+ * Building the replay pipeline invoked by the GstWorker.
+ */
+static gboolean
+gst_replay_build_pipeline (GstReplay * replay, GstWorkerBuilder * builder)
+{
+  gst_worker_builder_inter (builder, "intervideosrc", "source",
+      replay->channel);
+  gst_worker_builder_caps (builder, "video/x-raw,width=%d,height=%d",
+      replay->width, replay->height);
+  if (gst_worker_builder_add (builder, "queue", NULL, NULL)) {
+    gst_worker_builder_set_arg (builder, "leaky", "downstream");
+    gst_worker_builder_set (builder, "max-size-buffers", (guint) 2,
+        "max-size-bytes", (guint) 0, "max-size-time", (guint64) 0, NULL);
+  }
+  gst_worker_builder_encoder (builder, &replay->encoder, NULL);
+  gst_worker_builder_add (builder, "appsink", "sink",
+      "emit-signals", TRUE, "sync", FALSE, "max-buffers", (guint) 2,
+      "drop", TRUE, NULL);
+
+  INFO ("Replay pipeline\n----\n%s\n---", builder->desc->str);
+  return TRUE;
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @param data The frame data.
+ * @param size The frame size.
+ * @param buffer The frame buffer for the timestamps and flags.
+ * @memberof GstReplay
+ *
+ * Copy a frame into the ring, evicting the frames it overwrites and the
+ * frames that are too old. Must be called with the ring lock held.
+ */
+static void
+gst_replay_append (GstReplay * replay, const guint8 * data, gsize size,
+    GstBuffer * buffer)
+{
+  GstClockTime pts = GST_BUFFER_PTS (buffer);
+  GstClockTime keep = (GstClockTime) replay->seconds * GST_SECOND;
+  GstReplayFrame *frame;
+  gsize index, first;
+
+  if (size > replay->ring_bytes)
+    return;
+
+  while (replay->frame_tail < replay->frame_head) {
+    frame = &replay->frames[replay->frame_tail % replay->max_frames];
+    if (frame->offset + replay->ring_bytes >= replay->ring_head + size &&
+        replay->frame_head - replay->frame_tail < replay->max_frames &&
+        !(GST_CLOCK_TIME_IS_VALID (pts) && frame->pts + keep < pts))
+      break;
+    replay->frame_tail += 1;
+  }
+
+  index = replay->ring_head % replay->ring_bytes;
+  first = MIN (size, replay->ring_bytes - index);
+  memcpy (replay->ring + index, data, first);
+  memcpy (replay->ring, data + first, size - first);
+
+  frame = &replay->frames[replay->frame_head % replay->max_frames];
+  frame->offset = replay->ring_head;
+  frame->size = size;
+  frame->pts = pts;
+  frame->duration = GST_BUFFER_DURATION (buffer);
+  frame->keyframe =
+      !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  replay->ring_head += size;
+  replay->frame_head += 1;
+}
+
+/**
+ * @param sink The appsink.
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ * @return GST_FLOW_OK
+ *
+ * Invoked from the streaming thread for every new frame.
+ */
+static GstFlowReturn
+gst_replay_new_sample (GstElement * sink, GstReplay * replay)
+{
+  GstSample *sample = NULL;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  GstMapInfo info;
+
+  g_signal_emit_by_name (sink, "pull-sample", &sample);
+  if (sample == NULL)
+    return GST_FLOW_OK;
+
+  buffer = gst_sample_get_buffer (sample);
+  caps = gst_sample_get_caps (sample);
+  if (buffer && gst_buffer_map (buffer, &info, GST_MAP_READ)) {
+    g_mutex_lock (&replay->ring_lock);
+    if (caps && (replay->caps == NULL || !gst_caps_is_equal (caps,
+                replay->caps))) {
+      // Frames of different formats can't be replayed together
+      gst_caps_replace (&replay->caps, caps);
+      replay->frame_tail = replay->frame_head;
+    }
+    gst_replay_append (replay, info.data, info.size, buffer);
+    g_mutex_unlock (&replay->ring_lock);
+    gst_buffer_unmap (buffer, &info);
+  }
+
+  gst_sample_unref (sample);
+  return GST_FLOW_OK;
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @memberof GstReplay
+ * @return TRUE indicating the replay is prepared, FALSE otherwise.
+ *
+ * Invoked when the GstWorker is preparing the pipeline. The ring is
+ * allocated here once and kept across pipeline restarts.
+ */
+static gboolean
+gst_replay_prepare (GstReplay * replay)
+{
+  GstElement *sink;
+
+  g_return_val_if_fail (GST_IS_REPLAY (replay), FALSE);
+
+  g_mutex_lock (&replay->ring_lock);
+  if (replay->ring == NULL) {
+    replay->ring_bytes = (gsize) replay->size * 1024 * 1024;
+    replay->ring = g_malloc (replay->ring_bytes);
+    // Touch every page now rather than while recording
+    memset (replay->ring, 0, replay->ring_bytes);
+    replay->max_frames = MAX (replay->seconds, 1) * GST_REPLAY_MAX_FPS;
+    replay->frames = g_new0 (GstReplayFrame, replay->max_frames);
+    replay->ring_head = 0;
+    replay->frame_head = replay->frame_tail = 0;
+    INFO ("%s: keeping %d seconds of %s in %d MB",
+        GST_WORKER (replay)->name, replay->seconds, replay->channel,
+        replay->size);
+  }
+  g_mutex_unlock (&replay->ring_lock);
+
+  sink = gst_worker_get_element_unlocked (GST_WORKER (replay), "sink");
+  g_return_val_if_fail (GST_IS_ELEMENT (sink), FALSE);
+
+  gst_worker_connect_element (GST_WORKER (replay), sink, "new-sample",
+      G_CALLBACK (gst_replay_new_sample), replay);
+
+  gst_object_unref (sink);
+  return TRUE;
+}
+
+static void
+gst_replay_job_free (GstReplayJob * job)
+{
+  g_ptr_array_free (job->buffers, TRUE);
+  gst_caps_unref (job->caps);
+  g_free (job->location);
+  g_free (job->host);
+  g_free (job);
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @param start The start of the range, in milliseconds before the newest frame.
+ * @param end The end of the range, in milliseconds before the newest frame.
+ * @memberof GstReplay
+ * @return A new job holding copies of the frames, or NULL if there are none.
+ *
+ * The range starts at a keyframe so it can be decoded, the one before the
+ * start or else the first one in range, and the timestamps start from
+ * zero. Only the index is read under the ring lock, the frame data is
+ * copied without it and frames overwritten meanwhile are left out.
+ */
+static GstReplayJob *
+gst_replay_new_job (GstReplay * replay, gint start, gint end)
+{
+  GstReplayJob *job = NULL;
+  GstReplayFrame *frame, *frames = NULL;
+  GstClockTime newest, from, to, base;
+  GstCaps *caps = NULL;
+  guint64 n, first = G_MAXUINT64, head;
+  guint count = 0, i, kept;
+
+  g_mutex_lock (&replay->ring_lock);
+  if (replay->frame_tail == replay->frame_head || replay->caps == NULL)
+    goto unlock;
+
+  newest = replay->frames[(replay->frame_head - 1) % replay->max_frames].pts;
+  if (!GST_CLOCK_TIME_IS_VALID (newest))
+    goto unlock;
+  from = newest - MIN ((GstClockTime) MAX (start, 0) * GST_MSECOND, newest);
+  to = newest - MIN ((GstClockTime) MAX (end, 0) * GST_MSECOND, newest);
+
+  // The keyframe before the first frame in range, or the next one after it
+  for (n = replay->frame_tail; n < replay->frame_head; ++n) {
+    frame = &replay->frames[n % replay->max_frames];
+    if (frame->keyframe && (frame->pts <= from || first == G_MAXUINT64))
+      first = n;
+    if (frame->pts >= from && first != G_MAXUINT64)
+      break;
+  }
+  if (first == G_MAXUINT64)
+    goto unlock;
+
+  frames = g_new (GstReplayFrame, replay->frame_head - first);
+  for (n = first; n < replay->frame_head; ++n) {
+    frame = &replay->frames[n % replay->max_frames];
+    if (frame->pts > to)
+      break;
+    frames[count++] = *frame;
+  }
+  caps = gst_caps_ref (replay->caps);
+
+unlock:
+  g_mutex_unlock (&replay->ring_lock);
+  if (count == 0)
+    goto end;
+
+  job = g_new0 (GstReplayJob, 1);
+  job->buffers = g_ptr_array_new_with_free_func
+      ((GDestroyNotify) gst_buffer_unref);
+  job->caps = gst_caps_ref (caps);
+
+  for (i = 0; i < count; ++i) {
+    GstBuffer *buffer;
+    gsize index, part;
+
+    frame = &frames[i];
+    index = frame->offset % replay->ring_bytes;
+    part = MIN (frame->size, replay->ring_bytes - index);
+    buffer = gst_buffer_new_allocate (NULL, frame->size, NULL);
+    gst_buffer_fill (buffer, 0, replay->ring + index, part);
+    gst_buffer_fill (buffer, part, replay->ring, frame->size - part);
+    g_ptr_array_add (job->buffers, buffer);
+  }
+
+  // The ring kept recording during the copy, drop the frames it reached
+  // and start again from a keyframe
+  g_mutex_lock (&replay->ring_lock);
+  head = replay->ring_head;
+  g_mutex_unlock (&replay->ring_lock);
+
+  for (kept = 0; kept < count; ++kept) {
+    frame = &frames[kept];
+    if (frame->offset + replay->ring_bytes >= head && frame->keyframe)
+      break;
+  }
+  if (kept == count) {
+    gst_replay_job_free (job);
+    job = NULL;
+    goto end;
+  }
+  g_ptr_array_remove_range (job->buffers, 0, kept);
+
+  base = frames[kept].pts;
+  for (i = kept; i < count; ++i) {
+    GstBuffer *buffer = g_ptr_array_index (job->buffers, i - kept);
+
+    frame = &frames[i];
+    GST_BUFFER_PTS (buffer) = frame->pts - base;
+    GST_BUFFER_DURATION (buffer) = frame->duration;
+    if (!frame->keyframe)
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+  }
+
+end:
+  g_free (frames);
+  if (caps)
+    gst_caps_unref (caps);
+  return job;
+}
+
+/**
+ * @brief Feed the copied frames to the job pipeline, then end the stream.
+ */
+static void
+gst_replay_job_need_data (GstElement * source, guint length,
+    GstReplayJob * job)
+{
+  GstFlowReturn ret;
+  guint n;
+
+  for (n = 0; n < job->buffers->len; ++n) {
+    GstBuffer *buffer = g_ptr_array_index (job->buffers, n);
+    g_signal_emit_by_name (source, "push-buffer", buffer, &ret);
+    if (ret != GST_FLOW_OK)
+      break;
+  }
+  g_ptr_array_set_size (job->buffers, 0);
+  g_signal_emit_by_name (source, "end-of-stream", &ret);
+}
+
+static void
+gst_replay_job_prepare (GstWorker * worker, GstReplayJob * job)
+{
+  GstElement *source = gst_worker_get_element_unlocked (worker, "source");
+
+  g_return_if_fail (GST_IS_ELEMENT (source));
+
+  g_object_set (source, "caps", job->caps, NULL);
+  gst_worker_connect_element (worker, source, "need-data",
+      G_CALLBACK (gst_replay_job_need_data), job);
+  gst_object_unref (source);
+}
+
+static void
+gst_replay_job_end (GstWorker * worker, GstReplayJob * job)
+{
+  INFO ("%s finished", worker->name);
+  gst_replay_job_free (job);
+  g_object_unref (worker);
+}
+
+static void
+gst_replay_add_job_source (GstWorkerBuilder * builder)
+{
+  if (gst_worker_builder_add (builder, "appsrc", "source", NULL))
+    gst_worker_builder_set_arg (builder, "format", "time");
+}
+
+static gboolean
+gst_replay_build_save (GstWorker * worker, GstWorkerBuilder * builder,
+    GstReplayJob * job)
+{
+  gst_replay_add_job_source (builder);
+  gst_worker_builder_add (builder, "matroskamux", NULL,
+      "writing-app", "gst-switch", NULL);
+  gst_worker_builder_add (builder, "filesink", NULL,
+      "location", job->location, NULL);
+  return TRUE;
+}
+
+static gboolean
+gst_replay_build_play (GstWorker * worker, GstWorkerBuilder * builder,
+    GstReplayJob * job)
+{
+  // Played back like any other video input of the server
+  gst_replay_add_job_source (builder);
+  gst_worker_builder_add (builder, "decodebin", NULL, NULL);
+  gst_worker_builder_add (builder, "videoconvert", NULL, NULL);
+  gst_worker_builder_add (builder, "videoscale", NULL, NULL);
+  gst_worker_builder_add (builder, "videorate", NULL, NULL);
+  gst_worker_builder_caps (builder, "%s",
+      gst_switch_server_get_video_caps_str ());
+  gst_worker_builder_add (builder, "gdppay", NULL, NULL);
+  gst_worker_builder_add (builder, "tcpclientsink", NULL,
+      "host", job->host, "port", (gint) job->port, NULL);
+  return TRUE;
+}
+
+static gboolean
+gst_replay_start_job (GstReplay * replay, GstReplayJob * job,
+    const gchar * what, GstWorkerBuildPipeline build_func)
+{
+  GstWorker *worker;
+  gchar *name;
+
+  name = g_strdup_printf ("%s-%s", GST_WORKER (replay)->name, what);
+  worker = GST_WORKER (g_object_new (GST_TYPE_WORKER, "name", name, NULL));
+  g_free (name);
+
+  worker->build_func_data = job;
+  worker->build_func = build_func;
+
+  g_signal_connect (worker, "prepare-worker",
+      G_CALLBACK (gst_replay_job_prepare), job);
+  g_signal_connect (worker, "end-worker",
+      G_CALLBACK (gst_replay_job_end), job);
+
+  INFO ("%s: %s %d frames", GST_WORKER (replay)->name, what,
+      job->buffers->len);
+
+  if (!gst_worker_start (worker)) {
+    ERROR ("failed to start %s", worker->name);
+    g_signal_handlers_disconnect_by_data (worker, job);
+    gst_replay_job_free (job);
+    g_object_unref (worker);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @param start The start of the range, in milliseconds before now.
+ * @param end The end of the range, in milliseconds before now.
+ * @param filename The file to write.
+ * @memberof GstReplay
+ * @return TRUE if saving was started.
+ *
+ * Save a range of the ring into a Matroska file.
+ */
+gboolean
+gst_replay_save (GstReplay * replay, gint start, gint end,
+    const gchar * filename)
+{
+  GstReplayJob *job;
+
+  g_return_val_if_fail (GST_IS_REPLAY (replay), FALSE);
+
+  if (filename == NULL || filename[0] == '\0')
+    return FALSE;
+
+  job = gst_replay_new_job (replay, start, end);
+  if (job == NULL)
+    return FALSE;
+
+  job->location = g_strdup (filename);
+  return gst_replay_start_job (replay, job, "save",
+      (GstWorkerBuildPipeline) gst_replay_build_save);
+}
+
+/**
+ * @param replay The GstReplay instance.
+ * @param start The start of the range, in milliseconds before now.
+ * @param end The end of the range, in milliseconds before now.
+ * @param host The host of the video input port.
+ * @param port The video input port.
+ * @memberof GstReplay
+ * @return TRUE if the playback was started.
+ *
+ * Play a range of the ring back in real time into the video input port,
+ * where it shows up as a new input that ends with the replay.
+ */
+gboolean
+gst_replay_play (GstReplay * replay, gint start, gint end,
+    const gchar * host, gint port)
+{
+  GstReplayJob *job;
+
+  g_return_val_if_fail (GST_IS_REPLAY (replay), FALSE);
+
+  job = gst_replay_new_job (replay, start, end);
+  if (job == NULL)
+    return FALSE;
+
+  job->host = g_strdup (host);
+  job->port = port;
+  return gst_replay_start_job (replay, job, "play",
+      (GstWorkerBuildPipeline) gst_replay_build_play);
+}
+
+/**
+ * @brief Initialize the GstReplayClass.
+ * @param klass The GstReplayClass instance.
+ * @memberof GstReplayClass
+ */
+static void
+gst_replay_class_init (GstReplayClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstWorkerClass *worker_class = GST_WORKER_CLASS (klass);
+
+  object_class->finalize = (GObjectFinalizeFunc) gst_replay_finalize;
+  object_class->set_property =
+      (GObjectSetPropertyFunc) gst_replay_set_property;
+  object_class->get_property =
+      (GObjectGetPropertyFunc) gst_replay_get_property;
+
+  g_object_class_install_property (object_class, PROP_CHANNEL,
+      g_param_spec_string ("channel", "Channel",
+          "The intervideo channel to keep", "composite_video",
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_WIDTH,
+      g_param_spec_uint ("width", "Input Width",
+          "Input video frame width",
+          1, G_MAXINT,
+          gst_composite_default_width (),
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_HEIGHT,
+      g_param_spec_uint ("height",
+          "Input Height",
+          "Input video frame height",
+          1, G_MAXINT,
+          gst_composite_default_height (),
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_SECONDS,
+      g_param_spec_uint ("seconds", "Seconds",
+          "Seconds of video to keep", 1, 3600, 10,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_SIZE,
+      g_param_spec_uint ("size", "Size",
+          "Size of the ring in MB", 1, 65536, 256,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, PROP_ENCODER,
+      g_param_spec_string ("encoder", "Video Encoder",
+          "Video encoder spec for the frames in the ring",
+          GST_REPLAY_DEFAULT_ENCODER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  worker_class->prepare = (GstWorkerPrepareFunc) gst_replay_prepare;
+  worker_class->build_pipeline = (GstWorkerBuildPipelineFunc)
+      gst_replay_build_pipeline;
+}
@@ -0,0 +1,109 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_REPLAY_H__
+#define __GST_REPLAY_H__
+
+#include "gstworker.h"
+#include "gstswitchopts.h"
+
+#define GST_REPLAY_DEFAULT_ENCODER "mjpeg:quality=90"
+#define GST_REPLAY_MAX_FPS 60
+
+#define GST_TYPE_REPLAY (gst_replay_get_type ())
+#define GST_REPLAY(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_REPLAY, GstReplay))
+#define GST_REPLAY_CLASS(class) (G_TYPE_CHECK_CLASS_CAST ((class), GST_TYPE_REPLAY, GstReplayClass))
+#define GST_IS_REPLAY(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_REPLAY))
+#define GST_IS_REPLAY_CLASS(class) (G_TYPE_CHECK_CLASS_TYPE ((class), GST_TYPE_REPLAY))
+
+typedef struct _GstReplay GstReplay;
+typedef struct _GstReplayClass GstReplayClass;
+
+/**
+ *  @brief A frame held in the replay ring.
+ *  @param offset the ring position of the first byte, counted from start
+ *  @param size the frame size in bytes
+ *  @param pts the frame timestamp
+ *  @param duration the frame duration
+ *  @param keyframe TRUE if decoding can start at this frame
+ */
+typedef struct _GstReplayFrame
+{
+  guint64 offset;
+  gsize size;
+  GstClockTime pts;
+  GstClockTime duration;
+  gboolean keyframe;
+} GstReplayFrame;
+
+/**
+ *  @class GstReplay
+ *  @struct _GstReplay
+ *  @brief Keeps the last seconds of a channel in memory for replays.
+ *
+ *  The ring and its frame index are allocated once, frames are copied in
+ *  and evicted by age or when their bytes are overwritten.
+ */
+struct _GstReplay
+{
+  GstWorker base;               /*!< the parent object */
+
+  gchar *channel;               /*!< the intervideo channel to keep */
+  guint width;                  /*!< the video width */
+  guint height;                 /*!< the video height */
+  guint seconds;                /*!< how much to keep */
+  guint size;                   /*!< the ring size in MB */
+  gchar *encoder_spec;          /*!< the video encoder spec, see parse_encoder() */
+  GstSwitchEncoder encoder;     /*!< the parsed video encoder */
+
+  GMutex ring_lock;             /*!< lock for the ring and index */
+  GstCaps *caps;                /*!< the caps of the frames in the ring */
+  guint8 *ring;                 /*!< the frame data */
+  gsize ring_bytes;             /*!< the ring size in bytes */
+  guint64 ring_head;            /*!< bytes written to the ring so far */
+  GstReplayFrame *frames;       /*!< the frame index */
+  guint max_frames;             /*!< the frame index size */
+  guint64 frame_head;           /*!< frames written so far */
+  guint64 frame_tail;           /*!< the oldest frame still held */
+};
+
+/**
+ *  @class GstReplayClass
+ *  @struct _GstReplayClass
+ *  @brief The class of GstReplay.
+ */
+struct _GstReplayClass
+{
+  GstWorkerClass base_class;    /*!< The base class. */
+};
+
+/**
+ *  @internal Use GST_TYPE_REPLAY instead.
+ *  @see GST_TYPE_REPLAY
+ */
+GType gst_replay_get_type (void);
+
+gboolean gst_replay_save (GstReplay * replay, gint start, gint end,
+    const gchar * filename);
+gboolean gst_replay_play (GstReplay * replay, gint start, gint end,
+    const gchar * host, gint port);
+
+#endif //__GST_REPLAY_H__
@@ -0,0 +1,358 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gio/gio.h>
+#include "gstswitchserver.h"
+#include "gstsinkpolicy.h"
+
+#define GST_SINK_POLICY_DATA "gst-switch-sink-policy"
+#define GST_SINK_POLICY_POLL_INTERVAL 50        /* ms */
+#define GST_SINK_POLICY_POLL_TIMEOUT (10 * G_USEC_PER_SEC)
+
+/* From GstSyncMethod in gstmultihandlesink.h */
+enum
+{
+  SYNC_METHOD_LATEST_KEYFRAME = 2,
+  SYNC_METHOD_BURST = 3,
+};
+
+/* From GstRecoverPolicy in gstmultihandlesink.h */
+enum
+{
+  RECOVER_POLICY_RESYNC_SOFT_LIMIT = 2,
+  RECOVER_POLICY_RESYNC_KEYFRAME = 3,
+};
+
+/* From GstClientStatus in gstmultihandlesink.h */
+enum
+{
+  CLIENT_STATUS_SLOW = 3,
+};
+
+typedef struct _GstSinkPolicy
+{
+  gchar *label;
+  GstElement *sink;
+  GMutex lock;
+  GstSinkPolicyStats stats;
+  GList *pending;               /* clients waiting for a first frame */
+  guint poll_id;
+} GstSinkPolicy;
+
+typedef struct _GstSinkPolicyClient
+{
+  GstSinkPolicy *policy;
+  GstElement *sink;
+  GSocket *socket;
+  gint64 connect_time;
+} GstSinkPolicyClient;
+
+static void
+gst_sink_policy_client_free (GstSinkPolicyClient * client)
+{
+  gst_object_unref (client->sink);
+  g_object_unref (client->socket);
+  g_free (client);
+}
+
+static void
+gst_sink_policy_free (GstSinkPolicy * policy)
+{
+  if (policy->poll_id)
+    g_source_remove (policy->poll_id);
+  g_list_free_full (policy->pending,
+      (GDestroyNotify) gst_sink_policy_client_free);
+  g_mutex_clear (&policy->lock);
+  g_free (policy->label);
+  g_free (policy);
+}
+
+/**
+ * @brief Check if the first bytes went out to a client.
+ * @return TRUE once the client got them, is gone or timed out.
+ *
+ * tcpserversink has no per-client "first buffer" signal, so bytes-sent is
+ * read from get-stats.
+ */
+static gboolean
+gst_sink_policy_check_first_frame (GstSinkPolicyClient * client)
+{
+  GstSinkPolicy *policy = client->policy;
+  GstStructure *stats = NULL;
+  guint64 bytes_sent = 0;
+  gint64 now = g_get_monotonic_time ();
+  gint64 ttff = now - client->connect_time;
+
+  g_signal_emit_by_name (client->sink, "get-stats", client->socket, &stats);
+  if (stats == NULL || !gst_structure_has_field (stats, "bytes-sent")) {
+    /* client is gone */
+    if (stats)
+      gst_structure_free (stats);
+    return TRUE;
+  }
+
+  gst_structure_get_uint64 (stats, "bytes-sent", &bytes_sent);
+  gst_structure_free (stats);
+
+  if (bytes_sent == 0) {
+    if (ttff < GST_SINK_POLICY_POLL_TIMEOUT)
+      return FALSE;
+    WARN ("%s: client %d got nothing in %d seconds", policy->label,
+        g_socket_get_fd (client->socket),
+        (gint) (ttff / G_USEC_PER_SEC));
+    return TRUE;
+  }
+
+  g_mutex_lock (&policy->lock);
+  policy->stats.first_frames += 1;
+  policy->stats.ttff_last = ttff;
+  policy->stats.ttff_total += ttff;
+  if (policy->stats.ttff_max < ttff)
+    policy->stats.ttff_max = ttff;
+  g_mutex_unlock (&policy->lock);
+
+  INFO ("%s: client %d first frame after %.1f ms", policy->label,
+      g_socket_get_fd (client->socket), ttff / 1000.0);
+  return TRUE;
+}
+
+/**
+ * @brief Poll the clients of a sink waiting for their first frame.
+ *
+ * One timer per sink runs only while clients are waiting, at a coarse
+ * interval which bounds the precision of the measured times. get-stats
+ * takes the sink's client lock, so it is not called with the policy
+ * lock held.
+ */
+static gboolean
+gst_sink_policy_poll_first_frames (GstSinkPolicy * policy)
+{
+  GstElement *sink = gst_object_ref (policy->sink);
+  GList *pending, *item, *waiting = NULL;
+  gboolean again;
+
+  g_mutex_lock (&policy->lock);
+  pending = policy->pending;
+  policy->pending = NULL;
+  g_mutex_unlock (&policy->lock);
+
+  for (item = pending; item; item = g_list_next (item)) {
+    if (gst_sink_policy_check_first_frame (item->data))
+      gst_sink_policy_client_free (item->data);
+    else
+      waiting = g_list_prepend (waiting, item->data);
+  }
+  g_list_free (pending);
+
+  g_mutex_lock (&policy->lock);
+  policy->pending = g_list_concat (policy->pending, g_list_reverse (waiting));
+  again = policy->pending != NULL;
+  if (!again)
+    policy->poll_id = 0;
+  g_mutex_unlock (&policy->lock);
+
+  gst_object_unref (sink);
+  return again ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+static void
+gst_sink_policy_client_added (GstElement * sink, GObject * socket,
+    GstSinkPolicy * policy)
+{
+  GstSinkPolicyClient *client;
+
+  g_return_if_fail (G_IS_SOCKET (socket));
+
+  client = g_new0 (GstSinkPolicyClient, 1);
+  client->policy = policy;
+  client->sink = gst_object_ref (sink);
+  client->socket = g_object_ref (socket);
+  client->connect_time = g_get_monotonic_time ();
+
+  g_mutex_lock (&policy->lock);
+  policy->stats.clients += 1;
+  policy->pending = g_list_append (policy->pending, client);
+  if (policy->poll_id == 0) {
+    policy->poll_id = g_timeout_add (GST_SINK_POLICY_POLL_INTERVAL,
+        (GSourceFunc) gst_sink_policy_poll_first_frames, policy);
+  }
+  g_mutex_unlock (&policy->lock);
+}
+
+/**
+ * @brief Record the drop counters of a client going away.
+ *
+ * Emitted before the client is freed, so get-stats still works here.
+ */
+static void
+gst_sink_policy_client_removed (GstElement * sink, GObject * socket,
+    gint status, GstSinkPolicy * policy)
+{
+  GstStructure *stats = NULL;
+  guint64 dropped = 0;
+
+  g_return_if_fail (G_IS_SOCKET (socket));
+
+  g_signal_emit_by_name (sink, "get-stats", socket, &stats);
+  if (stats) {
+    gst_structure_get_uint64 (stats, "dropped-buffers", &dropped);
+    gst_structure_free (stats);
+  }
+
+  g_mutex_lock (&policy->lock);
+  policy->stats.dropped += dropped;
+  if (status == CLIENT_STATUS_SLOW)
+    policy->stats.slow_clients += 1;
+  g_mutex_unlock (&policy->lock);
+
+  if (dropped || status == CLIENT_STATUS_SLOW) {
+    INFO ("%s: client %d dropped %" G_GUINT64_FORMAT " buffers%s",
+        policy->label, g_socket_get_fd (G_SOCKET (socket)), dropped,
+        status == CLIENT_STATUS_SLOW ? ", removed as too slow" : "");
+  }
+}
+
+/**
+ * @brief Bound the backlog each client can build up in the sink.
+ *
+ * tcpserversink keeps a per-client position in its buffer queue, the
+ * rendering thread never waits for a client. Past the soft limit the
+ * client is resynced, past the hard limit it is dropped, so a slow
+ * viewer can neither grow memory nor hold back the program output.
+ *
+ * A muxed stream can not be resynced, skipping data would hand the client
+ * a broken file. Its clients are only dropped at the hard limit, they get
+ * the stream headers again when they reconnect.
+ */
+static void
+gst_sink_policy_apply_client_limit (GstElement * sink, gboolean muxed)
+{
+  const GstSwitchClientLimit *limit = &opts.client_limit;
+  GstFormat format = GST_FORMAT_UNDEFINED;
+  gint64 soft = limit->soft, hard = limit->hard;
+
+  switch (limit->unit) {
+    case GST_SWITCH_CLIENT_LIMIT_NONE:
+      return;
+    case GST_SWITCH_CLIENT_LIMIT_BUFFERS:
+      format = GST_FORMAT_BUFFERS;
+      break;
+    case GST_SWITCH_CLIENT_LIMIT_BYTES:
+      format = GST_FORMAT_BYTES;
+      break;
+    case GST_SWITCH_CLIENT_LIMIT_TIME:
+      format = GST_FORMAT_TIME;
+      soft *= GST_MSECOND;
+      hard *= GST_MSECOND;
+      break;
+  }
+
+  if (muxed) {
+    g_object_set (sink, "units-format", format, "units-max", hard, NULL);
+    return;
+  }
+
+  g_object_set (sink, "units-format", format,
+      "units-soft-max", soft, "units-max", hard,
+      "recover-policy", limit->drop == GST_SWITCH_CLIENT_DROP_TO_KEYFRAME ?
+      RECOVER_POLICY_RESYNC_KEYFRAME : RECOVER_POLICY_RESYNC_SOFT_LIMIT, NULL);
+}
+
+/**
+ * gst_sink_policy_apply:
+ * @param sink a tcpserversink
+ * @param label the name used in log messages
+ * @param muxed TRUE if the sink serves a muxed stream such as matroska
+ *
+ * Apply the configured burst-on-connect and per-client backlog policies
+ * to an output sink, and start measuring the time-to-first-frame and
+ * drop counters of its clients. A muxed stream only starts at its
+ * headers and can't skip data, so it gets no burst and no resync.
+ */
+void
+gst_sink_policy_apply (GstElement * sink, const gchar * label,
+    gboolean muxed)
+{
+  GstSinkPolicy *policy;
+
+  g_return_if_fail (GST_IS_ELEMENT (sink));
+
+  switch (muxed ? GST_SWITCH_BURST_NONE : opts.output_burst.mode) {
+    case GST_SWITCH_BURST_NONE:
+      break;
+    case GST_SWITCH_BURST_FRAMES:
+      g_object_set (sink, "sync-method", SYNC_METHOD_BURST,
+          "burst-format", GST_FORMAT_BUFFERS,
+          "burst-value", (guint64) opts.output_burst.frames,
+          "buffers-min", (gint) opts.output_burst.frames, NULL);
+      break;
+    case GST_SWITCH_BURST_KEYFRAME:
+      /* Raw video has no delta units, so this is the latest frame. */
+      g_object_set (sink, "sync-method", SYNC_METHOD_LATEST_KEYFRAME, NULL);
+      break;
+  }
+
+  gst_sink_policy_apply_client_limit (sink, muxed);
+
+  /* A reused pipeline is prepared again, keep counting for the same label */
+  policy = g_object_get_data (G_OBJECT (sink), GST_SINK_POLICY_DATA);
+  if (policy && g_strcmp0 (policy->label, label) == 0)
+    return;
+  if (policy)
+    g_signal_handlers_disconnect_by_data (sink, policy);
+
+  policy = g_new0 (GstSinkPolicy, 1);
+  policy->label = g_strdup (label);
+  policy->sink = sink;
+  g_mutex_init (&policy->lock);
+  g_object_set_data_full (G_OBJECT (sink), GST_SINK_POLICY_DATA, policy,
+      (GDestroyNotify) gst_sink_policy_free);
+
+  g_signal_connect (sink, "client-added",
+      G_CALLBACK (gst_sink_policy_client_added), policy);
+  g_signal_connect (sink, "client-removed",
+      G_CALLBACK (gst_sink_policy_client_removed), policy);
+}
+
+/**
+ * gst_sink_policy_get_stats:
+ * @param sink a sink prepared by gst_sink_policy_apply()
+ * @param stats the stats to fill in
+ * @return FALSE if the sink has no policy applied
+ */
+gboolean
+gst_sink_policy_get_stats (GstElement * sink, GstSinkPolicyStats * stats)
+{
+  GstSinkPolicy *policy;
+
+  policy = g_object_get_data (G_OBJECT (sink), GST_SINK_POLICY_DATA);
+  if (policy == NULL)
+    return FALSE;
+
+  g_mutex_lock (&policy->lock);
+  *stats = policy->stats;
+  g_mutex_unlock (&policy->lock);
+  return TRUE;
+}
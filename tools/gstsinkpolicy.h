@@ -0,0 +1,53 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_SINK_POLICY_H__
+#define __GST_SINK_POLICY_H__
+
+#include <gst/gst.h>
+
+/**
+ *  @brief Per-sink client statistics kept by the sink policy.
+ *  @param clients number of clients that have connected
+ *  @param first_frames number of clients that received a first frame
+ *  @param ttff_last last time-to-first-frame, in microseconds
+ *  @param ttff_max the worst time-to-first-frame, in microseconds
+ *  @param ttff_total sum of all time-to-first-frame values, in microseconds
+ *  @param dropped buffers dropped for clients over the soft limit
+ *  @param slow_clients clients disconnected for passing the hard limit
+ */
+typedef struct _GstSinkPolicyStats
+{
+  guint clients;
+  guint first_frames;
+  gint64 ttff_last;
+  gint64 ttff_max;
+  gint64 ttff_total;
+  guint64 dropped;
+  guint slow_clients;
+} GstSinkPolicyStats;
+
+void gst_sink_policy_apply (GstElement * sink, const gchar * label,
+    gboolean muxed);
+gboolean gst_sink_policy_get_stats (GstElement * sink,
+    GstSinkPolicyStats * stats);
+
+#endif //__GST_SINK_POLICY_H__
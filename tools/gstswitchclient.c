@@ -178,7 +178,8 @@ gst_switch_client_get_audio_port (GstSwitchClient * client)
 /**
  *  @memberof GstSwitchClient
  *  @param client the GstSwitchClient instance
- *  @return The preview ports of type GVariant
+ *  @return The previews of type (a(iii)), the port, serve type and case
+ *  type of each, or NULL
  *
  *  The all preview ports.
  *
@@ -186,8 +187,8 @@ gst_switch_client_get_audio_port (GstSwitchClient * client)
 GVariant *
 gst_switch_client_get_preview_ports (GstSwitchClient * client)
 {
-  return gst_switch_client_call_controller (client, "get_preview_ports",
-      NULL, G_VARIANT_TYPE ("(s)"));
+  return gst_switch_client_call_controller (client, "get_previews",
+      NULL, G_VARIANT_TYPE ("(a(iii))"));
 }
 
 /**
@@ -382,6 +383,35 @@ gst_switch_client_adjust_pip (GstSwitchClient * client, gint dx, gint dy,
   return result;
 }
 
+/**
+ *  @memberof GstSwitchClient
+ *  @param client the GstSwitchClient instance
+ *  @param dx x position to be adjusted
+ *  @param dy y position to be adjusted
+ *  @param dw w position to be adjusted
+ *  @param dh h position to be adjusted
+ *  @return the ticket of the adjustment, 0 if it failed
+ *
+ *  Queue a PIP adjustment. The server sums the adjustments queued and
+ *  applies them at most once per frame, then tells the last ticket applied
+ *  and the new PIP with the "pip_adjusted" signal.
+ */
+guint
+gst_switch_client_queue_adjust_pip (GstSwitchClient * client, gint dx,
+    gint dy, gint dw, gint dh)
+{
+  guint ticket = 0;
+  GVariant *value = gst_switch_client_call_controller (client,
+      "queue_adjust_pip",
+      g_variant_new ("(iiii)", dx, dy, dw, dh),
+      G_VARIANT_TYPE ("(u)"));
+  if (value) {
+    g_variant_get (value, "(u)", &ticket);
+    g_variant_unref (value);
+  }
+  return ticket;
+}
+
 /**
  * @memberof GstSwitchClient
  *
@@ -545,6 +575,19 @@ gst_switch_client_select_face (GstSwitchClient * client, gint x, gint y)
     (*klass->select_face) (client, x, y);
 }
 
+/**
+ * The queued PIP adjustments were applied.
+ */
+static void
+gst_switch_client_pip_adjusted (GstSwitchClient * client, guint ticket,
+    gint x, gint y, gint w, gint h)
+{
+  GstSwitchClientClass *klass =
+      GST_SWITCH_CLIENT_CLASS (G_OBJECT_GET_CLASS (client));
+  if (klass->pip_adjusted)
+    (*klass->pip_adjusted) (client, ticket, x, y, w, h);
+}
+
 void
 gst_switch_client_on_signal_received (GDBusConnection * connection,
     const gchar * sender_name, const gchar * object_path,
@@ -573,6 +616,12 @@ gst_switch_client_on_signal_received (GDBusConnection * connection,
     g_variant_get (parameters, "(ii)", &x, &y);
 
     gst_switch_client_select_face (client, x, y);
+  } else if (g_strcmp0 ("pip_adjusted", signal_name) == 0) {
+    guint ticket = 0;
+    gint x = 0, y = 0, w = 0, h = 0;
+    g_variant_get (parameters, "(uiiii)", &ticket, &x, &y, &w, &h);
+
+    gst_switch_client_pip_adjusted (client, ticket, x, y, w, h);
   } else {
     INFO ("unhandled signal on bus: %s", signal_name);
   }
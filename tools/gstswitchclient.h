@@ -52,6 +52,8 @@ typedef void (*GstSwitchClientSelectFaceFunc) (GstSwitchClient * client,
     gint x, gint y);
 typedef void (*GstSwitchClientShowFaceMarkerFunc) (GstSwitchClient * client,
     GVariant * faces);
+typedef void (*GstSwitchClientPipAdjustedFunc) (GstSwitchClient * client,
+    guint ticket, gint x, gint y, gint w, gint h);
 
 /**
  *  @class GstSwitchClient
@@ -90,6 +92,8 @@ struct _GstSwitchClientClass
   void (*select_face) (GstSwitchClient * client, gint x, gint y);
   void (*show_face_marker) (GstSwitchClient * client, GVariant * faces);
   void (*show_track_marker) (GstSwitchClient * client, GVariant * faces);
+  void (*pip_adjusted) (GstSwitchClient * client, guint ticket,
+      gint x, gint y, gint w, gint h);
 };
 
 GType gst_switch_client_get_type (void);
@@ -114,6 +118,8 @@ void gst_switch_client_mark_tracking_remotely (GstSwitchClient * client,
 gboolean gst_switch_client_new_record (GstSwitchClient * client);
 guint gst_switch_client_adjust_pip (GstSwitchClient * client, gint dx,
     gint dy, gint dw, gint dh);
+guint gst_switch_client_queue_adjust_pip (GstSwitchClient * client, gint dx,
+    gint dy, gint dw, gint dh);
 
 extern gint gst_switch_client_dbus_timeout;
 
@@ -34,18 +34,107 @@ G_DEFINE_TYPE (GstSwitchController, gst_switch_controller, G_TYPE_OBJECT);
 
 static GDBusNodeInfo *introspection_data = NULL;
 gint gst_switch_controller_dbus_timeout = 5000;
+gint gst_switch_controller_signal_queue = 64;
+gboolean gst_switch_controller_disconnect_stuck = FALSE;
+gint gst_switch_controller_coalesce_window = 100;
 
 /**
- * @brief Helper function for matching remoting method names.
+ * @brief A connected client and the signals waiting to be sent to it.
+ * @param refcount The references, by the client lists and pending sends.
+ * @param connection The client connection.
+ * @param lock Protects the rest.
+ * @param queue The signal messages not sent yet.
+ * @param sending The number of messages sent but not flushed yet.
+ * @param since When the messages being sent were sent.
+ * @param scheduled A drain of the queue is scheduled.
+ * @param dropped The signals dropped since the client was last stuck.
+ * @param closed The client is gone or being disconnected.
+ */
+typedef struct _GstSwitchControllerClient
+{
+  gint refcount;
+  GDBusConnection *connection;
+  GMutex lock;
+  GQueue queue;
+  guint sending;
+  gint64 since;
+  gboolean scheduled;
+  guint dropped;
+  gboolean closed;
+} GstSwitchControllerClient;
+
+/**
+ * @brief A signal sent at most once per coalescing window.
+ * @param controller The controller sending it.
+ * @param signame The name of the signal held back, or NULL.
+ * @param pending The parameters of the signal held back, or NULL.
+ * @param last When a signal of the key was last sent.
+ * @param timeout The source sending the signal held back, or 0.
+ * @param sent_signame The name of the signal of the key last sent.
+ * @param sent The parameters of the signal of the key last sent.
+ */
+typedef struct _GstSwitchControllerCoalesced
+{
+  GstSwitchController *controller;
+  gchar *signame;
+  GVariant *pending;
+  gint64 last;
+  guint timeout;
+  gchar *sent_signame;
+  GVariant *sent;
+} GstSwitchControllerCoalesced;
+
+/*!< @internal Upper bounds of the method latency buckets, in usec. */
+static const gint64 gst_switch_controller_method_bounds[] = {
+  10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000,
+};
+
+#define GST_SWITCH_CONTROLLER_METHOD_BUCKETS \
+  (G_N_ELEMENTS (gst_switch_controller_method_bounds) + 1)
+
+/**
+ * @brief A remote method and how long its calls took.
+ * @param entry The method table entry.
+ * @param calls The number of calls.
+ * @param total The time of all calls in usec.
+ * @param max The longest call in usec.
+ * @param buckets The calls by latency, see
+ *        gst_switch_controller_method_bounds.
+ */
+typedef struct _GstSwitchControllerMethod
+{
+  const MethodTableEntry *entry;
+  guint calls;
+  guint64 total;
+  gint64 max;
+  guint buckets[GST_SWITCH_CONTROLLER_METHOD_BUCKETS];
+} GstSwitchControllerMethod;
+
+/*!< @internal Protects the call statistics of the methods. */
+G_LOCK_DEFINE_STATIC (gst_switch_controller_methods);
+
+/**
+ * @brief Count a call of a remote method.
+ * @param method The method called.
+ * @param usec How long the call took.
  * @memberof GstSwitchController
  */
-static gboolean
-gst_switch_controller_method_match (const gchar * key,
-    MethodTableEntry * entry, const gchar * match)
+static void
+gst_switch_controller_method_count (GstSwitchControllerMethod * method,
+    gint64 usec)
 {
-  if (g_strcmp0 (key, match) == 0)
-    return TRUE;
-  return FALSE;
+  guint b;
+
+  for (b = 0; b < G_N_ELEMENTS (gst_switch_controller_method_bounds); ++b)
+    if (usec < gst_switch_controller_method_bounds[b])
+      break;
+
+  G_LOCK (gst_switch_controller_methods);
+  method->calls += 1;
+  method->total += usec;
+  method->max = MAX (method->max, usec);
+  method->buckets[b] += 1;
+  G_UNLOCK (gst_switch_controller_methods);
 }
 
 /**
@@ -64,21 +153,23 @@ gst_switch_controller_do_method_call (GDBusConnection * connection,
   GstSwitchController *controller = GST_SWITCH_CONTROLLER (user_data);
   GstSwitchControllerClass *klass =
       GST_SWITCH_CONTROLLER_CLASS (G_OBJECT_GET_CLASS (controller));
-  MethodFunc entry = (MethodFunc) g_hash_table_find (klass->methods,
-      (GHRFunc)
-      gst_switch_controller_method_match,
-      (gpointer) method_name);
+  GstSwitchControllerMethod *method = g_hash_table_lookup (klass->methods,
+      method_name);
+  gint64 start = g_get_monotonic_time ();
   GVariant *results;
 
-  if (!entry)
+  if (!method)
     goto error_no_method;
 
   /*
      INFO ("calling: %s/%s", interface_name, method_name);
    */
 
-  results = (*entry) (G_OBJECT (controller), connection, parameters);
+  results = (*method->entry->func) (G_OBJECT (controller), connection,
+      parameters);
   g_dbus_method_invocation_return_value (invocation, results);
+  gst_switch_controller_method_count (method,
+      g_get_monotonic_time () - start);
   return;
 
 error_no_method:
@@ -194,44 +285,360 @@ gst_switch_controller_export (GstSwitchController * controller)
 }
 #endif
 
+static GstSwitchControllerClient *
+gst_switch_controller_client_new (GDBusConnection * connection)
+{
+  GstSwitchControllerClient *client = g_new0 (GstSwitchControllerClient, 1);
+
+  client->refcount = 1;
+  client->connection = g_object_ref (connection);
+  g_mutex_init (&client->lock);
+  g_queue_init (&client->queue);
+  return client;
+}
+
+static GstSwitchControllerClient *
+gst_switch_controller_client_ref (GstSwitchControllerClient * client)
+{
+  g_atomic_int_inc (&client->refcount);
+  return client;
+}
+
+static void
+gst_switch_controller_client_unref (GstSwitchControllerClient * client)
+{
+  if (!g_atomic_int_dec_and_test (&client->refcount))
+    return;
+
+  g_queue_foreach (&client->queue, (GFunc) g_object_unref, NULL);
+  g_queue_clear (&client->queue);
+  g_mutex_clear (&client->lock);
+  g_object_unref (client->connection);
+  g_free (client);
+}
+
+static void gst_switch_controller_client_flushed (GDBusConnection *
+    connection, GAsyncResult * result, GstSwitchControllerClient * client);
+
+/**
+ * @brief Send the signals queued for a client, in the main loop.
+ * @return FALSE to remove the idle source.
+ * @memberof GstSwitchController
+ *
+ * Everything queued is sent at once and flushed asynchronously, the next
+ * signals wait until the flush is done.
+ */
+static gboolean
+gst_switch_controller_client_drain (GstSwitchControllerClient * client)
+{
+  GQueue messages = G_QUEUE_INIT;
+  GDBusMessage *message;
+  GError *error = NULL;
+
+  g_mutex_lock (&client->lock);
+  client->scheduled = FALSE;
+  if (client->sending || client->closed || g_queue_is_empty (&client->queue)) {
+    g_mutex_unlock (&client->lock);
+    return FALSE;
+  }
+  messages = client->queue;
+  g_queue_init (&client->queue);
+  client->sending = messages.length;
+  client->since = g_get_monotonic_time ();
+  g_mutex_unlock (&client->lock);
+
+  while ((message = g_queue_pop_head (&messages))) {
+    if (!g_dbus_connection_send_message (client->connection, message,
+            G_DBUS_SEND_MESSAGE_FLAGS_NONE, NULL, &error)) {
+      ERROR ("emit: %s", error->message);
+      g_clear_error (&error);
+    }
+    g_object_unref (message);
+  }
+
+  g_dbus_connection_flush (client->connection, NULL,
+      (GAsyncReadyCallback) gst_switch_controller_client_flushed,
+      gst_switch_controller_client_ref (client));
+  return FALSE;
+}
+
+/**
+ * @brief Invoked when the signals sent to a client were written.
+ * @memberof GstSwitchController
+ */
+static void
+gst_switch_controller_client_flushed (GDBusConnection * connection,
+    GAsyncResult * result, GstSwitchControllerClient * client)
+{
+  // A closed connection fails the flush, it is dropped when closed
+  g_dbus_connection_flush_finish (connection, result, NULL);
+
+  g_mutex_lock (&client->lock);
+  client->sending = 0;
+  client->dropped = 0;
+  g_mutex_unlock (&client->lock);
+
+  gst_switch_controller_client_drain (client);
+  gst_switch_controller_client_unref (client);
+}
+
+/**
+ * @brief Queue a signal for a client.
+ * @param client The client.
+ * @param message The signal message, owned by the queue from now on.
+ * @memberof GstSwitchController
+ *
+ * A client which has not read the signals sent to it for the D-Bus timeout,
+ * or which has the most signals waiting, is stuck. The oldest signal of a
+ * stuck client is dropped for the new one, or the client is disconnected.
+ */
+static void
+gst_switch_controller_client_push (GstSwitchControllerClient * client,
+    GDBusMessage * message)
+{
+  gint64 now = g_get_monotonic_time ();
+  gboolean stuck, disconnect = FALSE;
+
+  g_mutex_lock (&client->lock);
+  if (client->closed) {
+    g_mutex_unlock (&client->lock);
+    g_object_unref (message);
+    return;
+  }
+
+  stuck = client->queue.length + client->sending >=
+      (guint) MAX (gst_switch_controller_signal_queue, 1) ||
+      (client->sending && now - client->since >
+      (gint64) gst_switch_controller_dbus_timeout * 1000);
+  if (stuck && gst_switch_controller_disconnect_stuck) {
+    client->closed = disconnect = TRUE;
+    g_queue_foreach (&client->queue, (GFunc) g_object_unref, NULL);
+    g_queue_clear (&client->queue);
+    g_object_unref (message);
+  } else {
+    if (stuck && !g_queue_is_empty (&client->queue)) {
+      g_object_unref (g_queue_pop_head (&client->queue));
+      if (client->dropped++ == 0)
+        WARN ("client %p is stuck, dropping its oldest signals", client);
+    }
+    g_queue_push_tail (&client->queue, message);
+  }
+
+  if (!client->scheduled && !client->sending && !client->closed) {
+    client->scheduled = TRUE;
+    g_idle_add_full (G_PRIORITY_DEFAULT,
+        (GSourceFunc) gst_switch_controller_client_drain,
+        gst_switch_controller_client_ref (client),
+        (GDestroyNotify) gst_switch_controller_client_unref);
+  }
+  g_mutex_unlock (&client->lock);
+
+  if (disconnect) {
+    WARN ("client %p is stuck, disconnecting it", client);
+    g_dbus_connection_close (client->connection, NULL, NULL, NULL);
+  }
+}
+
 /**
  * @brief Perform sending remote signals to connected clients.
  * @memberof GstSwitchController
+ *
+ * The signal is queued for each client and sent from the main loop, so a
+ * client that doesn't read its connection holds up no one. The clients
+ * lock is only held to take the current client list, which is replaced
+ * rather than changed when clients come and go.
  */
 static void
 gst_switch_controller_emit_signal (GstSwitchController * controller,
     const gchar * signame, GVariant * parameters)
 {
-  GError *error;
-  gboolean res;
-  GList *client;
-  gint num;
+  GPtrArray *clients;
+  guint n;
 
-  GST_SWITCH_CONTROLLER_LOCK_CLIENTS (controller);
   g_assert (parameters);
   g_variant_ref_sink (parameters);
 
-  for (client = controller->clients, num = 0; client;
-      client = g_list_next (client)) {
-    error = NULL;
-    res = g_dbus_connection_emit_signal (G_DBUS_CONNECTION (client->data),
-        /*destination_bus_name */ NULL,
-        SWITCH_CONTROLLER_OBJECT_PATH,
-        SWITCH_CONTROLLER_OBJECT_NAME, signame, parameters, &error);
-
-    if (!res) {
-      g_assert (error != NULL);
-      ERROR ("emit: (%d) %s", num, error->message);
-    } else {
-      ++num;
-    }
+  GST_SWITCH_CONTROLLER_LOCK_CLIENTS (controller);
+  clients = g_ptr_array_ref (controller->clients);
+  GST_SWITCH_CONTROLLER_UNLOCK_CLIENTS (controller);
+
+  for (n = 0; n < clients->len; ++n) {
+    GDBusMessage *message = g_dbus_message_new_signal
+        (SWITCH_CONTROLLER_OBJECT_PATH, SWITCH_CONTROLLER_OBJECT_NAME,
+        signame);
+    g_dbus_message_set_body (message, parameters);
+    gst_switch_controller_client_push (g_ptr_array_index (clients, n),
+        message);
   }
-  /*
-     INFO ("emit: %s (%d/%d)", signame, num, g_list_length (controller->uis));
-   */
+
+  g_ptr_array_unref (clients);
   g_variant_unref (parameters);
+}
+
+static void
+gst_switch_controller_coalesced_free (GstSwitchControllerCoalesced *
+    coalesced)
+{
+  if (coalesced->timeout)
+    g_source_remove (coalesced->timeout);
+  if (coalesced->pending)
+    g_variant_unref (coalesced->pending);
+  if (coalesced->sent)
+    g_variant_unref (coalesced->sent);
+  g_free (coalesced->signame);
+  g_free (coalesced->sent_signame);
+  g_free (coalesced);
+}
+
+/**
+ * @brief Remember the signal of a key being sent, under the coalesce lock.
+ * @memberof GstSwitchController
+ */
+static void
+gst_switch_controller_coalesced_sent (GstSwitchControllerCoalesced *
+    coalesced, const gchar * signame, GVariant * parameters)
+{
+  if (coalesced->sent)
+    g_variant_unref (coalesced->sent);
+  g_free (coalesced->sent_signame);
+  coalesced->sent_signame = g_strdup (signame);
+  coalesced->sent = g_variant_ref (parameters);
+  coalesced->last = g_get_monotonic_time ();
+}
 
+/**
+ * @brief Send the signal held back at the end of a coalescing window.
+ * @return FALSE to remove the timeout source.
+ * @memberof GstSwitchController
+ *
+ * The signal is dropped if it is the one last sent, as when an input was
+ * removed and added back within the window.
+ */
+static gboolean
+gst_switch_controller_coalesced_send (GstSwitchControllerCoalesced *
+    coalesced)
+{
+  GstSwitchController *controller = coalesced->controller;
+  GVariant *parameters;
+  gchar *signame;
+
+  g_mutex_lock (&controller->coalesce_lock);
+  signame = coalesced->signame;
+  parameters = coalesced->pending;
+  coalesced->signame = NULL;
+  coalesced->pending = NULL;
+  coalesced->timeout = 0;
+  if (parameters && coalesced->sent &&
+      g_strcmp0 (signame, coalesced->sent_signame) == 0 &&
+      g_variant_equal (parameters, coalesced->sent)) {
+    g_variant_unref (parameters);
+    parameters = NULL;
+  } else if (parameters) {
+    gst_switch_controller_coalesced_sent (coalesced, signame, parameters);
+  }
+  g_mutex_unlock (&controller->coalesce_lock);
+
+  if (parameters) {
+    gst_switch_controller_emit_signal (controller, signame, parameters);
+    g_variant_unref (parameters);
+  }
+  g_free (signame);
+  return FALSE;
+}
+
+/**
+ * @brief Send a signal at most once per coalescing window.
+ * @param key Identifies the signals replacing each other.
+ * @memberof GstSwitchController
+ *
+ * A signal is sent at once if none of its key was sent within the window.
+ * Otherwise it is held back until the window ends, replacing the signal
+ * held back before, so that the clients still get the latest state but
+ * not the same one twice.
+ */
+static void
+gst_switch_controller_emit_coalesced (GstSwitchController * controller,
+    const gchar * key, const gchar * signame, GVariant * parameters)
+{
+  GstSwitchControllerCoalesced *coalesced;
+  gint64 window = (gint64) gst_switch_controller_coalesce_window * 1000;
+  gint64 now = g_get_monotonic_time ();
+  gboolean send = FALSE;
+
+  if (window <= 0) {
+    gst_switch_controller_emit_signal (controller, signame, parameters);
+    return;
+  }
+
+  g_variant_ref_sink (parameters);
+
+  g_mutex_lock (&controller->coalesce_lock);
+  coalesced = g_hash_table_lookup (controller->coalesced, key);
+  if (coalesced == NULL) {
+    coalesced = g_new0 (GstSwitchControllerCoalesced, 1);
+    coalesced->controller = controller;
+    coalesced->last = now - window;
+    g_hash_table_insert (controller->coalesced, g_strdup (key), coalesced);
+  }
+
+  if (!coalesced->timeout && now - coalesced->last >= window) {
+    gst_switch_controller_coalesced_sent (coalesced, signame, parameters);
+    send = TRUE;
+  } else {
+    if (coalesced->pending)
+      g_variant_unref (coalesced->pending);
+    g_free (coalesced->signame);
+    coalesced->signame = g_strdup (signame);
+    coalesced->pending = parameters;
+    if (!coalesced->timeout) {
+      coalesced->timeout =
+          g_timeout_add (MAX ((coalesced->last + window - now) / 1000, 1),
+          (GSourceFunc) gst_switch_controller_coalesced_send, coalesced);
+    }
+  }
+  g_mutex_unlock (&controller->coalesce_lock);
+
+  if (send) {
+    gst_switch_controller_emit_signal (controller, signame, parameters);
+    g_variant_unref (parameters);
+  }
+}
+
+/**
+ * @brief Replace the client list by a copy with a client added or removed.
+ * @param add The client to add, or NULL.
+ * @param connection The connection of the client to remove, or NULL.
+ * @return The client removed, or NULL.
+ * @memberof GstSwitchController
+ */
+static GstSwitchControllerClient *
+gst_switch_controller_update_clients (GstSwitchController * controller,
+    GstSwitchControllerClient * add, GDBusConnection * connection)
+{
+  GstSwitchControllerClient *removed = NULL;
+  GPtrArray *clients, *old;
+  guint n;
+
+  GST_SWITCH_CONTROLLER_LOCK_CLIENTS (controller);
+  old = controller->clients;
+  clients = g_ptr_array_new_full (old->len + 1,
+      (GDestroyNotify) gst_switch_controller_client_unref);
+  for (n = 0; n < old->len; ++n) {
+    GstSwitchControllerClient *client = g_ptr_array_index (old, n);
+    if (client->connection == connection && removed == NULL)
+      removed = client;
+    else
+      g_ptr_array_add (clients, gst_switch_controller_client_ref (client));
+  }
+  if (add)
+    g_ptr_array_add (clients, gst_switch_controller_client_ref (add));
+  controller->clients = clients;
+  if (removed)
+    gst_switch_controller_client_ref (removed);
   GST_SWITCH_CONTROLLER_UNLOCK_CLIENTS (controller);
+
+  g_ptr_array_unref (old);
+  return removed;
 }
 
 /**
@@ -243,19 +650,28 @@ gst_switch_controller_on_connection_closed (GDBusConnection * connection,
     gboolean vanished, GError * error, gpointer user_data)
 {
   GstSwitchController *controller = GST_SWITCH_CONTROLLER (user_data);
-
-  (void) controller;
+  GstSwitchControllerClient *client;
+  guint remaining;
 
   if (error) {
     WARN ("close: %s", error->message);
   }
 
+  client = gst_switch_controller_update_clients (controller, NULL,
+      connection);
+  if (client) {
+    g_mutex_lock (&client->lock);
+    client->closed = TRUE;
+    g_mutex_unlock (&client->lock);
+    gst_switch_controller_client_unref (client);
+  }
+
   GST_SWITCH_CONTROLLER_LOCK_CLIENTS (controller);
-  controller->clients = g_list_remove (controller->clients, connection);
+  remaining = controller->clients->len;
   GST_SWITCH_CONTROLLER_UNLOCK_CLIENTS (controller);
 
-  INFO ("closed: %p, %d (%d clients remaining)", connection, vanished,
-      g_list_length (controller->clients));
+  INFO ("closed: %p, %d (%u clients remaining)", connection, vanished,
+      remaining);
 
   g_object_unref (connection);
 }
@@ -269,6 +685,7 @@ gst_switch_controller_on_new_connection (GDBusServer * server,
     GDBusConnection * connection, gpointer user_data)
 {
   GstSwitchController *controller = GST_SWITCH_CONTROLLER (user_data);
+  GstSwitchControllerClient *client;
   guint register_id = 0;
   GError *error = NULL;
 
@@ -288,9 +705,9 @@ gst_switch_controller_on_new_connection (GDBusServer * server,
   g_signal_connect (connection, "closed",
       G_CALLBACK (gst_switch_controller_on_connection_closed), controller);
 
-  GST_SWITCH_CONTROLLER_LOCK_CLIENTS (controller);
-  controller->clients = g_list_append (controller->clients, connection);
-  GST_SWITCH_CONTROLLER_UNLOCK_CLIENTS (controller);
+  client = gst_switch_controller_client_new (connection);
+  gst_switch_controller_update_clients (controller, client, NULL);
+  gst_switch_controller_client_unref (client);
 
   INFO ("registered: %d, %s, %s", register_id,
       SWITCH_CONTROLLER_OBJECT_PATH, introspection_data->interfaces[0]->name);
@@ -314,7 +731,11 @@ gst_switch_controller_init (GstSwitchController * controller)
   GError *error = NULL;
 
   g_mutex_init (&controller->clients_lock);
-  controller->clients = NULL;
+  controller->clients = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_switch_controller_client_unref);
+  g_mutex_init (&controller->coalesce_lock);
+  controller->coalesced = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, (GDestroyNotify) gst_switch_controller_coalesced_free);
 
   flags |= G_DBUS_SERVER_FLAGS_RUN_IN_THREAD;
   flags |= G_DBUS_SERVER_FLAGS_AUTHENTICATION_ALLOW_ANONYMOUS;
@@ -357,7 +778,10 @@ gst_switch_controller_finalize (GstSwitchController * controller)
     controller->bus_server = NULL;
   }
 
+  g_ptr_array_unref (controller->clients);
   g_mutex_clear (&controller->clients_lock);
+  g_hash_table_unref (controller->coalesced);
+  g_mutex_clear (&controller->coalesce_lock);
 
   if (G_OBJECT_CLASS (gst_switch_controller_parent_class)->finalize)
     (*G_OBJECT_CLASS (gst_switch_controller_parent_class)->finalize)
@@ -429,7 +853,11 @@ void
 gst_switch_controller_tell_preview_port_added (GstSwitchController * controller,
     gint port, gint serve, gint type)
 {
-  gst_switch_controller_emit_signal (controller, "preview_port_added",
+  gchar key[32];
+
+  // An input flapping within the window is told in its latest state
+  g_snprintf (key, sizeof (key), "preview_port %d", port);
+  gst_switch_controller_emit_coalesced (controller, key, "preview_port_added",
       g_variant_new ("(iii)", port, serve, type));
 }
 
@@ -437,8 +865,11 @@ void
 gst_switch_controller_tell_preview_port_removed (GstSwitchController *
     controller, gint port, gint serve, gint type)
 {
-  gst_switch_controller_emit_signal (controller, "preview_port_removed",
-      g_variant_new ("(iii)", port, serve, type));
+  gchar key[32];
+
+  g_snprintf (key, sizeof (key), "preview_port %d", port);
+  gst_switch_controller_emit_coalesced (controller, key,
+      "preview_port_removed", g_variant_new ("(iii)", port, serve, type));
 }
 
 /**
@@ -456,6 +887,41 @@ gst_switch_controller_tell_new_mode_onlne (GstSwitchController * controller,
       g_variant_new ("(i)", mode));
 }
 
+/**
+ *  @memberof GstSwitchController
+ *  @param controller the GstSwitchController instance
+ *  @param level the degradation level, 0 for none
+ *  @param step the name of the step
+ *
+ *  Tell the clients that the previews were degraded or restored a step.
+ */
+void
+gst_switch_controller_tell_previews_degraded (GstSwitchController *
+    controller, gint level, const gchar * step)
+{
+  gst_switch_controller_emit_signal (controller, "previews_degraded",
+      g_variant_new ("(is)", level, step));
+}
+
+/**
+ *  @memberof GstSwitchController
+ *  @param controller the GstSwitchController instance
+ *  @param ticket the last queued adjustment applied
+ *  @param x the PIP X position
+ *  @param y the PIP Y position
+ *  @param w the PIP width
+ *  @param h the PIP height
+ *
+ *  Tell the clients the PIP the queued adjustments ended up with.
+ */
+void
+gst_switch_controller_tell_pip_adjusted (GstSwitchController * controller,
+    guint ticket, gint x, gint y, gint w, gint h)
+{
+  gst_switch_controller_emit_signal (controller, "pip_adjusted",
+      g_variant_new ("(uiiii)", ticket, x, y, w, h));
+}
+
 gboolean
 gst_switch_controller_select_face (GstSwitchController * controller,
     gint x, gint y)
@@ -470,16 +936,16 @@ void
 gst_switch_controller_show_face_marker (GstSwitchController * controller,
     GVariant * faces)
 {
-  gst_switch_controller_emit_signal (controller, "show_face_marker",
-      g_variant_new_tuple (&faces, 1));
+  gst_switch_controller_emit_coalesced (controller, "show_face_marker",
+      "show_face_marker", g_variant_new_tuple (&faces, 1));
 }
 
 void
 gst_switch_controller_show_track_marker (GstSwitchController * controller,
     GVariant * faces)
 {
-  gst_switch_controller_emit_signal (controller, "show_track_marker",
-      g_variant_new_tuple (&faces, 1));
+  gst_switch_controller_emit_coalesced (controller, "show_track_marker",
+      "show_track_marker", g_variant_new_tuple (&faces, 1));
 }
 
 /**
@@ -530,10 +996,55 @@ gst_switch_controller__get_audio_port (GstSwitchController * controller,
   return g_variant_new ("(i)", port);
 }
 
+/**
+ * @memberof GstSwitchController
+ * @return a floating GVariant of type a(iii): the port, serve type and case
+ *         type of each preview
+ */
+static GVariant *
+gst_switch_controller_previews (GstSwitchController * controller)
+{
+  GArray *serves = NULL, *types = NULL;
+  GArray *ports = gst_switch_server_get_preview_sink_ports (controller->server,
+      &serves, &types);
+  GVariantBuilder builder;
+  guint n;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(iii)"));
+  for (n = 0; n < ports->len; ++n) {
+    g_variant_builder_add (&builder, "(iii)",
+        g_array_index (ports, gint, n),
+        g_array_index (serves, gint, n), g_array_index (types, gint, n));
+  }
+
+  g_array_free (ports, TRUE);
+  g_array_free (serves, TRUE);
+  g_array_free (types, TRUE);
+  return g_variant_builder_end (&builder);
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_previews".
+ */
+static GVariant *
+gst_switch_controller__get_previews (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    result = g_variant_new ("(@a(iii))",
+        gst_switch_controller_previews (controller));
+  }
+  return result;
+}
+
 /**
  * @memberof GstSwitchController
  *
- * Remoting method stub of "get_preview_ports".
+ * Remoting method stub of "get_preview_ports", the previews of
+ * "get_previews" printed as text for older clients.
  */
 static GVariant *
 gst_switch_controller__get_preview_ports (GstSwitchController * controller,
@@ -541,35 +1052,14 @@ gst_switch_controller__get_preview_ports (GstSwitchController * controller,
 {
   GVariant *result = NULL;
   if (controller->server) {
-    GArray *serves = NULL, *types = NULL;
-    GArray *ports =
-        gst_switch_server_get_preview_sink_ports (controller->server, &serves,
-        &types);
-    int n;
-    GVariantBuilder *builder;
-    GVariant *value;
-    gchar *res;
-
-    builder = g_variant_builder_new (G_VARIANT_TYPE ("a(iii)"));
-    for (n = 0; n < ports->len; ++n) {
-      g_variant_builder_add (builder, "(iii)",
-          g_array_index (ports, gint, n),
-          g_array_index (serves, gint, n), g_array_index (types, gint, n));
-    }
-    value = g_variant_builder_end (builder);
-    //result = g_variant_new_tuple (&value, 1);
-    res = g_variant_print (value, FALSE);
-    result = g_variant_new ("(s)", res);
+    GVariant *value = g_variant_ref_sink (gst_switch_controller_previews
+        (controller));
+    gchar *res = g_variant_print (value, FALSE);
 
-    /*
-       INFO ("value: %s (%d)", g_variant_get_type_string (value),
-       g_variant_n_children (value));
-       INFO ("result: %s, %s", g_variant_get_type_string (result), res);
-     */
+    result = g_variant_new ("(s)", res);
 
     g_free (res);
-    g_array_free (ports, TRUE);
-    g_array_free (types, TRUE);
+    g_variant_unref (value);
   }
   return result;
 }
@@ -630,6 +1120,278 @@ gst_switch_controller__new_record (GstSwitchController * controller,
   return result;
 }
 
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_sink_stats".
+ */
+static GVariant *
+gst_switch_controller__get_sink_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    result = g_variant_new ("(@a(suuxxxtu))",
+        gst_switch_server_get_sink_stats (controller->server));
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "set_record_encoder".
+ */
+static GVariant *
+gst_switch_controller__set_record_encoder (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE;
+  const gchar *spec = NULL;
+  g_variant_get (parameters, "(&s)", &spec);
+  if (controller->server) {
+    ok = gst_switch_server_set_record_encoder (controller->server, spec);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "replay_save".
+ */
+static GVariant *
+gst_switch_controller__replay_save (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE;
+  gint port = 0, start = 0, end = 0;
+  const gchar *filename = NULL;
+  g_variant_get (parameters, "(iii&s)", &port, &start, &end, &filename);
+  if (controller->server) {
+    ok = gst_switch_server_replay_save (controller->server, port, start, end,
+        filename);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "replay_play".
+ */
+static GVariant *
+gst_switch_controller__replay_play (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gboolean ok = FALSE;
+  gint port = 0, start = 0, end = 0;
+  g_variant_get (parameters, "(iii)", &port, &start, &end);
+  if (controller->server) {
+    ok = gst_switch_server_replay_play (controller->server, port, start, end);
+    result = g_variant_new ("(b)", ok);
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_worker_timings".
+ */
+static GVariant *
+gst_switch_controller__get_worker_timings (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    result = g_variant_new ("(@a(ssuuuuuau))",
+        gst_switch_server_get_worker_timings (controller->server));
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_bus_stats".
+ */
+static GVariant *
+gst_switch_controller__get_bus_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    result = g_variant_new ("(@a(siuuuuu))",
+        gst_switch_server_get_bus_stats (controller->server));
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_queue_levels".
+ */
+static GVariant *
+gst_switch_controller__get_queue_levels (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  if (controller->server) {
+    result = g_variant_new ("(@a(sttu))",
+        gst_switch_server_get_queue_levels (controller->server));
+  }
+  return result;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "get_method_stats".
+ */
+static GVariant *
+gst_switch_controller__get_method_stats (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  return g_variant_new ("(@a(suuuau))",
+      gst_switch_controller_get_method_stats (controller));
+}
+
+/**
+ * @brief Check an operation of a batch.
+ * @param klass The controller class.
+ * @param name The method of the operation.
+ * @param args The arguments of the operation.
+ * @param error Set to the reason if the operation is invalid.
+ * @return the method to call, or NULL if the operation is invalid
+ * @memberof GstSwitchController
+ */
+static GstSwitchControllerMethod *
+gst_switch_controller_batch_method (GstSwitchControllerClass * klass,
+    const gchar * name, GVariant * args, gchar ** error)
+{
+  GstSwitchControllerMethod *method =
+      g_hash_table_lookup (klass->methods, name);
+  GDBusMethodInfo *info =
+      g_dbus_interface_info_lookup_method (introspection_data->interfaces[0],
+      name);
+  GString *signature;
+  gint n, mode, channel, port;
+
+  if (!method || !info || g_strcmp0 (name, "execute_batch") == 0) {
+    *error = g_strdup_printf ("unsupported operation %s", name);
+    return NULL;
+  }
+
+  signature = g_string_new ("(");
+  for (n = 0; info->in_args && info->in_args[n]; ++n)
+    g_string_append (signature, info->in_args[n]->signature);
+  g_string_append_c (signature, ')');
+  if (!g_variant_is_of_type (args, G_VARIANT_TYPE (signature->str))) {
+    *error = g_strdup_printf ("%s expects %s, not %s", name, signature->str,
+        g_variant_get_type_string (args));
+    g_string_free (signature, TRUE);
+    return NULL;
+  }
+  g_string_free (signature, TRUE);
+
+  if (g_strcmp0 (name, "set_composite_mode") == 0) {
+    g_variant_get (args, "(i)", &mode);
+    if (mode < COMPOSE_MODE_NONE || COMPOSE_MODE__LAST < mode) {
+      *error = g_strdup_printf ("invalid composite mode %d", mode);
+      return NULL;
+    }
+  } else if (g_strcmp0 (name, "switch") == 0) {
+    g_variant_get (args, "(ii)", &channel, &port);
+    if (channel != 'A' && channel != 'B' && channel != 'a') {
+      *error = g_strdup_printf ("invalid channel %d", channel);
+      return NULL;
+    }
+  }
+  return method;
+}
+
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "execute_batch". Every operation is checked
+ * before any is called, and the composite changes of the batch are applied
+ * in a single reconfiguration.
+ */
+static GVariant *
+gst_switch_controller__execute_batch (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GstSwitchControllerClass *klass =
+      GST_SWITCH_CONTROLLER_CLASS (G_OBJECT_GET_CLASS (controller));
+  GstSwitchControllerMethod **methods;
+  GVariantBuilder builder;
+  GVariant *ops, *args, *result;
+  gchar **errors;
+  const gchar *name;
+  gboolean valid = TRUE;
+  gint64 start;
+  gsize n, count;
+
+  g_variant_get (parameters, "(@a(sv))", &ops);
+  count = g_variant_n_children (ops);
+  methods = g_new0 (GstSwitchControllerMethod *, count + 1);
+  errors = g_new0 (gchar *, count + 1);
+
+  for (n = 0; n < count; ++n) {
+    g_variant_get_child (ops, n, "(&sv)", &name, &args);
+    methods[n] = gst_switch_controller_batch_method (klass, name, args,
+        &errors[n]);
+    valid = valid && methods[n] != NULL;
+    g_variant_unref (args);
+  }
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(bv)"));
+  if (!valid) {
+    for (n = 0; n < count; ++n) {
+      if (errors[n])
+        WARN ("batch operation %d: %s", (gint) n, errors[n]);
+      g_variant_builder_add (&builder, "(bv)", FALSE,
+          g_variant_new_string (errors[n] ? errors[n] : "not executed"));
+    }
+    goto end;
+  }
+
+  if (controller->server)
+    gst_switch_server_hold_composite (controller->server);
+
+  for (n = 0; n < count; ++n) {
+    g_variant_get_child (ops, n, "(&sv)", &name, &args);
+    start = g_get_monotonic_time ();
+    result = (*methods[n]->entry->func) (G_OBJECT (controller), connection,
+        args);
+    gst_switch_controller_method_count (methods[n],
+        g_get_monotonic_time () - start);
+    if (result) {
+      g_variant_builder_add (&builder, "(bv)", TRUE, result);
+    } else {
+      g_variant_builder_add (&builder, "(bv)", FALSE,
+          g_variant_new_string ("no result"));
+    }
+    g_variant_unref (args);
+  }
+
+  if (controller->server)
+    gst_switch_server_release_composite (controller->server);
+
+end:
+  g_strfreev (errors);
+  g_free (methods);
+  g_variant_unref (ops);
+  return g_variant_new ("(a(bv))", &builder);
+}
+
 /**
  * @memberof GstSwitchController
  *
@@ -650,6 +1412,27 @@ gst_switch_controller__adjust_pip (GstSwitchController * controller,
   return result;
 }
 
+/**
+ * @memberof GstSwitchController
+ *
+ * Remoting method stub of "queue_adjust_pip".
+ */
+static GVariant *
+gst_switch_controller__queue_adjust_pip (GstSwitchController * controller,
+    GDBusConnection * connection, GVariant * parameters)
+{
+  GVariant *result = NULL;
+  gint dx, dy, dw, dh;
+  guint ticket;
+  g_variant_get (parameters, "(iiii)", &dx, &dy, &dw, &dh);
+  if (controller->server) {
+    ticket = gst_switch_server_queue_adjust_pip (controller->server,
+        dx, dy, dw, dh);
+    result = g_variant_new ("(u)", ticket);
+  }
+  return result;
+}
+
 /**
  * @memberof GstSwitchController
  *
@@ -731,12 +1514,25 @@ static MethodTableEntry gst_switch_controller_method_table[] = {
   {"get_audio_port", (MethodFunc) gst_switch_controller__get_audio_port},
   {"get_preview_ports",
       (MethodFunc) gst_switch_controller__get_preview_ports},
+  {"get_previews", (MethodFunc) gst_switch_controller__get_previews},
   {"set_composite_mode",
       (MethodFunc) gst_switch_controller__set_composite_mode},
   {"get_composite_mode",
       (MethodFunc) gst_switch_controller__get_composite_mode},
   {"new_record", (MethodFunc) gst_switch_controller__new_record},
+  {"get_sink_stats", (MethodFunc) gst_switch_controller__get_sink_stats},
+  {"set_record_encoder",
+      (MethodFunc) gst_switch_controller__set_record_encoder},
+  {"replay_save", (MethodFunc) gst_switch_controller__replay_save},
+  {"replay_play", (MethodFunc) gst_switch_controller__replay_play},
+  {"get_worker_timings",
+      (MethodFunc) gst_switch_controller__get_worker_timings},
+  {"get_bus_stats", (MethodFunc) gst_switch_controller__get_bus_stats},
+  {"get_queue_levels", (MethodFunc) gst_switch_controller__get_queue_levels},
+  {"get_method_stats", (MethodFunc) gst_switch_controller__get_method_stats},
+  {"execute_batch", (MethodFunc) gst_switch_controller__execute_batch},
   {"adjust_pip", (MethodFunc) gst_switch_controller__adjust_pip},
+  {"queue_adjust_pip", (MethodFunc) gst_switch_controller__queue_adjust_pip},
   {"click_video", (MethodFunc) gst_switch_controller__click_video},
   {"mark_face", (MethodFunc) gst_switch_controller__mark_face},
   {"mark_tracking", (MethodFunc) gst_switch_controller__mark_tracking},
@@ -764,12 +1560,56 @@ gst_switch_controller_class_init (GstSwitchControllerClass * klass)
 
   MethodTableEntry *entry = &gst_switch_controller_method_table[0];
   for (; entry->name && entry->func; ++entry) {
-    g_hash_table_insert (klass->methods, (gpointer) entry->name,
-        (gpointer) entry->func);
+    GstSwitchControllerMethod *method = g_new0 (GstSwitchControllerMethod, 1);
+    method->entry = entry;
+    g_hash_table_insert (klass->methods, (gpointer) entry->name, method);
   }
 
   introspection_data =
       g_dbus_node_info_new_for_xml (gstswitchcontroller_introspection_xml,
       NULL);
   g_assert (introspection_data != NULL);
+
+  GDBusMethodInfo **info = introspection_data->interfaces[0]->methods;
+  for (; info && *info; ++info) {
+    if (!g_hash_table_contains (klass->methods, (*info)->name))
+      WARN ("no handler for method %s", (*info)->name);
+  }
+}
+
+/**
+ * @brief Get the calls of each remote method.
+ * @param controller the GstSwitchController instance
+ * @return a floating GVariant of type a(suuuau): the method name, calls,
+ *         mean and max latency in usec, and the calls by latency
+ * @memberof GstSwitchController
+ */
+GVariant *
+gst_switch_controller_get_method_stats (GstSwitchController * controller)
+{
+  GstSwitchControllerClass *klass =
+      GST_SWITCH_CONTROLLER_CLASS (G_OBJECT_GET_CLASS (controller));
+  MethodTableEntry *entry = &gst_switch_controller_method_table[0];
+  GVariantBuilder builder, buckets;
+  guint b;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(suuuau)"));
+
+  G_LOCK (gst_switch_controller_methods);
+  for (; entry->name && entry->func; ++entry) {
+    GstSwitchControllerMethod *method = g_hash_table_lookup (klass->methods,
+        entry->name);
+
+    g_variant_builder_init (&buckets, G_VARIANT_TYPE ("au"));
+    for (b = 0; b < GST_SWITCH_CONTROLLER_METHOD_BUCKETS; ++b)
+      g_variant_builder_add (&buckets, "u", method->buckets[b]);
+
+    g_variant_builder_add (&builder, "(suuu@au)", entry->name, method->calls,
+        method->calls ? (guint) (method->total / method->calls) : 0,
+        (guint) CLAMP (method->max, 0, G_MAXUINT),
+        g_variant_builder_end (&buckets));
+  }
+  G_UNLOCK (gst_switch_controller_methods);
+
+  return g_variant_builder_end (&builder);
 }
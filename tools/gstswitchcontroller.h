@@ -61,7 +61,9 @@ typedef struct _GstSwitchController
   GstSwitchServer *server;      /*!< the GstSwitchServer instance */
   GDBusServer *bus_server;      /*!< the dbus server instance */
   GMutex clients_lock;          /*!< the lock for %clients */
-  GList *clients;               /*!< the client list */
+  GPtrArray *clients;           /*!< the clients, replaced on changes */
+  GMutex coalesce_lock;         /*!< the lock for %coalesced */
+  GHashTable *coalesced;        /*!< the rate limited signals by key */
 } GstSwitchController;
 
 /**
@@ -72,7 +74,7 @@ typedef struct _GstSwitchController
 typedef struct _GstSwitchControllerClass
 {
   GObjectClass base_class;      /*!< the parent class */
-  GHashTable *methods;          /*!< the remote method table */
+  GHashTable *methods;          /*!< the remote methods by name */
 } GstSwitchControllerClass;
 
 GType gst_switch_controller_get_type (void);
@@ -84,14 +86,23 @@ void gst_switch_controller_tell_preview_port_removed (GstSwitchController *,
     gint port, gint serve, gint type);
 void gst_switch_controller_tell_new_mode_onlne (GstSwitchController *,
     gint mode);
+void gst_switch_controller_tell_previews_degraded (GstSwitchController *,
+    gint level, const gchar * step);
+void gst_switch_controller_tell_pip_adjusted (GstSwitchController *,
+    guint ticket, gint x, gint y, gint w, gint h);
 gboolean gst_switch_controller_select_face (GstSwitchController * controller,
     gint x, gint y);
 void gst_switch_controller_show_face_marker (GstSwitchController * controller,
     GVariant * faces);
 void gst_switch_controller_show_track_marker (GstSwitchController * controller,
     GVariant * faces);
+GVariant *gst_switch_controller_get_method_stats (GstSwitchController *
+    controller);
 
 extern const gchar gstswitchcontroller_introspection_xml[];
 extern gint gst_switch_controller_dbus_timeout;
+extern gint gst_switch_controller_signal_queue;
+extern gboolean gst_switch_controller_disconnect_stuck;
+extern gint gst_switch_controller_coalesce_window;
 
 #endif //__GST_SWITCH_CONTROLLER_H__
@@ -41,6 +41,9 @@ const gchar gstswitchcontroller_introspection_xml[] =
     "    <method name='get_preview_ports'>"
     "      <arg type='s' name='ports' direction='out'/>"
     "    </method>"
+    "    <method name='get_previews'>"
+    "      <arg type='a(iii)' name='previews' direction='out'/>"
+    "    </method>"
     "    <method name='set_composite_mode'>"
     "      <arg type='i' name='channel' direction='in'/>"
     "      <arg type='b' name='result' direction='out'/>"
@@ -55,6 +58,42 @@ const gchar gstswitchcontroller_introspection_xml[] =
     "    <method name='new_record'>"
     "      <arg type='b' name='result' direction='out'/>"
     "    </method>"
+    "    <method name='get_sink_stats'>"
+    "      <arg type='a(suuxxxtu)' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='set_record_encoder'>"
+    "      <arg type='s' name='encoder' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='replay_save'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='i' name='start' direction='in'/>"
+    "      <arg type='i' name='end' direction='in'/>"
+    "      <arg type='s' name='filename' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='replay_play'>"
+    "      <arg type='i' name='port' direction='in'/>"
+    "      <arg type='i' name='start' direction='in'/>"
+    "      <arg type='i' name='end' direction='in'/>"
+    "      <arg type='b' name='result' direction='out'/>"
+    "    </method>"
+    "    <method name='get_worker_timings'>"
+    "      <arg type='a(ssuuuuuau)' name='timings' direction='out'/>"
+    "    </method>"
+    "    <method name='get_bus_stats'>"
+    "      <arg type='a(siuuuuu)' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='get_queue_levels'>"
+    "      <arg type='a(sttu)' name='levels' direction='out'/>"
+    "    </method>"
+    "    <method name='get_method_stats'>"
+    "      <arg type='a(suuuau)' name='stats' direction='out'/>"
+    "    </method>"
+    "    <method name='execute_batch'>"
+    "      <arg type='a(sv)' name='ops' direction='in'/>"
+    "      <arg type='a(bv)' name='results' direction='out'/>"
+    "    </method>"
     "    <method name='adjust_pip'>"
     "      <arg type='i' name='dx' direction='in'/>"
     "      <arg type='i' name='dy' direction='in'/>"
@@ -62,6 +101,13 @@ const gchar gstswitchcontroller_introspection_xml[] =
     "      <arg type='i' name='dh' direction='in'/>"
     "      <arg type='u' name='result' direction='out'/>"
     "    </method>"
+    "    <method name='queue_adjust_pip'>"
+    "      <arg type='i' name='dx' direction='in'/>"
+    "      <arg type='i' name='dy' direction='in'/>"
+    "      <arg type='i' name='dw' direction='in'/>"
+    "      <arg type='i' name='dh' direction='in'/>"
+    "      <arg type='u' name='ticket' direction='out'/>"
+    "    </method>"
     "    <method name='switch'>"
     "      <arg type='i' name='channel' direction='in'/>"
     "      <arg type='i' name='port' direction='in'/>"
@@ -94,6 +140,17 @@ const gchar gstswitchcontroller_introspection_xml[] =
     "    <signal name='new_mode_online'>"
     "      <arg type='i' name='mode'/>"
     "    </signal>"
+    "    <signal name='previews_degraded'>"
+    "      <arg type='i' name='level'/>"
+    "      <arg type='s' name='step'/>"
+    "    </signal>"
+    "    <signal name='pip_adjusted'>"
+    "      <arg type='u' name='ticket'/>"
+    "      <arg type='i' name='x'/>"
+    "      <arg type='i' name='y'/>"
+    "      <arg type='i' name='w'/>"
+    "      <arg type='i' name='h'/>"
+    "    </signal>"
     "    <signal name='show_face_marker'>"
     "      <arg type='a(iiii)' name='mode'/>"
     "    </signal>"
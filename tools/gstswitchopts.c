@@ -25,6 +25,9 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+#include "gstswitchopts.h"
 
 
 typedef struct
@@ -265,3 +268,291 @@ parse_format (const gchar * format, GstCaps ** caps, GError ** error)
 
   return r;
 }
+
+static const gchar *encoder_names[] = {
+  [GST_SWITCH_ENCODER_RAW] = "raw",
+  [GST_SWITCH_ENCODER_MJPEG] = "mjpeg",
+  [GST_SWITCH_ENCODER_H264] = "h264",
+  [GST_SWITCH_ENCODER_FFV1] = "ffv1",
+};
+
+// x264enc speed-preset nicks, anything else is rejected.
+static const gchar *encoder_presets[] = {
+  "ultrafast", "superfast", "veryfast", "faster", "fast", "medium", "slow",
+  "slower", "veryslow", "placebo", NULL
+};
+
+/**
+ * gst_switch_encoder_init:
+ *
+ * Reset an encoder spec to the defaults of the given encoder type.
+ */
+void
+gst_switch_encoder_init (GstSwitchEncoder * enc, GstSwitchEncoderType type)
+{
+  memset (enc, 0, sizeof (*enc));
+  enc->type = type;
+  enc->bitrate = 4000;
+  enc->quality = 85;
+  strcpy (enc->preset, "veryfast");
+  enc->zerolatency = TRUE;
+}
+
+static gboolean
+parse_encoder_uint (const gchar * value, guint min, guint max, guint * out)
+{
+  gchar *end = NULL;
+  guint64 v = g_ascii_strtoull (value, &end, 10);
+  if (end == value || *end != '\0' || v < min || v > max)
+    return FALSE;
+  *out = (guint) v;
+  return TRUE;
+}
+
+static gboolean
+parse_encoder_param (GstSwitchEncoder * enc, const gchar * key,
+    const gchar * value)
+{
+  if (g_strcmp0 (key, "bitrate") == 0)
+    return parse_encoder_uint (value, 1, 1000000, &enc->bitrate);
+  if (g_strcmp0 (key, "quality") == 0)
+    return parse_encoder_uint (value, 1, 100, &enc->quality);
+  if (g_strcmp0 (key, "crf") == 0)
+    return parse_encoder_uint (value, 1, 51, &enc->crf);
+  if (g_strcmp0 (key, "threads") == 0)
+    return parse_encoder_uint (value, 0, 64, &enc->threads);
+  if (g_strcmp0 (key, "keyint") == 0)
+    return parse_encoder_uint (value, 0, 100000, &enc->keyint);
+  if (g_strcmp0 (key, "zerolatency") == 0) {
+    guint b;
+    if (!parse_encoder_uint (value, 0, 1, &b))
+      return FALSE;
+    enc->zerolatency = b;
+    return TRUE;
+  }
+  if (g_strcmp0 (key, "preset") == 0) {
+    gsize i;
+    for (i = 0; encoder_presets[i] != NULL; ++i) {
+      if (g_strcmp0 (encoder_presets[i], value) == 0) {
+        g_strlcpy (enc->preset, value, sizeof (enc->preset));
+        return TRUE;
+      }
+    }
+  }
+  return FALSE;
+}
+
+// Parse an encoder spec into it's bits.
+//  [Encoder][:key=value[,key=value...]]
+//
+// The encoder is one of raw, mjpeg, h264 or ffv1, keys are bitrate (kbit/s),
+// quality, crf, preset, threads, keyint and zerolatency. E.g.
+//  h264:bitrate=2000,threads=2,zerolatency=1
+int
+parse_encoder (const gchar * spec, GstSwitchEncoder * enc, GError ** error)
+{
+  GstSwitchEncoder parsed;
+  gchar **parts = NULL, **params = NULL;
+  gsize i;
+  int r = -1;
+
+  if (spec == NULL || *spec == '\0')
+    goto parse_encoder_error;
+
+  parts = g_strsplit (spec, ":", 2);
+  for (i = 0; i < G_N_ELEMENTS (encoder_names); ++i) {
+    if (g_ascii_strcasecmp (parts[0], encoder_names[i]) == 0)
+      break;
+  }
+  if (i == G_N_ELEMENTS (encoder_names))
+    goto parse_encoder_error;
+
+  gst_switch_encoder_init (&parsed, (GstSwitchEncoderType) i);
+
+  if (parts[1] != NULL) {
+    params = g_strsplit (parts[1], ",", -1);
+    for (i = 0; params[i] != NULL; ++i) {
+      gchar **kv = g_strsplit (params[i], "=", 2);
+      gboolean ok = kv[0] != NULL && kv[1] != NULL
+          && parse_encoder_param (&parsed, kv[0], kv[1]);
+      g_strfreev (kv);
+      if (!ok)
+        goto parse_encoder_error;
+    }
+  }
+
+  if (enc != NULL)
+    *enc = parsed;
+  r = 0;
+
+parse_encoder_error:
+  if (r != 0 && error != NULL) {
+    GError *err = g_error_new (G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "Invalid encoder specified: %s\n", spec ? spec : "");
+    g_propagate_error (error, err);
+  }
+  g_strfreev (params);
+  g_strfreev (parts);
+  return r;
+}
+
+/**
+ * gst_switch_encoder_is_valid:
+ *
+ * Check an encoder spec before it is turned into elements, parse_encoder()
+ * only produces valid ones but the recorders scale them afterwards.
+ *
+ * @return TRUE if every value of the spec is in range
+ */
+gboolean
+gst_switch_encoder_is_valid (const GstSwitchEncoder * enc)
+{
+  guint i;
+
+  if (enc == NULL)
+    return FALSE;
+
+  switch (enc->type) {
+    case GST_SWITCH_ENCODER_RAW:
+    case GST_SWITCH_ENCODER_FFV1:
+      return TRUE;
+    case GST_SWITCH_ENCODER_MJPEG:
+      return enc->quality >= 1 && enc->quality <= 100;
+    case GST_SWITCH_ENCODER_H264:
+      if (enc->crf > 51 || (enc->crf == 0 && enc->bitrate == 0))
+        return FALSE;
+      for (i = 0; encoder_presets[i] != NULL; ++i) {
+        if (g_strcmp0 (encoder_presets[i], enc->preset) == 0)
+          return TRUE;
+      }
+      return FALSE;
+    default:
+      return FALSE;
+  }
+}
+
+// Parse a burst-on-connect spec.
+//  none | keyframe | frames:[N]
+int
+parse_burst (const gchar * spec, GstSwitchBurst * burst, GError ** error)
+{
+  GstSwitchBurst parsed = { GST_SWITCH_BURST_NONE, 0 };
+
+  if (spec == NULL)
+    goto parse_burst_error;
+
+  if (g_ascii_strcasecmp (spec, "none") == 0) {
+    parsed.mode = GST_SWITCH_BURST_NONE;
+  } else if (g_ascii_strcasecmp (spec, "keyframe") == 0) {
+    parsed.mode = GST_SWITCH_BURST_KEYFRAME;
+  } else if (g_ascii_strncasecmp (spec, "frames:", 7) == 0) {
+    parsed.mode = GST_SWITCH_BURST_FRAMES;
+    if (!parse_encoder_uint (spec + 7, 1, 1000, &parsed.frames))
+      goto parse_burst_error;
+  } else {
+    goto parse_burst_error;
+  }
+
+  if (burst != NULL)
+    *burst = parsed;
+  return 0;
+
+parse_burst_error:
+  if (error != NULL) {
+    GError *err = g_error_new (G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "Invalid burst specified: %s\n", spec ? spec : "");
+    g_propagate_error (error, err);
+  }
+  return -1;
+}
+
+static const gchar *client_limit_units[] = {
+  [GST_SWITCH_CLIENT_LIMIT_NONE] = "none",
+  [GST_SWITCH_CLIENT_LIMIT_BUFFERS] = "buffers",
+  [GST_SWITCH_CLIENT_LIMIT_BYTES] = "bytes",
+  [GST_SWITCH_CLIENT_LIMIT_TIME] = "time",
+};
+
+// Parse a per-client backlog limit, the hard limit defaults to twice the
+// soft limit.
+//  none | [Unit]:[Soft][:Hard]
+// where unit is buffers, bytes or time (milliseconds).
+int
+parse_client_limit (const gchar * spec, GstSwitchClientLimit * limit,
+    GError ** error)
+{
+  gchar **parts = NULL;
+  gchar *end = NULL;
+  guint64 soft = 0, hard = 0;
+  gsize i;
+  int r = -1;
+
+  if (spec == NULL)
+    goto parse_client_limit_error;
+
+  parts = g_strsplit (spec, ":", 3);
+  for (i = 0; i < G_N_ELEMENTS (client_limit_units); ++i) {
+    if (g_ascii_strcasecmp (parts[0], client_limit_units[i]) == 0)
+      break;
+  }
+  if (i == G_N_ELEMENTS (client_limit_units))
+    goto parse_client_limit_error;
+
+  if (i != GST_SWITCH_CLIENT_LIMIT_NONE) {
+    if (parts[1] == NULL)
+      goto parse_client_limit_error;
+    soft = g_ascii_strtoull (parts[1], &end, 10);
+    if (end == parts[1] || *end != '\0' || soft == 0)
+      goto parse_client_limit_error;
+    hard = soft * 2;
+    if (parts[2] != NULL) {
+      hard = g_ascii_strtoull (parts[2], &end, 10);
+      if (end == parts[2] || *end != '\0' || hard < soft)
+        goto parse_client_limit_error;
+    }
+  } else if (parts[1] != NULL) {
+    goto parse_client_limit_error;
+  }
+
+  if (limit != NULL) {
+    limit->unit = (GstSwitchClientLimitUnit) i;
+    limit->soft = soft;
+    limit->hard = hard;
+  }
+  r = 0;
+
+parse_client_limit_error:
+  if (r != 0 && error != NULL) {
+    GError *err = g_error_new (G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "Invalid client limit specified: %s\n", spec ? spec : "");
+    g_propagate_error (error, err);
+  }
+  g_strfreev (parts);
+  return r;
+}
+
+// Parse the drop behaviour of a per-client backlog limit.
+//  oldest | keyframe
+int
+parse_client_drop (const gchar * spec, GstSwitchClientLimit * limit,
+    GError ** error)
+{
+  GstSwitchClientDrop drop;
+
+  if (g_strcmp0 (spec, "oldest") == 0) {
+    drop = GST_SWITCH_CLIENT_DROP_OLDEST;
+  } else if (g_strcmp0 (spec, "keyframe") == 0) {
+    drop = GST_SWITCH_CLIENT_DROP_TO_KEYFRAME;
+  } else {
+    if (error != NULL) {
+      GError *err = g_error_new (G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+          "Invalid client drop specified: %s\n", spec ? spec : "");
+      g_propagate_error (error, err);
+    }
+    return -1;
+  }
+
+  if (limit != NULL)
+    limit->drop = drop;
+  return 0;
+}
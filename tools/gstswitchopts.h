@@ -0,0 +1,141 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_SWITCH_OPTS_H__
+#define __GST_SWITCH_OPTS_H__
+
+#include <gst/gst.h>
+
+/**
+ * GstSwitchEncoderType:
+ *
+ * The video encoders an encoder spec can select.
+ */
+typedef enum
+{
+  GST_SWITCH_ENCODER_RAW,       /*!< no encoding, raw video */
+  GST_SWITCH_ENCODER_MJPEG,     /*!< jpegenc */
+  GST_SWITCH_ENCODER_H264,      /*!< x264enc + h264parse */
+  GST_SWITCH_ENCODER_FFV1,      /*!< avenc_ffv1, lossless */
+} GstSwitchEncoderType;
+
+#define GST_SWITCH_ENCODER_PRESET_LEN 16
+
+/**
+ * GstSwitchEncoder:
+ *  @param type the encoder to use
+ *  @param bitrate target bitrate in kbit/s (h264)
+ *  @param quality encoding quality 1-100 (mjpeg)
+ *  @param crf constant rate factor 1-51 (h264), 0 if unset to use the bitrate
+ *  @param preset the speed preset name (h264)
+ *  @param threads number of encoder threads, 0 for the encoder default
+ *  @param keyint maximum frames between keyframes, 0 for the encoder default
+ *  @param zerolatency tune the encoder for zero latency (h264)
+ */
+typedef struct _GstSwitchEncoder
+{
+  GstSwitchEncoderType type;
+  guint bitrate;
+  guint quality;
+  guint crf;
+  gchar preset[GST_SWITCH_ENCODER_PRESET_LEN];
+  guint threads;
+  guint keyint;
+  gboolean zerolatency;
+} GstSwitchEncoder;
+
+/**
+ * GstSwitchBurstMode:
+ *
+ * What a newly connected output client is sent before live data.
+ */
+typedef enum
+{
+  GST_SWITCH_BURST_NONE,        /*!< wait for the next buffer */
+  GST_SWITCH_BURST_FRAMES,      /*!< the last N buffers */
+  GST_SWITCH_BURST_KEYFRAME,    /*!< everything since the last keyframe */
+} GstSwitchBurstMode;
+
+/**
+ * GstSwitchBurst:
+ *  @param mode the burst mode
+ *  @param frames the number of buffers sent for GST_SWITCH_BURST_FRAMES
+ */
+typedef struct _GstSwitchBurst
+{
+  GstSwitchBurstMode mode;
+  guint frames;
+} GstSwitchBurst;
+
+/**
+ * GstSwitchClientLimitUnit:
+ *
+ * The unit a per-client output backlog is measured in.
+ */
+typedef enum
+{
+  GST_SWITCH_CLIENT_LIMIT_NONE, /*!< unlimited backlog */
+  GST_SWITCH_CLIENT_LIMIT_BUFFERS,      /*!< number of buffers */
+  GST_SWITCH_CLIENT_LIMIT_BYTES,        /*!< number of bytes */
+  GST_SWITCH_CLIENT_LIMIT_TIME, /*!< milliseconds of data */
+} GstSwitchClientLimitUnit;
+
+/**
+ * GstSwitchClientDrop:
+ *
+ * What is dropped when a client backlog passes the soft limit.
+ */
+typedef enum
+{
+  GST_SWITCH_CLIENT_DROP_OLDEST,        /*!< drop back to the soft limit */
+  GST_SWITCH_CLIENT_DROP_TO_KEYFRAME,   /*!< skip to the latest keyframe */
+} GstSwitchClientDrop;
+
+/**
+ * GstSwitchClientLimit:
+ *  @param unit the unit of soft and hard
+ *  @param soft backlog at which data is dropped for the client
+ *  @param hard backlog at which the client is disconnected
+ *  @param drop what to drop at the soft limit
+ */
+typedef struct _GstSwitchClientLimit
+{
+  GstSwitchClientLimitUnit unit;
+  guint64 soft;
+  guint64 hard;
+  GstSwitchClientDrop drop;
+} GstSwitchClientLimit;
+
+int parse_format (const gchar * format, GstCaps ** caps, GError ** error);
+
+void gst_switch_encoder_init (GstSwitchEncoder * enc,
+    GstSwitchEncoderType type);
+int parse_encoder (const gchar * spec, GstSwitchEncoder * enc,
+    GError ** error);
+gboolean gst_switch_encoder_is_valid (const GstSwitchEncoder * enc);
+
+int parse_burst (const gchar * spec, GstSwitchBurst * burst, GError ** error);
+int parse_client_limit (const gchar * spec, GstSwitchClientLimit * limit,
+    GError ** error);
+int parse_client_drop (const gchar * spec, GstSwitchClientLimit * limit,
+    GError ** error);
+
+#endif //__GST_SWITCH_OPTS_H__
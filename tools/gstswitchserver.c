@@ -28,7 +28,12 @@
 #include <stdlib.h>
 #include "gstswitchserver.h"
 #include "gstrecorder.h"
+#include "gstreplay.h"
 #include "gstcase.h"
+#include "gstsinkpolicy.h"
+#include "gstworkerscheduler.h"
+#include "gstworkertaskpool.h"
+#include "gstworkerbuilder.h"
 #include "./gio/gsocketinputstream.h"
 #include "../logutils.h"
 
@@ -48,6 +53,13 @@
 #define GST_SWITCH_SERVER_HOST_SPEC "%q"
 #define GST_SWITCH_SERVER_DEFAULT_RECORD_FILE "recording-%q-%Y%m%d-%H%M%S"
 #define GST_SWITCH_SERVER_DEFAULT_RECORD_EXT ".mkv"
+#define GST_SWITCH_SERVER_DEFAULT_RECORD_RING 0   /* MB */
+#define GST_SWITCH_SERVER_DEFAULT_ISO_MAX_ENCODERS 4
+#define GST_SWITCH_SERVER_DEFAULT_REPLAY_SIZE 256       /* MB */
+#define GST_SWITCH_SERVER_DEFAULT_BUS_THREADS 0
+#define GST_SWITCH_SERVER_DEFAULT_GOVERNOR_INTERVAL 0   /* ms */
+#define GST_SWITCH_SERVER_DEFAULT_QUEUE_MEMORY 0        /* MB */
+#define GST_SWITCH_SERVER_DEFAULT_QUEUE_LATENCY -1      /* from the profile */
 
 #define GST_SWITCH_SERVER_LOCK_MAIN_LOOP(srv) (g_mutex_lock (&(srv)->main_loop_lock))
 #define GST_SWITCH_SERVER_UNLOCK_MAIN_LOOP(srv) (g_mutex_unlock (&(srv)->main_loop_lock))
@@ -78,7 +90,16 @@ GstSwitchServerOpts opts = {
   GST_SWITCH_SERVER_DEFAULT_AUDIO_ACCEPTOR_PORT,
 //FALSE,
   FALSE,
-  NULL, NULL
+  NULL, NULL, NULL,
+  {0}, {0}, {0},
+  NULL, 0, 0,
+  GST_SWITCH_SERVER_DEFAULT_RECORD_RING, FALSE,
+  FALSE, NULL, GST_SWITCH_SERVER_DEFAULT_ISO_MAX_ENCODERS,
+  0, GST_SWITCH_SERVER_DEFAULT_REPLAY_SIZE, FALSE, NULL,
+  0, NULL, 0, GST_SWITCH_SERVER_DEFAULT_BUS_THREADS,
+  GST_SWITCH_SERVER_DEFAULT_GOVERNOR_INTERVAL,
+  GST_SWITCH_SERVER_DEFAULT_QUEUE_MEMORY,
+  GST_SWITCH_SERVER_DEFAULT_QUEUE_LATENCY
 };
 
 gboolean verbose = FALSE;
@@ -133,10 +154,6 @@ gparse_record_filename (gchar * name, gchar * value, gpointer data,
   return TRUE;
 }
 
-
-extern int
-parse_format (const gchar * format, GstCaps ** final_caps, GError ** err);
-
 static gboolean
 gparse_video_format (gchar * name, gchar * value, gpointer data,
     GError ** error)
@@ -146,6 +163,146 @@ gparse_video_format (gchar * name, gchar * value, gpointer data,
   return TRUE;
 }
 
+static gboolean
+gparse_output_encoder (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (parse_encoder (value, &opts.output_encoder, error) == -1)
+    return FALSE;
+  return TRUE;
+}
+
+static gboolean
+gparse_output_burst (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (parse_burst (value, &opts.output_burst, error) == -1)
+    return FALSE;
+  return TRUE;
+}
+
+static gboolean
+gparse_record_encoder (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (parse_encoder (value, NULL, error) == -1)
+    return FALSE;
+  g_free (opts.record_encoder);
+  opts.record_encoder = g_strdup (value);
+  return TRUE;
+}
+
+static gboolean
+gparse_iso_encoder (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (parse_encoder (value, NULL, error) == -1)
+    return FALSE;
+  g_free (opts.iso_encoder);
+  opts.iso_encoder = g_strdup (value);
+  return TRUE;
+}
+
+static gboolean
+gparse_proxy_encoder (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (parse_encoder (value, NULL, error) == -1)
+    return FALSE;
+  g_free (opts.proxy_encoder);
+  opts.proxy_encoder = g_strdup (value);
+  return TRUE;
+}
+
+static gboolean
+gparse_replay_encoder (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (parse_encoder (value, NULL, error) == -1)
+    return FALSE;
+  g_free (opts.replay_encoder);
+  opts.replay_encoder = g_strdup (value);
+  return TRUE;
+}
+
+/* gparse_record_split:
+ * Parse the --record-split-time and --record-split-size options, which
+ * must not be negative
+ */
+static gboolean
+gparse_record_split (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  gchar *end = NULL;
+  guint64 v = g_ascii_strtoull (value, &end, 10);
+
+  if (end == value || *end != '\0' || v > G_MAXINT) {
+    g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "invalid value for %s: %s", name, value);
+    return FALSE;
+  }
+  if (g_strcmp0 (name, "--record-split-time") == 0)
+    opts.record_split_time = (gint) v;
+  else
+    opts.record_split_size = (gint) v;
+  return TRUE;
+}
+
+static gboolean
+gparse_client_limit (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (parse_client_limit (value, &opts.client_limit, error) == -1)
+    return FALSE;
+  return TRUE;
+}
+
+static gboolean
+gparse_client_drop (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (parse_client_drop (value, &opts.client_limit, error) == -1)
+    return FALSE;
+  return TRUE;
+}
+
+static gboolean
+gparse_task_pool (gchar * name, gchar * value, gpointer data, GError ** error)
+{
+  if (!gst_worker_task_pool_configure (value)) {
+    g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "invalid task pool: %s", value);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static gboolean
+gparse_priority (gchar * name, gchar * value, gpointer data, GError ** error)
+{
+  if (!gst_worker_priority_configure (value)) {
+    g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "invalid priority: %s", value);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/* gparse_latency_profile:
+ * Parse the --latency-profile option
+ */
+static gboolean
+gparse_latency_profile (gchar * name, gchar * value, gpointer data,
+    GError ** error)
+{
+  if (!gst_worker_latency_configure (value)) {
+    g_set_error (error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+        "invalid latency profile: %s", value);
+    return FALSE;
+  }
+  return TRUE;
+}
+
 static gboolean caps_dumped = FALSE;
 
 /* gst_switch_server_getcaps:
@@ -210,14 +367,112 @@ static GOptionEntry entries[] = {
   {"dbus-timeout", 'd', 0, G_OPTION_ARG_INT,
         &gst_switch_controller_dbus_timeout,
       "DBus timeout in msec (default 5000)"},
+  {"signal-queue", 0, 0, G_OPTION_ARG_INT,
+        &gst_switch_controller_signal_queue,
+        "Queue at most NUM D-Bus signals for a client that doesn't read "
+        "them (default 64)", "NUM"},
+  {"disconnect-stuck", 0, 0, G_OPTION_ARG_NONE,
+        &gst_switch_controller_disconnect_stuck,
+        "Disconnect clients with a full signal queue or not reading for the "
+        "DBus timeout, instead of dropping their oldest signals"},
+  {"coalesce-window", 0, 0, G_OPTION_ARG_INT,
+        &gst_switch_controller_coalesce_window,
+        "Send the face markers and the changes of each preview port at most "
+        "once per MSEC, the latest of them (default 100, 0 sends all)",
+      "MSEC"},
   {"record", 'r', G_OPTION_FLAG_OPTIONAL_ARG, G_OPTION_ARG_CALLBACK,
         (gpointer) gparse_record_filename,
       "Enable recorder and record into the specified FILENAME"},
+  {"record-encoder", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_record_encoder,
+        "Encode recordings with mjpeg:quality=N, ffv1 or "
+        "h264:crf=N,preset=NAME,threads=N (default "
+        GST_RECORDER_DEFAULT_ENCODER ")", "ENCODER"},
+  {"record-split-time", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_record_split,
+      "Start a new recording file every NUM seconds", "NUM"},
+  {"record-split-size", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_record_split,
+        "Start a new recording file every NUM megabytes, at the next "
+        "keyframe past it", "NUM"},
+  {"record-ring", 0, 0, G_OPTION_ARG_INT, &opts.record_ring,
+      "Buffer NUM megabytes of recording in RAM against disk stalls, "
+      "0 writes synchronously (default 0)", "NUM"},
+  {"record-direct-io", 0, 0, G_OPTION_ARG_NONE, &opts.record_direct_io,
+      "Write recordings with O_DIRECT, bypassing the page cache"},
+  {"record-iso", 0, 0, G_OPTION_ARG_NONE, &opts.record_iso,
+      "Also record every video input to its own file"},
+  {"iso-encoder", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_iso_encoder,
+        "Encode ISO recordings with ENCODER (default "
+        GST_RECORDER_DEFAULT_ISO_ENCODER ")", "ENCODER"},
+  {"iso-max-encoders", 0, 0, G_OPTION_ARG_INT, &opts.iso_max_encoders,
+        "Encode up to NUM ISO recordings at full quality, lower the quality "
+        "of all of them beyond that (default 4)", "NUM"},
+  {"record-proxy", 0, 0, G_OPTION_ARG_INT, &opts.record_proxy,
+      "Also record a proxy of the composite at NUM lines, e.g. 360", "NUM"},
+  {"proxy-encoder", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_proxy_encoder,
+        "Encode the proxy recording with ENCODER (default "
+        GST_RECORDER_DEFAULT_PROXY_ENCODER ")", "ENCODER"},
+  {"replay", 0, 0, G_OPTION_ARG_INT, &opts.replay_seconds,
+      "Keep the last NUM seconds of the output in memory for replays", "NUM"},
+  {"replay-size", 0, 0, G_OPTION_ARG_INT, &opts.replay_size,
+      "Size of each replay ring in megabytes (default 256)", "NUM"},
+  {"replay-inputs", 0, 0, G_OPTION_ARG_NONE, &opts.replay_inputs,
+      "Also keep every video input for replays"},
+  {"replay-encoder", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_replay_encoder,
+        "Encode the replay rings with ENCODER, raw needs a large ring "
+        "(default " GST_REPLAY_DEFAULT_ENCODER ")", "ENCODER"},
+  {"worker-threads", 0, 0, G_OPTION_ARG_INT, &opts.worker_threads,
+      "Start and stop up to NUM workers at once (default one per CPU)",
+      "NUM"},
+  {"bus-threads", 0, 0, G_OPTION_ARG_INT, &opts.bus_threads,
+        "Dispatch pipeline messages in NUM threads, 0 in the main loop "
+        "(default 0)", "NUM"},
+  {"task-pool", 0, 0, G_OPTION_ARG_CALLBACK, (gpointer) gparse_task_pool,
+        "Share streaming threads per worker class (case, composite, output, "
+        "default) with a thread budget and processors, e.g. "
+        "case:64,composite:16:0-3", "CLASS:NUM[:CPUS],..."},
+  {"priority", 0, 0, G_OPTION_ARG_CALLBACK, (gpointer) gparse_priority,
+        "Set the nice value, or rtN for SCHED_RR, and processors of the "
+        "program, ingest, preview or ui streaming threads (default none), "
+        "e.g. program:-5,preview:10", "CLASS:SETTING[:CPUS],..."},
+  {"governor", 0, 0, G_OPTION_ARG_INT, &opts.governor_interval,
+        "Check every NUM ms if the output is late and degrade the previews "
+        "if so, 0 never does (default 0)", "NUM"},
+  {"queue-memory", 0, 0, G_OPTION_ARG_INT, &opts.queue_memory,
+        "Share NUM MB between the queues of all pipelines, 0 for no limit "
+        "(default 0)", "NUM"},
+  {"queue-latency", 0, 0, G_OPTION_ARG_INT, &opts.queue_latency,
+        "Queue at most NUM ms of media in each queue, 0 for no limit "
+        "(default from the latency profile)", "NUM"},
+  {"latency-profile", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_latency_profile,
+        "Trade latency for smoothness in every pipeline: ultra-low, "
+        "balanced or safe (default balanced)", "PROFILE"},
   {"low-resolution", 'l', 0, G_OPTION_ARG_NONE, &opts.low_res,
       "Enable low resolution mode (-f overrides)"},
   {"video-format", 'f', 0, G_OPTION_ARG_CALLBACK,
         (gpointer) gparse_video_format,
       "Specify the video format to use (shortcuts supported)"},
+  {"output-encoder", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_output_encoder,
+        "Encode the composite output port, e.g. "
+        "h264:bitrate=2000,threads=2 (default raw)", "ENCODER"},
+  {"output-burst", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_output_burst,
+        "Send new output clients keyframe or frames:N before live data "
+        "(default none)", "BURST"},
+  {"client-limit", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_client_limit,
+        "Limit the backlog of each output client, e.g. buffers:50, "
+        "bytes:8000000 or time:500[:2000] (default none)", "LIMIT"},
+  {"client-drop", 0, 0, G_OPTION_ARG_CALLBACK,
+        (gpointer) gparse_client_drop,
+        "Drop oldest data or skip to the latest keyframe when a client "
+        "passes its limit (default oldest)", "oldest|keyframe"},
   {"video-input-port", 'p', 0, G_OPTION_ARG_INT, &opts.video_input_port,
       "Specify the video input listen port.", "NUM"},
   {"audio-input-port", 'a', 0, G_OPTION_ARG_INT, &opts.audio_input_port,
@@ -277,11 +532,19 @@ gst_switch_server_init (GstSwitchServer * srv)
   srv->cases = NULL;
   srv->composite = NULL;
   srv->alloc_port_count = 0;
+  srv->governor = NULL;
 
   srv->pip_x = 0;
   srv->pip_y = 0;
   srv->pip_w = 0;
   srv->pip_h = 0;
+  srv->pip_dx = 0;
+  srv->pip_dy = 0;
+  srv->pip_dw = 0;
+  srv->pip_dh = 0;
+  srv->pip_ticket = 0;
+  srv->pip_source = 0;
+  srv->pip_applied = 0;
 
   srv->clock = gst_system_clock_obtain ();
 
@@ -307,6 +570,11 @@ gst_switch_server_finalize (GstSwitchServer * srv)
 {
   INFO ("gst_switch_server finalize %p", srv);
 
+  if (srv->governor) {
+    gst_load_governor_free (srv->governor);
+    srv->governor = NULL;
+  }
+
   g_free (srv->host);
   srv->host = NULL;
 
@@ -345,11 +613,24 @@ gst_switch_server_finalize (GstSwitchServer * srv)
     srv->cases = NULL;
   }
 
+  if (srv->isos) {
+    g_list_free_full (srv->isos, (GDestroyNotify) g_object_unref);
+    srv->isos = NULL;
+  }
+
+  if (srv->replays) {
+    g_list_free_full (srv->replays, (GDestroyNotify) g_object_unref);
+    srv->replays = NULL;
+  }
+
   if (srv->composite) {
     g_object_unref (srv->composite);
     srv->composite = NULL;
   }
 
+  if (srv->pip_source)
+    g_source_remove (srv->pip_source);
+
   gst_object_unref (srv->clock);
 
   g_mutex_clear (&srv->main_loop_lock);
@@ -427,6 +708,214 @@ gst_switch_server_revoke_port (GstSwitchServer * srv, int port)
   g_mutex_unlock (&srv->alloc_port_lock);
 }
 
+/**
+ * gst_switch_server_share_iso:
+ *
+ * Share the CPU between the ISO recordings. Up to opts.iso_max_encoders of
+ * them are encoded at full quality, beyond that the quality of all of them
+ * drops in proportion, so more cameras cost quality rather than CPU. Must
+ * be called with the recorder lock held.
+ */
+static void
+gst_switch_server_share_iso (GstSwitchServer * srv)
+{
+  gint count = g_list_length (srv->isos);
+  gint quality = 100;
+  GList *item;
+
+  if (0 < opts.iso_max_encoders && opts.iso_max_encoders < count)
+    quality = 100 * opts.iso_max_encoders / count;
+
+  for (item = srv->isos; item; item = g_list_next (item))
+    gst_recorder_set_quality (GST_RECORDER (item->data), quality);
+}
+
+/**
+ * gst_switch_server_end_iso:
+ *
+ * Invoked when an ISO recorder is ended.
+ */
+static void
+gst_switch_server_end_iso (GstRecorder * iso, GstSwitchServer * srv)
+{
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  if (g_list_find (srv->isos, iso)) {
+    srv->isos = g_list_remove (srv->isos, iso);
+    gst_switch_server_share_iso (srv);
+    INFO ("Removed %s (%d ISO recordings left)", GST_WORKER (iso)->name,
+        g_list_length (srv->isos));
+    g_object_unref (iso);
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+}
+
+/**
+ * gst_switch_server_start_iso:
+ *
+ * Start the ISO recording of a video input, if enabled.
+ */
+static void
+gst_switch_server_start_iso (GstSwitchServer * srv, GstCase * input)
+{
+  GstRecorder *iso;
+  gchar *name;
+
+  if (!opts.record_iso || !opts.record_filename)
+    return;
+
+  name = g_strdup_printf ("iso_%d", input->sink_port);
+  iso = GST_RECORDER (g_object_new (GST_TYPE_RECORDER, "name", name,
+          "channel", GST_WORKER (input)->name,
+          "width", srv->composite->width,
+          "height", srv->composite->height,
+          "encoder", opts.iso_encoder ? opts.iso_encoder :
+          GST_RECORDER_DEFAULT_ISO_ENCODER, NULL));
+  g_free (name);
+
+  g_signal_connect (iso, "end-worker",
+      G_CALLBACK (gst_switch_server_end_iso), srv);
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  srv->isos = g_list_append (srv->isos, iso);
+  gst_switch_server_share_iso (srv);
+  if (!gst_worker_start (GST_WORKER (iso))) {
+    ERROR ("failed to start %s", GST_WORKER (iso)->name);
+    srv->isos = g_list_remove (srv->isos, iso);
+    gst_switch_server_share_iso (srv);
+    g_object_unref (iso);
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+}
+
+/**
+ * gst_switch_server_stop_iso:
+ *
+ * Stop the ISO recording of a video input, it is removed once it ended.
+ */
+static void
+gst_switch_server_stop_iso (GstSwitchServer * srv, GstCase * input)
+{
+  GstRecorder *iso = NULL;
+  GList *item;
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  for (item = srv->isos; item; item = g_list_next (item)) {
+    GstRecorder *rec = GST_RECORDER (item->data);
+    if (g_strcmp0 (rec->channel, GST_WORKER (input)->name) == 0) {
+      iso = GST_RECORDER (g_object_ref (rec));
+      break;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+
+  if (iso) {
+    gst_worker_stop (GST_WORKER (iso));
+    g_object_unref (iso);
+  }
+}
+
+/**
+ * gst_switch_server_end_replay:
+ *
+ * Invoked when a replay ring is ended.
+ */
+static void
+gst_switch_server_end_replay (GstReplay * replay, GstSwitchServer * srv)
+{
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  if (g_list_find (srv->replays, replay)) {
+    srv->replays = g_list_remove (srv->replays, replay);
+    INFO ("Removed %s", GST_WORKER (replay)->name);
+    g_object_unref (replay);
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+}
+
+/**
+ * gst_switch_server_start_replay:
+ * @channel: the channel to keep
+ * @port: the input port, or 0 for the output
+ *
+ * Start keeping the last seconds of a channel for replays, if enabled.
+ */
+static void
+gst_switch_server_start_replay (GstSwitchServer * srv, const gchar * channel,
+    gint port)
+{
+  GstReplay *replay;
+  gchar *name;
+
+  if (opts.replay_seconds <= 0 || (port && !opts.replay_inputs))
+    return;
+
+  name = port ? g_strdup_printf ("replay_%d", port) : g_strdup ("replay");
+  replay = GST_REPLAY (g_object_new (GST_TYPE_REPLAY, "name", name,
+          "channel", channel,
+          "width", srv->composite->width,
+          "height", srv->composite->height,
+          "seconds", opts.replay_seconds,
+          "size", MAX (opts.replay_size, 1),
+          "encoder", opts.replay_encoder ? opts.replay_encoder :
+          GST_REPLAY_DEFAULT_ENCODER, NULL));
+  g_free (name);
+
+  g_signal_connect (replay, "end-worker",
+      G_CALLBACK (gst_switch_server_end_replay), srv);
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  srv->replays = g_list_append (srv->replays, replay);
+  if (!gst_worker_start (GST_WORKER (replay))) {
+    ERROR ("failed to start %s", GST_WORKER (replay)->name);
+    srv->replays = g_list_remove (srv->replays, replay);
+    g_object_unref (replay);
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+}
+
+/**
+ * gst_switch_server_find_replay:
+ * @port: the input port, or 0 for the output
+ * @return: a new reference to the replay ring of the port, or NULL
+ */
+static GstReplay *
+gst_switch_server_find_replay (GstSwitchServer * srv, gint port)
+{
+  GstReplay *replay = NULL;
+  gchar *channel;
+  GList *item;
+
+  channel = port ? g_strdup_printf ("input_%d", port) :
+      g_strdup ("composite_video");
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  for (item = srv->replays; item; item = g_list_next (item)) {
+    if (g_strcmp0 (GST_REPLAY (item->data)->channel, channel) == 0) {
+      replay = GST_REPLAY (g_object_ref (item->data));
+      break;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+
+  g_free (channel);
+  return replay;
+}
+
+/**
+ * gst_switch_server_stop_replay:
+ *
+ * Stop the replay ring of an input, it is removed once it ended.
+ */
+static void
+gst_switch_server_stop_replay (GstSwitchServer * srv, gint port)
+{
+  GstReplay *replay = gst_switch_server_find_replay (srv, port);
+
+  if (replay) {
+    gst_worker_stop (GST_WORKER (replay));
+    g_object_unref (replay);
+  }
+}
+
 /**
  * gst_switch_server_end_case:
  *
@@ -450,6 +939,10 @@ gst_switch_server_end_case (GstCase * cas, GstSwitchServer * srv)
       break;
     case GST_CASE_INPUT_AUDIO:
     case GST_CASE_INPUT_VIDEO:
+      if (cas->type == GST_CASE_INPUT_VIDEO) {
+        gst_switch_server_stop_iso (srv, cas);
+        gst_switch_server_stop_replay (srv, cas->sink_port);
+      }
       srv->cases = g_list_remove (srv->cases, cas);
       INFO ("Removed %s %p (%d cases left)", GST_WORKER (cas)->name, cas,
           g_list_length (srv->cases));
@@ -624,6 +1117,8 @@ gst_switch_server_serve (GstSwitchServer * srv, GSocket * client,
   gint port = 0;
   GCallback start_callback = G_CALLBACK (gst_switch_server_start_case);
   GCallback end_callback = G_CALLBACK (gst_switch_server_end_case);
+  GstWorkerScheduler *scheduler;
+  gboolean started;
 
   GST_SWITCH_SERVER_LOCK_SERVE (srv);
   GST_SWITCH_SERVER_LOCK_CASES (srv);
@@ -708,18 +1203,31 @@ gst_switch_server_serve (GstSwitchServer * srv, GSocket * client,
         "bheight", srv->composite->b_height, NULL);
   }
 
+  if (srv->governor) {
+    const GstLoadGovernorStep *step =
+        gst_load_governor_get_step (srv->governor);
+    gst_case_degrade (branch, step->rate, step->scale, step->idle);
+  }
+
   g_signal_connect (branch, "start-worker", start_callback, srv);
   g_signal_connect (input, "end-worker", end_callback, srv);
   g_signal_connect (branch, "end-worker", end_callback, srv);
   g_signal_connect (workcase, "end-worker", end_callback, srv);
 
-  if (!gst_worker_start (GST_WORKER (input)))
-    goto error_start_branch;
-  if (!gst_worker_start (GST_WORKER (branch)))
-    goto error_start_branch;
-  if (!gst_worker_start (GST_WORKER (workcase)))
+  scheduler = gst_worker_scheduler_new ();
+  gst_worker_scheduler_start (scheduler, GST_WORKER (input), NULL);
+  gst_worker_scheduler_start (scheduler, GST_WORKER (branch), NULL);
+  gst_worker_scheduler_start (scheduler, GST_WORKER (workcase), NULL);
+  started = gst_worker_scheduler_run (scheduler);
+  gst_worker_scheduler_free (scheduler);
+  if (!started)
     goto error_start_workcase;
 
+  if (serve_type == GST_SERVE_VIDEO_STREAM) {
+    gst_switch_server_start_iso (srv, input);
+    gst_switch_server_start_replay (srv, GST_WORKER (input)->name, port);
+  }
+
   GST_SWITCH_SERVER_UNLOCK_SERVE (srv);
   return;
 
@@ -1124,8 +1632,9 @@ gst_switch_server_start_audio (GstCase * cas, GstSwitchServer * srv)
  * gst_switch_server_new_record:
  *  @return: TRUE if succeeded.
  *
- *  Start a new recording.
- *  
+ *  Start a new recording. A running recorder is split into a new file at
+ *  the next keyframe, otherwise the recorder is restarted. ISO recordings
+ *  are split along with it.
  */
 gboolean
 gst_switch_server_new_record (GstSwitchServer * srv)
@@ -1137,7 +1646,9 @@ gst_switch_server_new_record (GstSwitchServer * srv)
 
   if (srv->recorder) {
     GST_SWITCH_SERVER_LOCK_RECORDER (srv);
-    if (srv->recorder) {
+    if (srv->recorder && gst_recorder_split (srv->recorder)) {
+      result = TRUE;
+    } else if (srv->recorder) {
       gst_worker_stop (GST_WORKER (srv->recorder));
       g_object_set (G_OBJECT (srv->recorder),
           "mode", srv->composite->mode,
@@ -1151,11 +1662,236 @@ gst_switch_server_new_record (GstSwitchServer * srv)
         ERROR ("failed to reset composite recorder");
       }
     }
+    g_list_foreach (srv->isos, (GFunc) gst_recorder_split, NULL);
     GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
   }
   return result;
 }
 
+/**
+ * gst_switch_server_add_sink_stats:
+ *
+ *  Add the client stats of a sink of a worker, if it has a sink policy.
+ */
+static void
+gst_switch_server_add_sink_stats (GVariantBuilder * builder,
+    GstWorker * worker, const gchar * name)
+{
+  GstSinkPolicyStats stats;
+  GstElement *sink;
+
+  if (worker == NULL || worker->pipeline == NULL)
+    return;
+
+  sink = gst_worker_get_element (worker, name);
+  if (sink == NULL)
+    return;
+
+  if (gst_sink_policy_get_stats (sink, &stats)) {
+    g_variant_builder_add (builder, "(suuxxxtu)", worker->name,
+        stats.clients, stats.first_frames, stats.ttff_last, stats.ttff_max,
+        stats.first_frames ? stats.ttff_total / stats.first_frames : 0,
+        stats.dropped, stats.slow_clients);
+  }
+  gst_object_unref (sink);
+}
+
+/**
+ * gst_switch_server_get_sink_stats:
+ *  @return: a floating GVariant of type a(suuxxxtu)
+ *
+ *  Get the clients of each output sink: how many connected and got a first
+ *  frame, the last, worst and mean time to the first frame in microseconds,
+ *  the buffers dropped for clients over their limit and the clients
+ *  removed as too slow, see gst_sink_policy_get_stats.
+ */
+GVariant *
+gst_switch_server_get_sink_stats (GstSwitchServer * srv)
+{
+  GVariantBuilder *builder;
+  GVariant *result;
+  GList *item;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(suuxxxtu)"));
+
+  gst_switch_server_add_sink_stats (builder, srv->output, "sink");
+  gst_switch_server_add_sink_stats (builder, GST_WORKER (srv->recorder),
+      "tcp_sink");
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item))
+    gst_switch_server_add_sink_stats (builder, GST_WORKER (item->data),
+        "sink");
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  result = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return result;
+}
+
+/**
+ * gst_switch_server_replay_save:
+ *  @port: the input port, or 0 for the output
+ *  @start: the start of the range, in milliseconds before now
+ *  @end: the end of the range, in milliseconds before now
+ *  @filename: the file to write
+ *  @return: TRUE if the range is being saved.
+ *
+ *  Save a range of a replay ring into a file.
+ */
+gboolean
+gst_switch_server_replay_save (GstSwitchServer * srv, gint port,
+    gint start, gint end, const gchar * filename)
+{
+  GstReplay *replay = gst_switch_server_find_replay (srv, port);
+  gboolean result = FALSE;
+
+  if (replay) {
+    result = gst_replay_save (replay, start, end, filename);
+    g_object_unref (replay);
+  }
+  return result;
+}
+
+/**
+ * gst_switch_server_replay_play:
+ *  @port: the input port, or 0 for the output
+ *  @start: the start of the range, in milliseconds before now
+ *  @end: the end of the range, in milliseconds before now
+ *  @return: TRUE if the replay is starting.
+ *
+ *  Play a range of a replay ring back as a new video input.
+ */
+gboolean
+gst_switch_server_replay_play (GstSwitchServer * srv, gint port,
+    gint start, gint end)
+{
+  GstReplay *replay = gst_switch_server_find_replay (srv, port);
+  const gchar *host = srv->host;
+  gboolean result = FALSE;
+
+  // Wildcard addresses can't be connected to
+  if (g_strcmp0 (host, "::") == 0 || g_strcmp0 (host, "0.0.0.0") == 0)
+    host = "localhost";
+
+  if (replay) {
+    result = gst_replay_play (replay, start, end, host,
+        srv->video_acceptor_port);
+    g_object_unref (replay);
+  }
+  return result;
+}
+
+/**
+ * gst_switch_server_get_worker_timings:
+ *  @return: a floating GVariant of type a(ssuuuuuau)
+ *
+ *  Get how long each phase of starting the pipelines took, per worker
+ *  name, see gst_worker_get_timings.
+ */
+GVariant *
+gst_switch_server_get_worker_timings (GstSwitchServer * srv)
+{
+  return gst_worker_get_timings ();
+}
+
+/**
+ * gst_switch_server_get_bus_stats:
+ *  @return: a floating GVariant of type a(siuuuuu)
+ *
+ *  Get how many pipeline messages wait and how long they wait to be
+ *  dispatched, per worker name, see gst_worker_get_bus_stats.
+ */
+GVariant *
+gst_switch_server_get_bus_stats (GstSwitchServer * srv)
+{
+  return gst_worker_get_bus_stats ();
+}
+
+/**
+ * gst_switch_server_add_queue_level:
+ *
+ *  Add the queue level of a worker to a builder of type a(sttu).
+ */
+static void
+gst_switch_server_add_queue_level (GVariantBuilder * builder,
+    GstWorker * worker)
+{
+  guint64 bytes = 0, time = 0;
+  guint buffers = 0;
+
+  if (worker == NULL)
+    return;
+
+  gst_worker_get_queue_level (worker, &bytes, &time, &buffers);
+  g_variant_builder_add (builder, "(sttu)", worker->name, bytes,
+      time / GST_USECOND, buffers);
+}
+
+/**
+ * gst_switch_server_get_queue_levels:
+ *  @return: a floating GVariant of type a(sttu)
+ *
+ *  Get how many bytes, microseconds and buffers are held in the queues of
+ *  each worker, see gst_worker_get_queue_level.
+ */
+GVariant *
+gst_switch_server_get_queue_levels (GstSwitchServer * srv)
+{
+  GVariantBuilder *builder;
+  GVariant *result;
+  GList *item;
+
+  builder = g_variant_builder_new (G_VARIANT_TYPE ("a(sttu)"));
+
+  gst_switch_server_add_queue_level (builder, GST_WORKER (srv->composite));
+  gst_switch_server_add_queue_level (builder, srv->output);
+  gst_switch_server_add_queue_level (builder, GST_WORKER (srv->recorder));
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item))
+    gst_switch_server_add_queue_level (builder, GST_WORKER (item->data));
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  for (item = srv->isos; item; item = g_list_next (item))
+    gst_switch_server_add_queue_level (builder, GST_WORKER (item->data));
+  for (item = srv->replays; item; item = g_list_next (item))
+    gst_switch_server_add_queue_level (builder, GST_WORKER (item->data));
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+
+  result = g_variant_builder_end (builder);
+  g_variant_builder_unref (builder);
+  return result;
+}
+
+/**
+ * gst_switch_server_set_record_encoder:
+ *  @return: TRUE if the encoder spec is valid.
+ *
+ *  Select the video encoder for recordings, it is used from the next
+ *  recording on (see gst_switch_server_new_record).
+ */
+gboolean
+gst_switch_server_set_record_encoder (GstSwitchServer * srv,
+    const gchar * spec)
+{
+  if (parse_encoder (spec, NULL, NULL) == -1) {
+    WARN ("invalid recording encoder: %s", spec);
+    return FALSE;
+  }
+
+  GST_SWITCH_SERVER_LOCK_RECORDER (srv);
+  g_free (opts.record_encoder);
+  opts.record_encoder = g_strdup (spec);
+  if (srv->recorder)
+    g_object_set (G_OBJECT (srv->recorder), "encoder", spec, NULL);
+  GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
+
+  INFO ("recording encoder: %s", spec);
+  return TRUE;
+}
+
 /**
  * gst_switch_server_adjust_pip:
  *  @return: a unsigned number of indicating which component (x,y,w,h) has
@@ -1199,6 +1935,131 @@ gst_switch_server_adjust_pip (GstSwitchServer * srv,
   return result;
 }
 
+/**
+ * gst_switch_server_frame_interval:
+ *  @return: the duration of an output frame in usec.
+ */
+static gint64
+gst_switch_server_frame_interval (void)
+{
+  GstStructure *structure =
+      gst_caps_get_structure (gst_switch_server_getcaps (), 0);
+  gint num = 0, den = 1;
+
+  if (!gst_structure_get_fraction (structure, "framerate", &num, &den) ||
+      num <= 0)
+    return G_USEC_PER_SEC / 30;
+  return MAX (G_USEC_PER_SEC * den / num, 1);
+}
+
+/**
+ * gst_switch_server_apply_pip:
+ *  @return: FALSE to remove the timeout source.
+ *
+ *  Apply the PIP adjustments queued since the last time as one, and tell
+ *  the clients the PIP it ended up with. While the composite is still
+ *  restarting for a previous resize, the adjustments wait another frame.
+ */
+static gboolean
+gst_switch_server_apply_pip (GstSwitchServer * srv)
+{
+  gint dx, dy, dw, dh, x, y, w, h;
+  guint ticket;
+
+  GST_SWITCH_SERVER_LOCK_PIP (srv);
+  if (srv->composite->adjusting || srv->composite->transition) {
+    srv->pip_source = g_timeout_add (MAX (gst_switch_server_frame_interval ()
+            / 1000, 1), (GSourceFunc) gst_switch_server_apply_pip, srv);
+    GST_SWITCH_SERVER_UNLOCK_PIP (srv);
+    return FALSE;
+  }
+  dx = srv->pip_dx, dy = srv->pip_dy;
+  dw = srv->pip_dw, dh = srv->pip_dh;
+  srv->pip_dx = srv->pip_dy = srv->pip_dw = srv->pip_dh = 0;
+  ticket = srv->pip_ticket;
+  srv->pip_source = 0;
+  srv->pip_applied = g_get_monotonic_time ();
+  GST_SWITCH_SERVER_UNLOCK_PIP (srv);
+
+  gst_switch_server_adjust_pip (srv, dx, dy, dw, dh);
+
+  GST_SWITCH_SERVER_LOCK_PIP (srv);
+  x = srv->pip_x, y = srv->pip_y;
+  w = srv->pip_w, h = srv->pip_h;
+  GST_SWITCH_SERVER_UNLOCK_PIP (srv);
+
+  GST_SWITCH_SERVER_LOCK_CONTROLLER (srv);
+  if (srv->controller) {
+    gst_switch_controller_tell_pip_adjusted (srv->controller, ticket,
+        x, y, w, h);
+  }
+  GST_SWITCH_SERVER_UNLOCK_CONTROLLER (srv);
+  return FALSE;
+}
+
+/**
+ * gst_switch_server_queue_adjust_pip:
+ *  @return: the ticket of the adjustment.
+ *
+ *  Queue a PIP adjustment and return at once. The adjustments queued are
+ *  summed and applied from the main loop at most once per output frame, so
+ *  a burst of them restarts the composite for a resize once. The
+ *  "pip_adjusted" signal tells the last ticket applied and the new PIP.
+ */
+guint
+gst_switch_server_queue_adjust_pip (GstSwitchServer * srv,
+    gint dx, gint dy, gint dw, gint dh)
+{
+  gint64 interval = gst_switch_server_frame_interval ();
+  gint64 now = g_get_monotonic_time ();
+  guint ticket;
+
+  g_return_val_if_fail (GST_IS_COMPOSITE (srv->composite), 0);
+
+  GST_SWITCH_SERVER_LOCK_PIP (srv);
+  srv->pip_dx += dx, srv->pip_dy += dy;
+  srv->pip_dw += dw, srv->pip_dh += dh;
+  if (++srv->pip_ticket == 0)
+    ++srv->pip_ticket;
+  ticket = srv->pip_ticket;
+  if (!srv->pip_source) {
+    srv->pip_source =
+        g_timeout_add (MAX (srv->pip_applied + interval - now, 0) / 1000,
+        (GSourceFunc) gst_switch_server_apply_pip, srv);
+  }
+  GST_SWITCH_SERVER_UNLOCK_PIP (srv);
+  return ticket;
+}
+
+/**
+ * gst_switch_server_hold_composite:
+ *
+ *  Hold back the composite mode changes and PIP resizes, to apply them
+ *  together with gst_switch_server_release_composite().
+ */
+void
+gst_switch_server_hold_composite (GstSwitchServer * srv)
+{
+  g_return_if_fail (GST_IS_COMPOSITE (srv->composite));
+
+  gst_composite_hold (srv->composite);
+}
+
+/**
+ * gst_switch_server_release_composite:
+ *  @return: TRUE if the composite is reconfiguring.
+ *
+ *  Apply the changes held back since gst_switch_server_hold_composite() in
+ *  a single reconfiguration of the composite.
+ */
+gboolean
+gst_switch_server_release_composite (GstSwitchServer * srv)
+{
+  g_return_val_if_fail (GST_IS_COMPOSITE (srv->composite), FALSE);
+
+  return gst_composite_release (srv->composite);
+}
+
 static void gst_switch_server_worker_start (GstWorker *, GstSwitchServer *);
 static void gst_switch_server_worker_null (GstWorker *, GstSwitchServer *);
 
@@ -1329,9 +2190,6 @@ gst_switch_server_switch (GstSwitchServer * srv, gint channel, gint port)
   g_signal_connect (candidate_case, "worker-null",
       G_CALLBACK (gst_switch_server_worker_null), srv);
 
-  gst_worker_stop (GST_WORKER (compose_case));
-  gst_worker_stop (GST_WORKER (candidate_case));
-
   g_signal_connect (work1, "start-worker",
       G_CALLBACK (gst_switch_server_worker_start), srv);
   g_signal_connect (work2, "start-worker",
@@ -1340,9 +2198,19 @@ gst_switch_server_switch (GstSwitchServer * srv, gint channel, gint port)
   g_signal_connect (work1, "end-worker", callback, srv);
   g_signal_connect (work2, "end-worker", callback, srv);
 
-  if (!gst_worker_start (GST_WORKER (work1)))
-    goto error_start_work;
-  if (!gst_worker_start (GST_WORKER (work2)))
+  /* Each new case takes over the channel of the case it replaces */
+  scheduler = gst_worker_scheduler_new ();
+  gst_worker_scheduler_stop (scheduler, GST_WORKER (compose_case), NULL);
+  gst_worker_scheduler_stop (scheduler, GST_WORKER (candidate_case), NULL);
+  gst_worker_scheduler_start (scheduler, GST_WORKER (work1),
+      GST_WORKER (compose_case), NULL);
+  gst_worker_scheduler_start (scheduler, GST_WORKER (work2),
+      GST_WORKER (candidate_case), NULL);
+  gst_worker_scheduler_run (scheduler);
+  started = gst_worker_scheduler_succeeded (scheduler, GST_WORKER (work1)) &&
+      gst_worker_scheduler_succeeded (scheduler, GST_WORKER (work2));
+  gst_worker_scheduler_free (scheduler);
+  if (!started)
     goto error_start_work;
 
   srv->cases = g_list_append (srv->cases, work1);
@@ -1575,7 +2443,7 @@ gst_switch_server_output_client_socket_removed (GstElement * element,
  * gst_switch_server_prepare_composite:
  * @return TRUE if the composite worker is prepared.
  *
- * Preparing the composite worker.
+ * Preparing the composite worker, it is started by gst_switch_server_run().
  */
 static gboolean
 gst_switch_server_prepare_composite (GstSwitchServer * srv,
@@ -1618,46 +2486,36 @@ gst_switch_server_prepare_composite (GstSwitchServer * srv,
   srv->pip_h = srv->composite->b_height;
   GST_SWITCH_SERVER_UNLOCK_PIP (srv);
 
-  if (!gst_worker_start (GST_WORKER (srv->composite)))
-    goto error_start_composite;
-
   return TRUE;
-
-error_start_composite:
-  {
-    g_object_unref (srv->composite);
-    srv->composite = NULL;
-    return FALSE;
-  }
 }
 
 /**
- * gst_switch_server_get_output_string:
- * @return The composite output pipeline string, needs freeing after used
+ * gst_switch_server_build_output:
+ * @return TRUE if the composite output pipeline was built
  *
- * Fetching the composite output pipeline.
+ * Building the composite output pipeline.
  */
-static GString *
-gst_switch_server_get_output_string (GstWorker * worker, GstSwitchServer * srv)
+static gboolean
+gst_switch_server_build_output (GstWorker * worker,
+    GstWorkerBuilder * builder, GstSwitchServer * srv)
 {
-  GString *desc;
-
-  desc = g_string_new ("");
-
-  g_string_append_printf (desc, "intervideosrc name=source "
-      "channel=composite_out ");
-  g_string_append_printf (desc, "tcpserversink name=sink "
-      "port=%d ", srv->composite->sink_port);
-  g_string_append_printf (desc, "source. ! video/x-raw,width=%d,height=%d ",
+  gst_worker_builder_inter (builder, "intervideosrc", "source",
+      "composite_out");
+  gst_worker_builder_caps (builder, "video/x-raw,width=%d,height=%d",
       srv->composite->width, srv->composite->height);
-  ASSESS ("assess-output");
-  g_string_append_printf (desc, "! gdppay ");
-  /*
-     ASSESS ("assess-output-payed");
-   */
-  g_string_append_printf (desc, "! sink. ");
+  ASSESS_BUILDER (builder, assess-output);
+  /* One encoder shared by every client of the output port. */
+  if (opts.output_encoder.type != GST_SWITCH_ENCODER_RAW) {
+    gst_worker_builder_add (builder, "queue", NULL,
+        "max-size-buffers", (guint) 2, NULL);
+    gst_worker_builder_encoder (builder, &opts.output_encoder, NULL);
+  }
+  gst_worker_builder_add (builder, "gdppay", NULL, NULL);
+  gst_worker_builder_add (builder, "tcpserversink", "sink",
+      "port", (gint) srv->composite->sink_port, NULL);
+  gst_worker_builder_serve_sync (builder);
 
-  return desc;
+  return TRUE;
 }
 
 /**
@@ -1673,12 +2531,14 @@ gst_switch_server_prepare_output (GstWorker * worker, GstSwitchServer * srv)
 
   g_return_if_fail (GST_IS_ELEMENT (sink));
 
-  g_signal_connect (sink, "client-added",
+  gst_worker_connect_element (worker, sink, "client-added",
       G_CALLBACK (gst_switch_server_output_client_socket_added), srv);
 
-  g_signal_connect (sink, "client-socket-removed",
+  gst_worker_connect_element (worker, sink, "client-socket-removed",
       G_CALLBACK (gst_switch_server_output_client_socket_removed), srv);
 
+  gst_sink_policy_apply (sink, worker->name, FALSE);
+
   gst_object_unref (sink);
 }
 
@@ -1697,16 +2557,17 @@ gst_switch_server_create_output (GstSwitchServer * srv)
 
   srv->output = GST_WORKER (g_object_new (GST_TYPE_WORKER,
           "name", "output", NULL));
-  srv->output->pipeline_func_data = srv;
-  srv->output->pipeline_func = (GstWorkerGetPipelineString)
-      gst_switch_server_get_output_string;
+  srv->output->task_class = "output";
+  srv->output->priority = GST_WORKER_PRIORITY_PROGRAM;
+  srv->output->build_func_data = srv;
+  srv->output->build_func = (GstWorkerBuildPipeline)
+      gst_switch_server_build_output;
 
   g_signal_connect (srv->output, "prepare-worker",
       G_CALLBACK (gst_switch_server_prepare_output), srv);
   g_signal_connect (srv->output, "start-worker",
       G_CALLBACK (gst_switch_server_start_output), srv);
 
-  gst_worker_start (srv->output);
   return TRUE;
 }
 
@@ -1729,15 +2590,59 @@ gst_switch_server_create_recorder (GstSwitchServer * srv)
           srv->composite->encode_sink_port, "mode",
           srv->composite->mode, "width",
           srv->composite->width, "height", srv->composite->height, NULL));
+  if (opts.record_encoder)
+    g_object_set (G_OBJECT (srv->recorder), "encoder", opts.record_encoder,
+        NULL);
+  if (opts.record_proxy > 0)
+    g_object_set (G_OBJECT (srv->recorder), "proxy-height",
+        (guint) MIN (opts.record_proxy, srv->composite->height), NULL);
+  if (opts.proxy_encoder)
+    g_object_set (G_OBJECT (srv->recorder), "proxy-encoder",
+        opts.proxy_encoder, NULL);
 
   g_signal_connect (srv->recorder, "start-worker",
       G_CALLBACK (gst_switch_server_start_recorder), srv);
 
-  gst_worker_start (GST_WORKER (srv->recorder));
   GST_SWITCH_SERVER_UNLOCK_RECORDER (srv);
   return TRUE;
 }
 
+/**
+ * gst_switch_server_degrade_previews:
+ *
+ * Invoked by the load governor to degrade or restore the branches serving
+ * previews, in the main loop.
+ */
+static void
+gst_switch_server_degrade_previews (guint level,
+    const GstLoadGovernorStep * step, GstSwitchServer * srv)
+{
+  GList *item;
+
+  GST_SWITCH_SERVER_LOCK_CASES (srv);
+  for (item = srv->cases; item; item = g_list_next (item)) {
+    GstCase *cas = GST_CASE (item->data);
+    switch (cas->type) {
+      case GST_CASE_BRANCH_VIDEO_A:
+      case GST_CASE_BRANCH_VIDEO_B:
+      case GST_CASE_BRANCH_AUDIO:
+      case GST_CASE_BRANCH_PREVIEW:
+        gst_case_degrade (cas, step->rate, step->scale, step->idle);
+        break;
+      default:
+        break;
+    }
+  }
+  GST_SWITCH_SERVER_UNLOCK_CASES (srv);
+
+  GST_SWITCH_SERVER_LOCK_CONTROLLER (srv);
+  if (srv->controller) {
+    gst_switch_controller_tell_previews_degraded (srv->controller, level,
+        step->name);
+  }
+  GST_SWITCH_SERVER_UNLOCK_CONTROLLER (srv);
+}
+
 /*
 gboolean timeout(gpointer user_data) {
   INFO ("Exiting!");
@@ -1754,12 +2659,24 @@ gboolean timeout(gpointer user_data) {
 static void
 gst_switch_server_run (GstSwitchServer * srv)
 {
+  GstWorkerScheduler *scheduler;
+  gboolean started;
+
   GST_SWITCH_SERVER_LOCK_MAIN_LOOP (srv);
   srv->main_loop = g_main_loop_new (NULL, TRUE);
   GST_SWITCH_SERVER_UNLOCK_MAIN_LOOP (srv);
 
   //g_timeout_add_seconds (15, &timeout, srv);
 
+  gst_worker_scheduler_set_threads (opts.worker_threads);
+  gst_worker_set_bus_threads (opts.bus_threads);
+  gst_worker_task_pool_configure (NULL);
+  gst_worker_priority_configure (NULL);
+  gst_worker_builder_set_budget ((guint64) MAX (opts.queue_memory, 0) * 1024
+      * 1024, opts.queue_latency < 0 ? gst_worker_latency_get ()->queue_time :
+      (GstClockTime) opts.queue_latency * GST_MSECOND);
+  INFO ("latency profile: %s", gst_worker_latency_get ()->name);
+
   if (!gst_switch_server_prepare_composite (srv, DEFAULT_COMPOSE_MODE))
     goto error_prepare_composite;
 
@@ -1769,6 +2686,27 @@ gst_switch_server_run (GstSwitchServer * srv)
   if (!gst_switch_server_create_recorder (srv))
     goto error_prepare_recorder;
 
+  /* The output and the recorder read the composite, then run side by side */
+  scheduler = gst_worker_scheduler_new ();
+  gst_worker_scheduler_start (scheduler, GST_WORKER (srv->composite), NULL);
+  gst_worker_scheduler_start (scheduler, srv->output,
+      GST_WORKER (srv->composite), NULL);
+  gst_worker_scheduler_start (scheduler, GST_WORKER (srv->recorder),
+      GST_WORKER (srv->composite), NULL);
+  gst_worker_scheduler_run (scheduler);
+  started = gst_worker_scheduler_succeeded (scheduler,
+      GST_WORKER (srv->composite));
+  gst_worker_scheduler_free (scheduler);
+  if (!started)
+    goto error_start_composite;
+
+  gst_switch_server_start_replay (srv, "composite_video", 0);
+
+  if (opts.governor_interval > 0) {
+    srv->governor = gst_load_governor_new (opts.governor_interval,
+        (GstLoadGovernorFunc) gst_switch_server_degrade_previews, srv);
+  }
+
   srv->video_acceptor = g_thread_new ("switch-server-video-acceptor",
       (GThreadFunc)
       gst_switch_server_video_acceptor, srv);
@@ -1786,6 +2724,9 @@ gst_switch_server_run (GstSwitchServer * srv)
   srv->main_loop = NULL;
   GST_SWITCH_SERVER_UNLOCK_MAIN_LOOP (srv);
 
+  gst_worker_dump_timings ();
+  gst_worker_task_pool_dump ();
+
 /*
   g_thread_join (srv->video_acceptor);
   g_thread_join (srv->audio_acceptor);
@@ -1808,6 +2749,11 @@ error_prepare_recorder:
     ERROR ("error preparing server");
     return;
   }
+error_start_composite:
+  {
+    ERROR ("error starting composite");
+    return;
+  }
 }
 
 static unsigned long long i = 0;
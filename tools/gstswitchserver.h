@@ -25,6 +25,8 @@
 #include <gio/gio.h>
 #include "gstcomposite.h"
 #include "gstswitchcontroller.h"
+#include "gstswitchopts.h"
+#include "gstloadgovernor.h"
 #include "../logutils.h"
 
 #define GST_TYPE_SWITCH_SERVER (gst_switch_server_get_type())
@@ -46,6 +48,29 @@ typedef struct _GstSwitchServerOpts GstSwitchServerOpts;
  *  @param controller_address the dbus address for the controller
  *  @param video_input_port the video input TCP port
  *  @param audio_input_port the audio input TCP port
+ *  @param output_encoder the encoder used on the composite output port
+ *  @param output_burst what new clients of the output ports are sent first
+ *  @param client_limit the backlog allowed for each output client
+ *  @param record_encoder the video encoder spec for recordings
+ *  @param record_split_time start a new recording file every N seconds
+ *  @param record_split_size start a new recording file every N MB
+ *  @param record_ring MB of RAM buffering recording writes, 0 for none
+ *  @param record_direct_io write recordings with O_DIRECT
+ *  @param record_iso also record every video input to its own file
+ *  @param iso_encoder the video encoder spec for ISO recordings
+ *  @param iso_max_encoders ISO recordings encoded at full quality
+ *  @param replay_seconds seconds kept for instant replays, 0 for none
+ *  @param replay_size the size of each replay ring in MB
+ *  @param replay_inputs also keep each video input for replays
+ *  @param replay_encoder the video encoder spec for the replay rings
+ *  @param record_proxy the proxy recording height, 0 for none
+ *  @param proxy_encoder the video encoder spec for the proxy recording
+ *  @param worker_threads workers started or stopped at once, 0 for auto
+ *  @param bus_threads threads dispatching the worker bus messages
+ *  @param governor_interval milliseconds between load checks, 0 for none
+ *  @param queue_memory the MB shared by the queues of all pipelines
+ *  @param queue_latency the milliseconds of media held by each queue, -1
+ *  for the latency profile's
  */
 struct _GstSwitchServerOpts
 {
@@ -60,6 +85,28 @@ struct _GstSwitchServerOpts
   GstCaps *video_caps;
   gchar *video_caps_str;
   gchar *audio_caps_str;
+  GstSwitchEncoder output_encoder;
+  GstSwitchBurst output_burst;
+  GstSwitchClientLimit client_limit;
+  gchar *record_encoder;
+  gint record_split_time;
+  gint record_split_size;
+  gint record_ring;
+  gboolean record_direct_io;
+  gboolean record_iso;
+  gchar *iso_encoder;
+  gint iso_max_encoders;
+  gint replay_seconds;
+  gint replay_size;
+  gboolean replay_inputs;
+  gchar *replay_encoder;
+  gint record_proxy;
+  gchar *proxy_encoder;
+  gint worker_threads;
+  gint bus_threads;
+  gint governor_interval;
+  gint queue_memory;
+  gint queue_latency;
 };
 
 /**
@@ -93,13 +140,23 @@ struct _GstSwitchServerOpts
  *  @param output the output instance
  *  @param recorder_lock the lock for the %recorder
  *  @param recorder the recorder instance
+ *  @param isos the ISO recorders of the video inputs, under %recorder_lock
+ *  @param replays the replay rings, under %recorder_lock
  *  @param pip_lock the lock for PIP
  *  @param pip_x the PIP X position
  *  @param pip_y the PIP Y position
  *  @param pip_w the PIP width
  *  @param pip_h the PIP height
+ *  @param pip_dx the queued PIP X adjustment, under %pip_lock
+ *  @param pip_dy the queued PIP Y adjustment, under %pip_lock
+ *  @param pip_dw the queued PIP width adjustment, under %pip_lock
+ *  @param pip_dh the queued PIP height adjustment, under %pip_lock
+ *  @param pip_ticket the last ticket of a queued adjustment
+ *  @param pip_source the source applying the queued adjustments, or 0
+ *  @param pip_applied when the queued adjustments were last applied
  *  @param clock_lock the lock for %clock
  *  @param clock a system clock
+ *  @param governor the load governor degrading the previews, or NULL
  */
 struct _GstSwitchServer
 {
@@ -139,12 +196,20 @@ struct _GstSwitchServer
 
   GMutex recorder_lock;
   GstRecorder *recorder;
+  GList *isos;
+  GList *replays;
 
   GMutex pip_lock;
   gint pip_x, pip_y, pip_w, pip_h;
+  gint pip_dx, pip_dy, pip_dw, pip_dh;
+  guint pip_ticket;
+  guint pip_source;
+  gint64 pip_applied;
 
   GMutex clock_lock;
   GstClock *clock;
+
+  GstLoadGovernor *governor;
 };
 
 /**
@@ -173,7 +238,21 @@ void gst_switch_server_mark_face (GstSwitchServer * srv,
     GVariant * faces, gboolean tracking);
 guint gst_switch_server_adjust_pip (GstSwitchServer * srv, gint dx, gint dy,
     gint dw, gint dh);
+guint gst_switch_server_queue_adjust_pip (GstSwitchServer * srv, gint dx,
+    gint dy, gint dw, gint dh);
+void gst_switch_server_hold_composite (GstSwitchServer * srv);
+gboolean gst_switch_server_release_composite (GstSwitchServer * srv);
 gboolean gst_switch_server_new_record (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_sink_stats (GstSwitchServer * srv);
+gboolean gst_switch_server_set_record_encoder (GstSwitchServer * srv,
+    const gchar * spec);
+gboolean gst_switch_server_replay_save (GstSwitchServer * srv, gint port,
+    gint start, gint end, const gchar * filename);
+gboolean gst_switch_server_replay_play (GstSwitchServer * srv, gint port,
+    gint start, gint end);
+GVariant *gst_switch_server_get_worker_timings (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_bus_stats (GstSwitchServer * srv);
+GVariant *gst_switch_server_get_queue_levels (GstSwitchServer * srv);
 
 GstCaps *gst_switch_server_getcaps (void);
 const gchar *gst_switch_server_get_audio_caps_str (void);
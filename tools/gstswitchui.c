@@ -383,12 +383,9 @@ gst_switch_ui_prepare_videos (GstSwitchUI * ui)
   preview_ports = gst_switch_client_get_preview_ports (GST_SWITCH_CLIENT (ui));
   if (preview_ports) {
     GVariant *ports = NULL;
-    GError *error = NULL;
-    gchar *s = NULL;
     gint serve, type;
 
-    g_variant_get (preview_ports, "(&s)", &s);
-    ports = g_variant_parse (G_VARIANT_TYPE ("a(iii)"), s, NULL, NULL, &error);
+    ports = g_variant_get_child_value (preview_ports, 0);
 
     num_previews = g_variant_n_children (ports);
     for (n = 0; n < num_previews; ++n) {
@@ -396,6 +393,8 @@ gst_switch_ui_prepare_videos (GstSwitchUI * ui)
       gst_switch_ui_add_preview_port (ui, port, serve, type);
       //INFO ("preview: %d, %d, %d", port, serve, type);
     }
+    g_variant_unref (ports);
+    g_variant_unref (preview_ports);
   }
 }
 
@@ -1128,7 +1127,7 @@ gst_switch_ui_adjust_pip (GstSwitchUI * ui, gboolean resize, gint key)
 {
   const gint step = 1;
   gint dx = 0, dy = 0, dw = 0, dh = 0;
-  guint result;
+  guint ticket;
 
   if (resize) {
     switch (key) {
@@ -1162,9 +1161,23 @@ gst_switch_ui_adjust_pip (GstSwitchUI * ui, gboolean resize, gint key)
     }
   }
 
-  result = gst_switch_client_adjust_pip (GST_SWITCH_CLIENT (ui),
+  /* Key repeats are queued, the server applies them once per frame. */
+  ticket = gst_switch_client_queue_adjust_pip (GST_SWITCH_CLIENT (ui),
       dx, dy, dw, dh);
-  INFO ("adjust-pip: (%d) %d", resize, result);
+  INFO ("adjust-pip: (%d) ticket %u", resize, ticket);
+}
+
+/**
+ * @brief The queued PIP adjustments were applied.
+ * @param ui The GstSwitchUI instance.
+ * @param ticket The last adjustment applied.
+ * @memberof GstSwitchUI
+ */
+static void
+gst_switch_ui_pip_adjusted (GstSwitchUI * ui, guint ticket,
+    gint x, gint y, gint w, gint h)
+{
+  INFO ("pip-adjusted: ticket %u, %d,%d %dx%d", ticket, x, y, w, h);
 }
 
 /**
@@ -1307,6 +1320,8 @@ gst_switch_ui_class_init (GstSwitchUIClass * klass)
       gst_switch_ui_show_face_marker;
   client_class->show_track_marker = (GstSwitchClientShowFaceMarkerFunc)
       gst_switch_ui_show_track_marker;
+  client_class->pip_adjusted = (GstSwitchClientPipAdjustedFunc)
+      gst_switch_ui_pip_adjusted;
 }
 
 /**
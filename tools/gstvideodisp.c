@@ -49,6 +49,7 @@ static void
 gst_video_disp_init (GstVideoDisp * disp)
 {
   //INFO ("init %p", disp);
+  GST_WORKER (disp)->priority = GST_WORKER_PRIORITY_UI;
 }
 
 /**
@@ -128,26 +129,26 @@ gst_video_disp_get_property (GstVideoDisp * disp, guint property_id,
 /**
  * @brief
  * @param disp The GstVideoDisp instance.
+ * @param builder The builder.
  * @memberof GstVideoDisp
  */
-static GString *
-gst_video_disp_get_pipeline_string (GstVideoDisp * disp)
+static gboolean
+gst_video_disp_build_pipeline (GstVideoDisp * disp, GstWorkerBuilder * builder)
 {
-  GString *desc;
-
   INFO ("display video %d", disp->port);
 
-  desc = g_string_new ("");
+  gst_worker_builder_add (builder, "tcpclientsrc", "source",
+      "port", (gint) disp->port, NULL);
+  gst_worker_builder_add (builder, "gdpdepay", NULL, NULL);
+  /* The composite output may be encoded (see --output-encoder). */
+  gst_worker_builder_add (builder, "decodebin", NULL, NULL);
+  gst_worker_builder_add (builder, "videoconvert", NULL, NULL);
+  gst_worker_builder_add (builder, "cairooverlay", "overlay", NULL);
+  gst_worker_builder_add (builder, "videoconvert", NULL, NULL);
+  gst_worker_builder_add (builder, "xvimagesink", "sink",
+      "sync", FALSE, NULL);
 
-  g_string_append_printf (desc, "tcpclientsrc name=source "
-      "port=%d ", disp->port);
-  g_string_append_printf (desc, "! gdpdepay ");
-  g_string_append_printf (desc, "! videoconvert ");
-  g_string_append_printf (desc, "! cairooverlay name=overlay ");
-  g_string_append_printf (desc, "! videoconvert ");
-  g_string_append_printf (desc, "! xvimagesink name=sink sync=false ");
-
-  return desc;
+  return TRUE;
 }
 
 /**
@@ -203,6 +204,6 @@ gst_video_disp_class_init (GstVideoDispClass * klass)
           ((gulong) - 1), 0, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   worker_class->prepare = (GstWorkerPrepareFunc) gst_video_disp_prepare;
-  worker_class->get_pipeline_string = (GstWorkerGetPipelineStringFunc)
-      gst_video_disp_get_pipeline_string;
+  worker_class->build_pipeline = (GstWorkerBuildPipelineFunc)
+      gst_video_disp_build_pipeline;
 }
@@ -27,6 +27,7 @@
 #include "gstworker.h"
 #include "gstswitchserver.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #define GST_WORKER_LOCK_PIPELINE(srv) (g_mutex_lock (&(srv)->pipeline_lock))
@@ -50,6 +51,145 @@ enum
 /*!< @internal */
 static guint gst_worker_signals[SIGNAL__LAST] = { 0 };
 
+#define GST_WORKER_POOL_SIZE 2
+
+/*!< @internal Idle pipelines by worker kind, see gst_worker_pool_key(). */
+static GHashTable *gst_worker_pool = NULL;
+G_LOCK_DEFINE_STATIC (gst_worker_pool);
+
+/**
+ * @brief A signal handler connected by gst_worker_connect_element().
+ * @param instance The element.
+ * @param id The handler id.
+ */
+typedef struct _GstWorkerHandler
+{
+  gpointer instance;
+  gulong id;
+} GstWorkerHandler;
+
+#define GST_WORKER_TIMING_SAMPLES 64
+
+/*!< @internal Upper bounds of the timing histogram buckets, in usec. */
+static const gint64 gst_worker_timing_bounds[] = {
+  1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000,
+  2000000,
+};
+
+#define GST_WORKER_TIMING_BUCKETS (G_N_ELEMENTS (gst_worker_timing_bounds) + 1)
+
+/**
+ * @brief The last durations of a phase of the workers of a name.
+ * @param worker The worker name.
+ * @param phase The phase name.
+ * @param count The number of durations ever recorded.
+ * @param samples The last durations in usec, a ring.
+ */
+typedef struct _GstWorkerTiming
+{
+  gchar *worker;
+  gchar *phase;
+  guint count;
+  gint64 samples[GST_WORKER_TIMING_SAMPLES];
+} GstWorkerTiming;
+
+/**
+ * @brief A summary of the samples of a GstWorkerTiming.
+ */
+typedef struct _GstWorkerTimingSummary
+{
+  guint count;
+  gint64 min, p50, p95, max;
+  guint buckets[GST_WORKER_TIMING_BUCKETS];
+} GstWorkerTimingSummary;
+
+/*!< @internal Timings by "worker phase", and in the order first recorded. */
+static GHashTable *gst_worker_timings = NULL;
+static GPtrArray *gst_worker_timing_list = NULL;
+G_LOCK_DEFINE_STATIC (gst_worker_timings);
+
+/**
+ * @brief A thread dispatching the bus messages of some workers.
+ * @param context The context the bus watches are attached to.
+ * @param loop The loop running the context.
+ * @param watches The number of bus watches attached.
+ */
+typedef struct _GstWorkerBusThread
+{
+  GMainContext *context;
+  GMainLoop *loop;
+  GThread *thread;
+  guint watches;
+} GstWorkerBusThread;
+
+/*!< @internal The bus threads, none dispatches in the default context. */
+static GstWorkerBusThread *gst_worker_bus_threads = NULL;
+static guint gst_worker_bus_thread_count = 0;
+G_LOCK_DEFINE_STATIC (gst_worker_bus_threads);
+
+/**
+ * @brief A bus watch, it does not keep the worker alive.
+ */
+typedef struct _GstWorkerBusWatch
+{
+  GWeakRef worker;
+  GstWorkerBusThread *thread;
+} GstWorkerBusWatch;
+
+/**
+ * @brief The bus dispatch metrics of the workers of a name.
+ * @param worker The worker name.
+ * @param thread The bus thread of the last watch, -1 for the default one.
+ * @param depth The messages posted and not dispatched yet.
+ * @param max_depth The highest depth seen.
+ * @param count The number of messages dispatched.
+ * @param latency The total time from posting to dispatching, in usec.
+ * @param max_latency The longest time from posting to dispatching.
+ */
+typedef struct _GstWorkerBusStats
+{
+  gchar *worker;
+  gint thread;
+  gint depth;
+  gint max_depth;
+  guint count;
+  guint64 latency;
+  gint64 max_latency;
+} GstWorkerBusStats;
+
+/**
+ * @brief Attached to a message when it is posted.
+ */
+typedef struct _GstWorkerBusPost
+{
+  GstWorkerBusStats *stats;
+  gint64 time;
+} GstWorkerBusPost;
+
+/*!< @internal Bus metrics by worker name, and in the order first seen. */
+static GHashTable *gst_worker_bus_stats = NULL;
+static GPtrArray *gst_worker_bus_stats_list = NULL;
+G_LOCK_DEFINE_STATIC (gst_worker_bus_stats);
+
+#define GST_WORKER_BUS_POST "gst-worker-bus-post"
+
+/*!< @internal The QoS reported by priority class since last taken. */
+static GstWorkerQos gst_worker_qos[GST_WORKER_PRIORITY__LAST];
+G_LOCK_DEFINE_STATIC (gst_worker_qos);
+
+/**
+ * @brief A probe timing the first buffer arriving at a sink.
+ */
+typedef struct _GstWorkerSinkProbe
+{
+  GstPad *pad;
+  gulong id;
+  gchar *worker;
+  gchar *phase;
+  gint64 start;
+  gint fired;
+} GstWorkerSinkProbe;
+
 extern gboolean verbose;
 
 #if ENABLE_ASSESSMENT
@@ -62,6 +202,452 @@ guint assess_number = 0;
 /*!< @internal */
 G_DEFINE_TYPE (GstWorker, gst_worker, G_TYPE_OBJECT);
 
+/**
+ * @brief Record how long a phase of a worker took.
+ * @param worker The worker name.
+ * @param phase The phase name.
+ * @param usec The duration in microseconds.
+ */
+static void
+gst_worker_record_timing (const gchar * worker, const gchar * phase,
+    gint64 usec)
+{
+  gchar *key = g_strdup_printf ("%s %s", worker, phase);
+  GstWorkerTiming *timing;
+
+  G_LOCK (gst_worker_timings);
+  if (gst_worker_timings == NULL) {
+    gst_worker_timings = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, NULL);
+    gst_worker_timing_list = g_ptr_array_new ();
+  }
+
+  timing = g_hash_table_lookup (gst_worker_timings, key);
+  if (timing == NULL) {
+    timing = g_new0 (GstWorkerTiming, 1);
+    timing->worker = g_strdup (worker);
+    timing->phase = g_strdup (phase);
+    g_hash_table_insert (gst_worker_timings, key, timing);
+    g_ptr_array_add (gst_worker_timing_list, timing);
+    key = NULL;
+  }
+  timing->samples[timing->count++ % GST_WORKER_TIMING_SAMPLES] = usec;
+  G_UNLOCK (gst_worker_timings);
+
+  g_free (key);
+}
+
+static gint
+gst_worker_timing_compare (gconstpointer a, gconstpointer b)
+{
+  gint64 x = *(const gint64 *) a, y = *(const gint64 *) b;
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * @brief Summarize the last samples of a timing, called locked.
+ * @param timing The timing.
+ * @param summary The summary to fill in.
+ */
+static void
+gst_worker_timing_summarize (GstWorkerTiming * timing,
+    GstWorkerTimingSummary * summary)
+{
+  gint64 sorted[GST_WORKER_TIMING_SAMPLES];
+  guint n = MIN (timing->count, GST_WORKER_TIMING_SAMPLES);
+  guint i, b;
+
+  memset (summary, 0, sizeof (*summary));
+  summary->count = timing->count;
+  if (n == 0)
+    return;
+
+  memcpy (sorted, timing->samples, n * sizeof (gint64));
+  qsort (sorted, n, sizeof (gint64), gst_worker_timing_compare);
+  for (i = 0; i < n; ++i) {
+    for (b = 0; b < G_N_ELEMENTS (gst_worker_timing_bounds); ++b)
+      if (sorted[i] < gst_worker_timing_bounds[b])
+        break;
+    summary->buckets[b] += 1;
+  }
+  summary->min = sorted[0];
+  summary->p50 = sorted[n / 2];
+  summary->p95 = sorted[n * 95 / 100];
+  summary->max = sorted[n - 1];
+}
+
+static guint
+gst_worker_timing_usec (gint64 usec)
+{
+  return (guint) CLAMP (usec, 0, G_MAXUINT);
+}
+
+/**
+ * @memberof GstWorker
+ */
+GVariant *
+gst_worker_get_timings (void)
+{
+  GstWorkerTimingSummary summary;
+  GVariantBuilder builder, buckets;
+  guint n, b;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(ssuuuuuau)"));
+
+  G_LOCK (gst_worker_timings);
+  for (n = 0; gst_worker_timing_list && n < gst_worker_timing_list->len; ++n) {
+    GstWorkerTiming *timing = g_ptr_array_index (gst_worker_timing_list, n);
+
+    gst_worker_timing_summarize (timing, &summary);
+    g_variant_builder_init (&buckets, G_VARIANT_TYPE ("au"));
+    for (b = 0; b < GST_WORKER_TIMING_BUCKETS; ++b)
+      g_variant_builder_add (&buckets, "u", summary.buckets[b]);
+
+    g_variant_builder_add (&builder, "(ssuuuuu@au)", timing->worker,
+        timing->phase, summary.count, gst_worker_timing_usec (summary.min),
+        gst_worker_timing_usec (summary.p50),
+        gst_worker_timing_usec (summary.p95),
+        gst_worker_timing_usec (summary.max),
+        g_variant_builder_end (&buckets));
+  }
+  G_UNLOCK (gst_worker_timings);
+
+  return g_variant_builder_end (&builder);
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_dump_timings (void)
+{
+  GstWorkerTimingSummary summary;
+  GString *histogram = g_string_new ("");
+  guint n, b;
+
+  G_LOCK (gst_worker_timings);
+  if (gst_worker_timing_list && gst_worker_timing_list->len)
+    INFO ("worker timings, of the last %d of each:",
+        GST_WORKER_TIMING_SAMPLES);
+  for (n = 0; gst_worker_timing_list && n < gst_worker_timing_list->len; ++n) {
+    GstWorkerTiming *timing = g_ptr_array_index (gst_worker_timing_list, n);
+
+    gst_worker_timing_summarize (timing, &summary);
+    g_string_truncate (histogram, 0);
+    for (b = 0; b < GST_WORKER_TIMING_BUCKETS; ++b) {
+      if (summary.buckets[b] == 0)
+        continue;
+      if (b < G_N_ELEMENTS (gst_worker_timing_bounds))
+        g_string_append_printf (histogram, " <%dms:%u",
+            (gint) (gst_worker_timing_bounds[b] / 1000), summary.buckets[b]);
+      else
+        g_string_append_printf (histogram, " more:%u", summary.buckets[b]);
+    }
+    INFO ("%s %s: n=%u min=%.1fms p50=%.1fms p95=%.1fms max=%.1fms%s",
+        timing->worker, timing->phase, summary.count, summary.min / 1000.0,
+        summary.p50 / 1000.0, summary.p95 / 1000.0, summary.max / 1000.0,
+        histogram->str);
+  }
+  G_UNLOCK (gst_worker_timings);
+
+  g_string_free (histogram, TRUE);
+}
+
+static gpointer
+gst_worker_bus_thread_run (GstWorkerBusThread * thread)
+{
+  g_main_context_push_thread_default (thread->context);
+  g_main_loop_run (thread->loop);
+  g_main_context_pop_thread_default (thread->context);
+  return NULL;
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_set_bus_threads (gint threads)
+{
+  guint n;
+
+  G_LOCK (gst_worker_bus_threads);
+  if (gst_worker_bus_threads == NULL && threads > 0) {
+    gst_worker_bus_threads = g_new0 (GstWorkerBusThread, threads);
+    for (n = 0; n < (guint) threads; ++n) {
+      GstWorkerBusThread *thread = &gst_worker_bus_threads[n];
+      gchar *name = g_strdup_printf ("worker-bus-%u", n);
+      thread->context = g_main_context_new ();
+      thread->loop = g_main_loop_new (thread->context, FALSE);
+      thread->thread = g_thread_new (name,
+          (GThreadFunc) gst_worker_bus_thread_run, thread);
+      g_free (name);
+    }
+    gst_worker_bus_thread_count = threads;
+  }
+  G_UNLOCK (gst_worker_bus_threads);
+}
+
+/**
+ * @return The bus thread with the fewest watches, or NULL.
+ */
+static GstWorkerBusThread *
+gst_worker_bus_thread_take (void)
+{
+  GstWorkerBusThread *thread = NULL;
+  guint n;
+
+  G_LOCK (gst_worker_bus_threads);
+  for (n = 0; n < gst_worker_bus_thread_count; ++n) {
+    if (thread == NULL || gst_worker_bus_threads[n].watches < thread->watches)
+      thread = &gst_worker_bus_threads[n];
+  }
+  if (thread)
+    thread->watches += 1;
+  G_UNLOCK (gst_worker_bus_threads);
+  return thread;
+}
+
+static void
+gst_worker_bus_watch_free (GstWorkerBusWatch * watch)
+{
+  if (watch->thread) {
+    G_LOCK (gst_worker_bus_threads);
+    watch->thread->watches -= 1;
+    G_UNLOCK (gst_worker_bus_threads);
+  }
+  g_weak_ref_clear (&watch->worker);
+  g_free (watch);
+}
+
+/**
+ * @return The bus metrics of the workers of the name, never freed.
+ */
+static GstWorkerBusStats *
+gst_worker_bus_stats_get (const gchar * name, GstWorkerBusThread * thread)
+{
+  GstWorkerBusStats *stats;
+
+  G_LOCK (gst_worker_bus_stats);
+  if (gst_worker_bus_stats == NULL) {
+    gst_worker_bus_stats = g_hash_table_new (g_str_hash, g_str_equal);
+    gst_worker_bus_stats_list = g_ptr_array_new ();
+  }
+  stats = g_hash_table_lookup (gst_worker_bus_stats, name);
+  if (stats == NULL) {
+    stats = g_new0 (GstWorkerBusStats, 1);
+    stats->worker = g_strdup (name);
+    g_hash_table_insert (gst_worker_bus_stats, stats->worker, stats);
+    g_ptr_array_add (gst_worker_bus_stats_list, stats);
+  }
+  stats->thread = thread ? (gint) (thread - gst_worker_bus_threads) : -1;
+  G_UNLOCK (gst_worker_bus_stats);
+  return stats;
+}
+
+static void
+gst_worker_bus_post_free (GstWorkerBusPost * post)
+{
+  g_atomic_int_add (&post->stats->depth, -1);
+  g_slice_free (GstWorkerBusPost, post);
+}
+
+/**
+ * @brief Count a message posted on the bus, in the posting thread.
+ */
+static void
+gst_worker_bus_posted (GstWorkerBusStats * stats, GstMessage * message)
+{
+  GstWorkerBusPost *post = g_slice_new (GstWorkerBusPost);
+  gint depth, max;
+
+  post->stats = stats;
+  post->time = g_get_monotonic_time ();
+  gst_mini_object_set_qdata (GST_MINI_OBJECT (message),
+      g_quark_from_static_string (GST_WORKER_BUS_POST), post,
+      (GDestroyNotify) gst_worker_bus_post_free);
+
+  depth = g_atomic_int_add (&stats->depth, 1) + 1;
+  do {
+    max = g_atomic_int_get (&stats->max_depth);
+  } while (max < depth &&
+      !g_atomic_int_compare_and_exchange (&stats->max_depth, max, depth));
+}
+
+/**
+ * @brief Count a message dispatched to the worker.
+ */
+static void
+gst_worker_bus_dispatched (GstMessage * message)
+{
+  GstWorkerBusPost *post = gst_mini_object_get_qdata (GST_MINI_OBJECT
+      (message), g_quark_from_static_string (GST_WORKER_BUS_POST));
+  gint64 latency;
+
+  if (post == NULL)
+    return;
+
+  latency = g_get_monotonic_time () - post->time;
+  G_LOCK (gst_worker_bus_stats);
+  post->stats->count += 1;
+  post->stats->latency += latency;
+  post->stats->max_latency = MAX (post->stats->max_latency, latency);
+  G_UNLOCK (gst_worker_bus_stats);
+}
+
+/**
+ * @memberof GstWorker
+ */
+GVariant *
+gst_worker_get_bus_stats (void)
+{
+  GVariantBuilder builder;
+  guint n;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(siuuuuu)"));
+
+  G_LOCK (gst_worker_bus_stats);
+  for (n = 0; gst_worker_bus_stats_list &&
+      n < gst_worker_bus_stats_list->len; ++n) {
+    GstWorkerBusStats *stats = g_ptr_array_index (gst_worker_bus_stats_list, n);
+
+    g_variant_builder_add (&builder, "(siuuuuu)", stats->worker,
+        stats->thread, (guint) MAX (g_atomic_int_get (&stats->depth), 0),
+        (guint) g_atomic_int_get (&stats->max_depth), stats->count,
+        gst_worker_timing_usec (stats->count ?
+            (gint64) (stats->latency / stats->count) : 0),
+        gst_worker_timing_usec (stats->max_latency));
+  }
+  G_UNLOCK (gst_worker_bus_stats);
+
+  return g_variant_builder_end (&builder);
+}
+
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_take_qos (GstWorkerPriority priority, GstWorkerQos * qos)
+{
+  g_return_if_fail (priority < GST_WORKER_PRIORITY__LAST);
+
+  G_LOCK (gst_worker_qos);
+  *qos = gst_worker_qos[priority];
+  memset (&gst_worker_qos[priority], 0, sizeof (GstWorkerQos));
+  G_UNLOCK (gst_worker_qos);
+}
+
+static GstPadProbeReturn
+gst_worker_first_buffer (GstPad * pad, GstPadProbeInfo * info,
+    GstWorkerSinkProbe * probe)
+{
+  gst_worker_record_timing (probe->worker, probe->phase,
+      g_get_monotonic_time () - probe->start);
+  g_atomic_int_set (&probe->fired, TRUE);
+  return GST_PAD_PROBE_REMOVE;
+}
+
+static void
+gst_worker_sink_probe_free (GstWorkerSinkProbe * probe)
+{
+  if (!g_atomic_int_get (&probe->fired))
+    gst_pad_remove_probe (probe->pad, probe->id);
+  gst_object_unref (probe->pad);
+  g_free (probe->worker);
+  g_free (probe->phase);
+  g_free (probe);
+}
+
+/**
+ * @brief Get the sink pad of a sink, which may be a request pad of a bin.
+ * @param sink The sink.
+ * @return The pad, needs unref after used, or NULL.
+ */
+static GstPad *
+gst_worker_get_sink_pad (GstElement * sink)
+{
+  GstPad *pad = gst_element_get_static_pad (sink, "sink");
+  GValue item = G_VALUE_INIT;
+  GstIterator *it;
+
+  if (pad)
+    return pad;
+
+  it = gst_element_iterate_sink_pads (sink);
+  if (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    pad = g_value_dup_object (&item);
+    g_value_unset (&item);
+  }
+  gst_iterator_free (it);
+  return pad;
+}
+
+/**
+ * @brief Start timing the phases of starting the pipeline.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ *
+ * The time to the first buffer at each sink is recorded as the phase
+ * "first-buffer:NAME", generated names like fakesink12 are recorded by
+ * the factory name instead.
+ */
+static void
+gst_worker_start_timing (GstWorker * worker)
+{
+  GValue item = G_VALUE_INIT;
+  GstIterator *it;
+
+  g_ptr_array_set_size (worker->sink_probes, 0);
+  worker->phase_start = g_get_monotonic_time ();
+
+  it = gst_bin_iterate_sinks (GST_BIN (worker->pipeline));
+  while (gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstElement *sink = g_value_get_object (&item);
+    GstElementFactory *factory = gst_element_get_factory (sink);
+    const gchar *name = GST_ELEMENT_NAME (sink);
+    GstWorkerSinkProbe *probe;
+    GstPad *pad;
+
+    if (factory && g_str_has_prefix (name, GST_OBJECT_NAME (factory)) &&
+        g_ascii_isdigit (name[strlen (GST_OBJECT_NAME (factory))]))
+      name = GST_OBJECT_NAME (factory);
+
+    pad = gst_worker_get_sink_pad (sink);
+    if (pad) {
+      probe = g_new0 (GstWorkerSinkProbe, 1);
+      probe->pad = pad;
+      probe->worker = g_strdup (worker->name);
+      probe->phase = g_strdup_printf ("first-buffer:%s", name);
+      probe->start = worker->phase_start;
+      probe->id = gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER |
+          GST_PAD_PROBE_TYPE_BUFFER_LIST,
+          (GstPadProbeCallback) gst_worker_first_buffer, probe, NULL);
+      g_ptr_array_add (worker->sink_probes, probe);
+    }
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+}
+
+/**
+ * @brief Record the state change phase which just ended.
+ * @param worker The GstWorker instance.
+ * @param phase The phase name.
+ * @param last TRUE if it is the last phase of starting.
+ * @memberof GstWorker
+ */
+static void
+gst_worker_record_phase (GstWorker * worker, const gchar * phase,
+    gboolean last)
+{
+  gint64 now = g_get_monotonic_time ();
+
+  if (worker->phase_start == 0)
+    return;
+  gst_worker_record_timing (worker->name, phase, now - worker->phase_start);
+  worker->phase_start = last ? 0 : now;
+}
+
 /**
  * @brief Initialize GstWorker instances.
  * @param worker The GstWorker instance.
@@ -77,8 +663,17 @@ gst_worker_init (GstWorker * worker)
   worker->pipeline_func = NULL;
   worker->pipeline_func_data = NULL;
   worker->pipeline_string = NULL;
+  worker->build_func = NULL;
+  worker->build_func_data = NULL;
+  worker->handlers = g_array_new (FALSE, FALSE, sizeof (GstWorkerHandler));
+  worker->sink_probes = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_worker_sink_probe_free);
+  worker->phase_start = 0;
   worker->paused_for_buffering = FALSE;
-  worker->watch = 0;
+  worker->watch = NULL;
+  worker->bus_stats = NULL;
+  worker->task_class = NULL;
+  worker->priority = GST_WORKER_PRIORITY_NONE;
 
   g_mutex_init (&worker->pipeline_lock);
   g_cond_init (&worker->shutdown_cond);
@@ -105,6 +700,10 @@ gst_worker_dispose (GstWorker * worker)
   G_OBJECT_CLASS (parent_class)->dispose (G_OBJECT (worker));
 }
 
+static void gst_worker_pool_put (GstWorker *, GstElement *);
+static GstElement *gst_worker_detach_pipeline (GstWorker *);
+static void gst_worker_remove_watch (GstWorker *);
+
 /**
  * @brief Destroy GstWorker instances.
  * @param worker The GstWorker instance.
@@ -113,20 +712,21 @@ gst_worker_dispose (GstWorker * worker)
 static void
 gst_worker_finalize (GstWorker * worker)
 {
-  if (worker->watch) {
-    g_source_remove (worker->watch);
-    worker->watch = 0;
-  }
+  GstElement *pipeline;
+
+  gst_worker_remove_watch (worker);
   if (worker->pipeline) {
     INFO ("pipeline ref %d", GST_OBJECT_REFCOUNT (worker->pipeline));
-    gst_object_unref (worker->pipeline);
-    worker->pipeline = NULL;
   }
   if (worker->bus) {
     INFO ("bus ref %d", GST_OBJECT_REFCOUNT (worker->bus));
-    gst_object_unref (worker->bus);
-    worker->bus = NULL;
   }
+  pipeline = gst_worker_detach_pipeline (worker);
+  if (pipeline) {
+    gst_worker_pool_put (worker, pipeline);
+  }
+  g_array_free (worker->handlers, TRUE);
+  g_ptr_array_free (worker->sink_probes, TRUE);
 
   /*
      if (worker->server) {
@@ -220,6 +820,238 @@ gst_worker_get_pipeline_string (GstWorker * worker)
   return desc;
 }
 
+/**
+ * @brief Check if the worker builds its pipeline with a builder.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ */
+static gboolean
+gst_worker_has_builder (GstWorker * worker)
+{
+  GstWorkerClass *workerclass = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
+  return worker->build_func != NULL || workerclass->build_pipeline != NULL;
+}
+
+/**
+ * @brief Build GstWorker pipeline with a builder.
+ * @param worker The GstWorker instance.
+ * @param builder The builder.
+ * @memberof GstWorker
+ */
+static gboolean
+gst_worker_build (GstWorker * worker, GstWorkerBuilder * builder)
+{
+  GstWorkerClass *workerclass = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
+
+  if (worker->build_func)
+    return worker->build_func (worker, builder, worker->build_func_data);
+  return workerclass->build_pipeline (worker, builder);
+}
+
+/**
+ * @brief Create GstWorker pipeline with a builder, no parsing involved.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ */
+static GstElement *
+gst_worker_build_pipeline (GstWorker * worker)
+{
+  GstWorkerClass *workerclass = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
+  GstWorkerBuilder *builder = NULL;
+  GstElement *pipeline = NULL;
+  gchar *name = g_strdup_printf ("%s-pipeline", worker->name);
+  gboolean retry = FALSE;
+  gboolean ok;
+
+  do {
+    gint64 start = g_get_monotonic_time ();
+
+    builder = gst_worker_builder_new (name);
+    ok = gst_worker_build (worker, builder);
+    gst_worker_record_timing (worker->name, "build",
+        g_get_monotonic_time () - start);
+
+    if (verbose) {
+      g_print ("%s: %s\n", worker->name, builder->desc->str);
+    }
+
+    if (ok)
+      pipeline = gst_worker_builder_finish (builder);
+
+    retry = FALSE;
+    if (!pipeline && builder->missing->len) {
+      gchar **names;
+      guint n;
+
+      g_ptr_array_add (builder->missing, NULL);
+      names = (gchar **) builder->missing->pdata;
+      retry = workerclass->missing && (*workerclass->missing) (worker, names);
+      for (n = 0; names[n]; ++n)
+        ERROR ("missing: %s", names[n]);
+    } else if (!pipeline) {
+      ERROR ("%s: pipeline building error", worker->name);
+    }
+    gst_worker_builder_free (builder);
+  } while (retry);
+
+  g_free (name);
+  return pipeline;
+}
+
+/**
+ * @brief Update the elements of a pipeline built before, in place.
+ * @param worker The GstWorker instance.
+ * @param pipeline The pipeline, in the NULL state.
+ * @return TRUE if the pipeline was built by the same elements and only
+ *         property values or caps needed to change.
+ * @memberof GstWorker
+ */
+static gboolean
+gst_worker_update_pipeline (GstWorker * worker, GstElement * pipeline)
+{
+  GstWorkerBuilder *builder;
+  GstElement *updated = NULL;
+  gint64 start = g_get_monotonic_time ();
+
+  if (!gst_worker_has_builder (worker))
+    return FALSE;
+
+  builder = gst_worker_builder_new_update (pipeline);
+  if (builder == NULL)
+    return FALSE;
+
+  if (gst_worker_build (worker, builder))
+    updated = gst_worker_builder_finish (builder);
+
+  if (updated)
+    gst_worker_record_timing (worker->name, "update",
+        g_get_monotonic_time () - start);
+
+  if (updated && verbose) {
+    g_print ("%s: (reused) %s\n", worker->name, builder->desc->str);
+  }
+
+  gst_worker_builder_free (builder);
+  if (updated)
+    gst_object_unref (updated);
+  return updated != NULL;
+}
+
+/**
+ * @brief The key of the pool of a worker.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ */
+static gpointer
+gst_worker_pool_key (GstWorker * worker)
+{
+  // Plain workers differ by what they build rather than by type
+  if (worker->build_func)
+    return (gpointer) worker->build_func;
+  return GSIZE_TO_POINTER (G_OBJECT_TYPE (worker));
+}
+
+/**
+ * @brief Keep an idle pipeline for reuse by workers of the same kind.
+ * @param worker The GstWorker instance which released the pipeline.
+ * @param pipeline The pipeline, in the NULL state, its reference is taken.
+ * @memberof GstWorker
+ */
+static void
+gst_worker_pool_put (GstWorker * worker, GstElement * pipeline)
+{
+  gpointer key = gst_worker_pool_key (worker);
+  GQueue *queue;
+
+  if (!gst_worker_has_builder (worker)) {
+    gst_object_unref (pipeline);
+    return;
+  }
+
+  G_LOCK (gst_worker_pool);
+  if (gst_worker_pool == NULL)
+    gst_worker_pool = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  queue = g_hash_table_lookup (gst_worker_pool, key);
+  if (queue == NULL) {
+    queue = g_queue_new ();
+    g_hash_table_insert (gst_worker_pool, key, queue);
+  }
+  if (queue->length < GST_WORKER_POOL_SIZE) {
+    g_queue_push_tail (queue, pipeline);
+    pipeline = NULL;
+  }
+  G_UNLOCK (gst_worker_pool);
+
+  if (pipeline)
+    gst_object_unref (pipeline);
+}
+
+/**
+ * @brief Take an idle pipeline which can be updated for the worker.
+ * @param worker The GstWorker instance.
+ * @return The pipeline, or NULL if none fits.
+ * @memberof GstWorker
+ */
+static GstElement *
+gst_worker_pool_take (GstWorker * worker)
+{
+  GstElement *pipeline = NULL;
+  GQueue candidates = G_QUEUE_INIT;
+  GQueue *queue = NULL;
+  GstElement *candidate;
+  gchar *name;
+
+  G_LOCK (gst_worker_pool);
+  if (gst_worker_pool)
+    queue = g_hash_table_lookup (gst_worker_pool, gst_worker_pool_key (worker));
+  while (queue && (candidate = g_queue_pop_head (queue)))
+    g_queue_push_tail (&candidates, candidate);
+  G_UNLOCK (gst_worker_pool);
+
+  // Building may take other locks, the pool is not locked meanwhile
+  while ((candidate = g_queue_pop_head (&candidates))) {
+    if (!pipeline && gst_worker_update_pipeline (worker, candidate)) {
+      pipeline = candidate;
+    } else {
+      gst_worker_pool_put (worker, candidate);
+    }
+  }
+
+  if (pipeline) {
+    name = g_strdup_printf ("%s-pipeline", worker->name);
+    gst_element_set_name (pipeline, name);
+    g_free (name);
+  }
+  return pipeline;
+}
+
+/**
+ * @brief Describe the GstWorker pipeline.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ */
+GString *
+gst_worker_get_pipeline_dump (GstWorker * worker)
+{
+  GstWorkerClass *workerclass;
+  GstWorkerBuilder *builder;
+  GString *desc;
+
+  g_return_val_if_fail (GST_IS_WORKER (worker), NULL);
+
+  if (!gst_worker_has_builder (worker)) {
+    workerclass = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
+    return workerclass->get_pipeline_string (worker);
+  }
+
+  builder = gst_worker_builder_new (worker->name);
+  gst_worker_build (worker, builder);
+  desc = g_string_new (builder->desc->str);
+  gst_worker_builder_free (builder);
+  return desc;
+}
+
 /**
  * @brief Create GstWorker pipeline.
  * @param worker The GstWorker instance.
@@ -235,18 +1067,30 @@ gst_worker_create_pipeline (GstWorker * worker)
   GError *error = NULL;
   GstParseContext *context = NULL;
   gint parse_flags = GST_PARSE_FLAG_NONE;
+  gint64 start;
   parse_flags |= GST_PARSE_FLAG_FATAL_ERRORS;
 
+  if (gst_worker_has_builder (worker)) {
+    pipeline = gst_worker_pool_take (worker);
+    return pipeline ? pipeline : gst_worker_build_pipeline (worker);
+  }
+
 create_pipeline:
+  start = g_get_monotonic_time ();
   desc = workerclass->get_pipeline_string (worker);
+  gst_worker_record_timing (worker->name, "describe",
+      g_get_monotonic_time () - start);
   context = gst_parse_context_new ();
 
   if (verbose) {
     g_print ("%s: %s\n", worker->name, desc->str);
   }
 
+  start = g_get_monotonic_time ();
   pipeline = (GstElement *) gst_parse_launch_full (desc->str, context,
       parse_flags, &error);
+  gst_worker_record_timing (worker->name, "parse",
+      g_get_monotonic_time () - start);
   g_string_free (desc, TRUE);
 
   if (error == NULL) {
@@ -322,6 +1166,7 @@ gst_worker_start (GstWorker * worker)
 
   if (gst_worker_prepare (worker)) {
     GST_WORKER_LOCK_PIPELINE (worker);
+    gst_worker_start_timing (worker);
     ret = gst_element_set_state (worker->pipeline, GST_STATE_READY);
     GST_WORKER_UNLOCK_PIPELINE (worker);
   }
@@ -350,6 +1195,7 @@ gst_worker_replay (GstWorker * worker)
         GST_CLOCK_TIME_NONE);
 
     if (state != GST_STATE_PLAYING) {
+      gst_worker_start_timing (worker);
       ret = gst_element_set_state (worker->pipeline, GST_STATE_READY);
     }
   }
@@ -423,6 +1269,7 @@ gst_worker_get_element_unlocked (GstWorker * worker, const gchar * name)
 }
 
 /**
+ * @return The element, or NULL if not found or the worker has no pipeline.
  */
 GstElement *
 gst_worker_get_element (GstWorker * worker, const gchar * name)
@@ -430,11 +1277,146 @@ gst_worker_get_element (GstWorker * worker, const gchar * name)
   GstElement *element = NULL;
 
   GST_WORKER_LOCK_PIPELINE (worker);
-  element = gst_worker_get_element_unlocked (worker, name);
+  if (worker->pipeline)
+    element = gst_worker_get_element_unlocked (worker, name);
   GST_WORKER_UNLOCK_PIPELINE (worker);
   return element;
 }
 
+/**
+ * @memberof GstWorker
+ */
+void
+gst_worker_get_queue_level (GstWorker * worker, guint64 * bytes,
+    guint64 * time, guint * buffers)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  gboolean done = FALSE;
+
+  *bytes = 0;
+  *time = 0;
+  *buffers = 0;
+
+  GST_WORKER_LOCK_PIPELINE (worker);
+  if (worker->pipeline == NULL) {
+    GST_WORKER_UNLOCK_PIPELINE (worker);
+    return;
+  }
+
+  it = gst_bin_iterate_recurse (GST_BIN (worker->pipeline));
+  while (!done) {
+    switch (gst_iterator_next (it, &item)) {
+      case GST_ITERATOR_OK:
+      {
+        GstElement *element = g_value_get_object (&item);
+        GstElementFactory *factory = gst_element_get_factory (element);
+        guint level_bytes, level_buffers;
+        guint64 level_time;
+
+        if (factory && g_str_equal (GST_OBJECT_NAME (factory), "queue")) {
+          g_object_get (element, "current-level-bytes", &level_bytes,
+              "current-level-time", &level_time,
+              "current-level-buffers", &level_buffers, NULL);
+          *bytes += level_bytes;
+          *time = MAX (*time, level_time);
+          *buffers += level_buffers;
+        }
+        g_value_reset (&item);
+      }
+        break;
+      case GST_ITERATOR_RESYNC:
+        *bytes = 0;
+        *time = 0;
+        *buffers = 0;
+        gst_iterator_resync (it);
+        break;
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+  GST_WORKER_UNLOCK_PIPELINE (worker);
+}
+
+/**
+ * @memberof GstWorker
+ */
+gulong
+gst_worker_connect_element (GstWorker * worker, GstElement * element,
+    const gchar * signal, GCallback callback, gpointer data)
+{
+  GstWorkerHandler handler;
+  guint signal_id;
+  GQuark detail;
+
+  g_return_val_if_fail (GST_IS_WORKER (worker), 0);
+  g_return_val_if_fail (GST_IS_ELEMENT (element), 0);
+
+  if (!g_signal_parse_name (signal, G_OBJECT_TYPE (element), &signal_id,
+          &detail, FALSE)) {
+    ERROR ("%s has no signal %s", GST_ELEMENT_NAME (element), signal);
+    return 0;
+  }
+
+  handler.id = g_signal_handler_find (element, G_SIGNAL_MATCH_ID |
+      G_SIGNAL_MATCH_DETAIL | G_SIGNAL_MATCH_FUNC | G_SIGNAL_MATCH_DATA,
+      signal_id, detail, NULL, callback, data);
+  if (handler.id)
+    return handler.id;
+
+  handler.instance = element;
+  handler.id = g_signal_connect (element, signal, callback, data);
+  g_array_append_val (worker->handlers, handler);
+  return handler.id;
+}
+
+/**
+ * @brief Disconnect the handlers of gst_worker_connect_element().
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ */
+static void
+gst_worker_disconnect_elements (GstWorker * worker)
+{
+  guint n;
+
+  for (n = 0; n < worker->handlers->len; ++n) {
+    GstWorkerHandler *handler =
+        &g_array_index (worker->handlers, GstWorkerHandler, n);
+    if (g_signal_handler_is_connected (handler->instance, handler->id))
+      g_signal_handler_disconnect (handler->instance, handler->id);
+  }
+  g_array_set_size (worker->handlers, 0);
+}
+
+/**
+ * @brief Take the pipeline away from the worker.
+ * @param worker The GstWorker instance.
+ * @return The pipeline, with no handlers of the worker left on it.
+ * @memberof GstWorker
+ *
+ * The pipeline must be in the NULL state and the bus watch removed.
+ */
+static GstElement *
+gst_worker_detach_pipeline (GstWorker * worker)
+{
+  GstElement *pipeline = worker->pipeline;
+
+  gst_worker_disconnect_elements (worker);
+  g_ptr_array_set_size (worker->sink_probes, 0);
+  worker->phase_start = 0;
+  if (worker->bus) {
+    gst_bus_set_sync_handler (worker->bus, NULL, NULL, NULL);
+    gst_object_unref (worker->bus);
+    worker->bus = NULL;
+  }
+  worker->pipeline = NULL;
+  return pipeline;
+}
+
 /*
 static void
 gst_worker_missing_plugin (GstWorker *worker, GstStructure *structure)
@@ -508,6 +1490,30 @@ gst_worker_handle_info (GstWorker * worker, GError * error, const char *debug)
   INFO ("%s: %s (%s)", worker->name, error->message, debug);
 }
 
+/**
+ * @brief Account a buffer an element of the worker reported late or dropped
+ * to the priority class of the worker.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ */
+static void
+gst_worker_handle_qos (GstWorker * worker, GstMessage * message)
+{
+  GstWorkerQos *qos;
+  gint64 jitter;
+  gdouble proportion;
+  gint quality;
+
+  gst_message_parse_qos_values (message, &jitter, &proportion, &quality);
+
+  G_LOCK (gst_worker_qos);
+  qos = &gst_worker_qos[worker->priority];
+  qos->late += 1;
+  qos->max_jitter = MAX (qos->max_jitter, jitter);
+  qos->max_proportion = MAX (qos->max_proportion, proportion);
+  G_UNLOCK (gst_worker_qos);
+}
+
 static void
 gst_worker_state_null_to_ready (GstWorker * worker)
 {
@@ -541,6 +1547,14 @@ gst_worker_state_paused_to_playing (GstWorker * worker)
   g_signal_emit (worker, gst_worker_signals[SIGNAL_START_WORKER], 0);
 }
 
+static gboolean
+gst_worker_state_paused_to_playing_proxy (GstWorker * worker)
+{
+  gst_worker_state_paused_to_playing (worker);
+  g_object_unref (worker);
+  return FALSE;
+}
+
 static void
 gst_worker_state_playing_to_paused (GstWorker * worker)
 {
@@ -584,13 +1598,23 @@ gst_worker_pipeline_state_changed (GstWorker * worker,
 {
   switch (statechange) {
     case GST_STATE_CHANGE_NULL_TO_READY:
+      gst_worker_record_phase (worker, "null-to-ready", FALSE);
       gst_worker_state_null_to_ready (worker);
       break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
+      gst_worker_record_phase (worker, "ready-to-paused", FALSE);
       gst_worker_state_ready_to_paused (worker);
       break;
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
-      gst_worker_state_paused_to_playing (worker);
+      gst_worker_record_phase (worker, "paused-to-playing", TRUE);
+      /* The handlers of start-worker expect the main loop, like those of
+       * worker-null and end-worker, not a bus thread */
+      if (g_main_context_is_owner (g_main_context_default ()))
+        gst_worker_state_paused_to_playing (worker);
+      else
+        g_main_context_invoke (NULL,
+            (GSourceFunc) gst_worker_state_paused_to_playing_proxy,
+            g_object_ref (worker));
       break;
     case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
       gst_worker_state_playing_to_paused (worker);
@@ -609,10 +1633,49 @@ gst_worker_pipeline_state_changed (GstWorker * worker,
   return TRUE;
 }
 
+/**
+ * @brief Give a new streaming task the pool of the worker, and a starting
+ * streaming thread the priority of the worker.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ *
+ * This runs in the streaming thread, where the message is posted.
+ */
+static void
+gst_worker_stream_status (GstWorker * worker, GstMessage * message)
+{
+  GstStreamStatusType type;
+  const GValue *value;
+  GstTaskPool *pool;
+
+  gst_message_parse_stream_status (message, &type, NULL);
+  switch (type) {
+    case GST_STREAM_STATUS_TYPE_CREATE:
+      pool = gst_worker_priority_get_pool (worker->priority);
+      if (pool == NULL)
+        pool = gst_worker_task_pool_get (worker->task_class);
+      value = gst_message_get_stream_status_object (message);
+      if (pool && value && G_VALUE_TYPE (value) == GST_TYPE_TASK)
+        gst_task_set_pool (GST_TASK (g_value_get_object (value)), pool);
+      break;
+    case GST_STREAM_STATUS_TYPE_ENTER:
+      gst_worker_priority_enter (worker->priority);
+      break;
+    default:
+      break;
+  }
+}
+
 static GstBusSyncReply
 gst_worker_message_sync (GstBus * bus, GstMessage * message, GstWorker * worker)
 {
+  if (worker->bus_stats)
+    gst_worker_bus_posted (worker->bus_stats, message);
+
   switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_STREAM_STATUS:
+      gst_worker_stream_status (worker, message);
+      break;
     case GST_MESSAGE_EOS:
       /* When we see EOS, wake up and gst_worker_stop that might be waiting */
       g_cond_signal (&worker->shutdown_cond);
@@ -634,6 +1697,8 @@ gst_worker_message (GstBus * bus, GstMessage * message, GstWorker * worker)
 
   workerclass = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
 
+  gst_worker_bus_dispatched (message);
+
   //INFO ("%s: %s", __FUNCTION__, GST_MESSAGE_TYPE_NAME (message));
 
   switch (GST_MESSAGE_TYPE (message)) {
@@ -664,6 +1729,9 @@ gst_worker_message (GstBus * bus, GstMessage * message, GstWorker * worker)
       gst_worker_handle_info (worker, error, debug);
     }
       break;
+    case GST_MESSAGE_QOS:
+      gst_worker_handle_qos (worker, message);
+      break;
     case GST_MESSAGE_TAG:
     {
       /*
@@ -741,7 +1809,6 @@ gst_worker_message (GstBus * bus, GstMessage * message, GstWorker * worker)
     case GST_MESSAGE_ASYNC_DONE:
     case GST_MESSAGE_REQUEST_STATE:
     case GST_MESSAGE_STEP_START:
-    case GST_MESSAGE_QOS:
     default:
       if (verbose) {
         //g_print ("message: %s\n", GST_MESSAGE_TYPE_NAME (message));
@@ -752,6 +1819,85 @@ gst_worker_message (GstBus * bus, GstMessage * message, GstWorker * worker)
   return workerclass->message ? workerclass->message (worker, message) : TRUE;
 }
 
+/**
+ * @brief Dispatch a bus message to the worker, if it is still alive.
+ */
+static gboolean
+gst_worker_bus_watch_dispatch (GstBus * bus, GstMessage * message,
+    GstWorkerBusWatch * watch)
+{
+  GstWorker *worker = g_weak_ref_get (&watch->worker);
+  gboolean ret;
+
+  if (worker == NULL)
+    return FALSE;
+
+  ret = gst_worker_message (bus, message, worker);
+  g_object_unref (worker);
+  return ret;
+}
+
+/**
+ * @brief Watch the pipeline bus, in a bus thread if there are any.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ */
+static gboolean
+gst_worker_add_watch (GstWorker * worker)
+{
+  GstWorkerBusWatch *watch;
+  GSource *source = gst_bus_create_watch (worker->bus);
+
+  if (source == NULL)
+    return FALSE;
+
+  watch = g_new0 (GstWorkerBusWatch, 1);
+  g_weak_ref_init (&watch->worker, worker);
+  watch->thread = gst_worker_bus_thread_take ();
+  worker->bus_stats = gst_worker_bus_stats_get (worker->name, watch->thread);
+
+  g_source_set_callback (source, (GSourceFunc) gst_worker_bus_watch_dispatch,
+      watch, (GDestroyNotify) gst_worker_bus_watch_free);
+  g_source_attach (source, watch->thread ? watch->thread->context : NULL);
+  worker->watch = source;
+  return TRUE;
+}
+
+/**
+ * @brief Stop watching the pipeline bus.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ */
+static void
+gst_worker_remove_watch (GstWorker * worker)
+{
+  if (worker->watch) {
+    g_source_destroy (worker->watch);
+    g_source_unref (worker->watch);
+    worker->watch = NULL;
+  }
+}
+
+/**
+ * @brief Let the subclass and handlers prepare a new or reused pipeline.
+ * @param worker The GstWorker instance.
+ * @memberof GstWorker
+ */
+static gboolean
+gst_worker_prepare_pipeline (GstWorker * worker)
+{
+  GstWorkerClass *workerclass = GST_WORKER_CLASS (G_OBJECT_GET_CLASS (worker));
+  gint64 start = g_get_monotonic_time ();
+
+  if (workerclass->prepare && !workerclass->prepare (worker))
+    return FALSE;
+
+  g_signal_emit (worker, gst_worker_signals[SIGNAL_PREPARE_WORKER], 0);
+  gst_worker_record_timing (worker->name, "prepare",
+      g_get_monotonic_time () - start);
+  return TRUE;
+}
+
 static gboolean
 gst_worker_prepare_unsafe (GstWorker * worker)
 {
@@ -777,19 +1923,17 @@ gst_worker_prepare_unsafe (GstWorker * worker)
   if (!worker->bus)
     goto error_get_bus;
 
-  worker->watch = gst_bus_add_watch (worker->bus,
-      (GstBusFunc) gst_worker_message, worker);
-
-  if (!worker->watch)
+  if (!gst_worker_add_watch (worker))
     goto error_add_watch;
 
   gst_bus_set_sync_handler (worker->bus,
       (GstBusSyncHandler) (gst_worker_message_sync), worker, NULL);
 
-  if (workerclass->prepare && !workerclass->prepare (worker))
-    goto error_prepare;
+  // A reused pipeline was left flushing
+  gst_bus_set_flushing (worker->bus, FALSE);
 
-  g_signal_emit (worker, gst_worker_signals[SIGNAL_PREPARE_WORKER], 0);
+  if (!gst_worker_prepare_pipeline (worker))
+    goto error_prepare;
 
 end:
   //GST_WORKER_UNLOCK_PIPELINE (worker);
@@ -812,8 +1956,9 @@ error_create_pipeline:
 
 error_prepare:
   {
-    g_source_remove (worker->watch);
-    worker->watch = 0;
+    gst_worker_remove_watch (worker);
+    gst_bus_set_sync_handler (worker->bus, NULL, NULL, NULL);
+    gst_worker_disconnect_elements (worker);
   error_add_watch:
     g_assert (GST_OBJECT_REFCOUNT (worker->bus) == 1);
     gst_object_unref (worker->bus);
@@ -854,6 +1999,8 @@ gst_worker_reset (GstWorker * worker)
 
 #if 1
   if (worker) {
+    GstElement *pipeline = NULL;
+
     GST_WORKER_LOCK_PIPELINE (worker);
     if (worker->pipeline) {
       gst_element_set_state (worker->pipeline, GST_STATE_NULL);
@@ -862,27 +2009,30 @@ gst_worker_reset (GstWorker * worker)
       gst_bus_set_flushing (worker->bus, TRUE);
     }
 
-    if (worker->watch) {
-      g_source_remove (worker->watch);
-      worker->watch = 0;
+    /* Only property values or caps changed, keep the elements */
+    if (worker->pipeline &&
+        gst_worker_update_pipeline (worker, worker->pipeline)) {
+      gst_bus_set_flushing (worker->bus, FALSE);
+      ok = gst_worker_prepare_pipeline (worker);
+      GST_WORKER_UNLOCK_PIPELINE (worker);
+      return ok;
     }
+
+    gst_worker_remove_watch (worker);
     if (worker->pipeline) {
       if (1 < GST_OBJECT_REFCOUNT (worker->pipeline)) {
         WARN ("possible pipeline leaks: %d",
             GST_OBJECT_REFCOUNT (worker->pipeline));
       }
-      gst_object_unref (worker->pipeline);
-      worker->pipeline = NULL;
-    }
-    if (worker->bus) {
-      if (1 < GST_OBJECT_REFCOUNT (worker->bus)) {
-        WARN ("possible bus leaks: %d", GST_OBJECT_REFCOUNT (worker->bus));
-      }
-      gst_object_unref (worker->bus);
-      worker->bus = NULL;
     }
+    pipeline = gst_worker_detach_pipeline (worker);
     ok = gst_worker_prepare_unsafe (worker);
     GST_WORKER_UNLOCK_PIPELINE (worker);
+
+    /* Pooled after preparing, it was just found not to fit */
+    if (pipeline) {
+      gst_worker_pool_put (worker, pipeline);
+    }
   }
 #else
   ok = TRUE;
@@ -24,6 +24,8 @@
 
 #include <gst/gst.h>
 #include "../logutils.h"
+#include "gstworkerbuilder.h"
+#include "gstworkertaskpool.h"
 
 #define GST_TYPE_WORKER (gst_worker_get_type ())
 #define GST_WORKER(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_WORKER, GstWorker))
@@ -46,6 +48,17 @@ typedef enum
   GST_WORKER_NR_REPLAY,         /*!< Try to replay the worker pipeline. */
 } GstWorkerNullReturn;
 
+/**
+ *  @struct _GstWorkerQos
+ *  @brief The QoS the workers of a priority class reported.
+ */
+typedef struct _GstWorkerQos
+{
+  guint late;                   /*!< buffers reported late or dropped */
+  gint64 max_jitter;            /*!< the latest one was, in nanoseconds */
+  gdouble max_proportion;       /*!< the highest processing rate asked for */
+} GstWorkerQos;
+
 /**
  *  @brief getting pipeline string function
  *  @param worker The GstWorker instance.
@@ -60,6 +73,23 @@ typedef GString *(*GstWorkerGetPipelineString) (GstWorker * worker,
  */
 typedef GString *(*GstWorkerGetPipelineStringFunc) (GstWorker * worker);
 
+/**
+ *  @brief pipeline building function
+ *  @param worker The GstWorker instance.
+ *  @param builder The builder to add the elements to.
+ *  @param data User defined data pointer.
+ */
+typedef gboolean (*GstWorkerBuildPipeline) (GstWorker * worker,
+    GstWorkerBuilder * builder, gpointer data);
+
+/**
+ *  @brief pipeline building callback function
+ *  @param worker The GstWorker instance.
+ *  @param builder The builder to add the elements to.
+ */
+typedef gboolean (*GstWorkerBuildPipelineFunc) (GstWorker * worker,
+    GstWorkerBuilder * builder);
+
 /**
  *  @brief worker preparation callback function
  *  @param worker The GstWorker instance.
@@ -113,10 +143,19 @@ struct _GstWorker
   GstWorkerGetPipelineString pipeline_func;     /*!< Pipeline string function. */
   gpointer pipeline_func_data;  /*!< Caller defined data for %pipeline_func. */
   GString *pipeline_string;     /*!< The pipeline string of the worker. */
+  GstWorkerBuildPipeline build_func;    /*!< Pipeline building function. */
+  gpointer build_func_data;     /*!< Caller defined data for %build_func. */
+
+  GArray *handlers;             /*!< Signal handlers on pipeline elements. */
+  GPtrArray *sink_probes;       /*!< Probes timing the first buffers. */
+  gint64 phase_start;           /*!< When the current start phase began. */
 
   gboolean auto_replay;         /*!< The worker should replay if it's TRUE */
   gboolean paused_for_buffering;        /*!< Mark for buffering pause. */
-  guint watch;                  /*!< The watch number of the pipeline bus. */
+  GSource *watch;               /*!< The watch of the pipeline bus. */
+  gpointer bus_stats;           /*!< The bus metrics of the worker name. */
+  const gchar *task_class;      /*!< The streaming thread pool to use. */
+  GstWorkerPriority priority;   /*!< The priority of its streaming threads. */
 
   /*!< TRUE if the recording pipeline needs clean shut-down
    * via an EOS event to finish up before stopping
@@ -178,6 +217,14 @@ struct _GstWorkerClass
    */
   GString *(*get_pipeline_string) (GstWorker * worker);
 
+  /**
+   *  @brief Virtual function adding the elements of the pipeline to a
+   *         builder, used instead of get_pipeline_string if installed.
+   *  @param worker The GstWorker instance.
+   *  @param builder The builder.
+   */
+    gboolean (*build_pipeline) (GstWorker * worker, GstWorkerBuilder * builder);
+
   /**
    *  @brief Virtual function called when new pipeline is requested for
    *         creation.
@@ -204,7 +251,9 @@ struct _GstWorkerClass
     GstWorkerNullReturn (*null) (GstWorker * worker);
 
   /**
-   *  @brief Reset reset the worker's pipeline.
+   *  @brief Reset reset the worker's pipeline. A pipeline built by a
+   *         builder is updated in place if only property values or caps
+   *         changed, otherwise it is replaced.
    *  @param worker The GstWorker instance.
    */
     gboolean (*reset) (GstWorker * worker);
@@ -285,4 +334,108 @@ GstElement *gst_worker_get_element_unlocked (GstWorker * worker,
  */
 GstElement *gst_worker_get_element (GstWorker * worker, const gchar * name);
 
+/**
+ *  @param worker The GstWorker instance.
+ *  @param bytes Set to the bytes held by the queues of the pipeline.
+ *  @param time Set to the most time one of the queues holds.
+ *  @param buffers Set to the buffers held by the queues.
+ *
+ *  Get what the queues of the worker pipeline hold, all zero if it has
+ *  no pipeline.
+ *
+ *  MT safe.
+ *
+ *  @memberof GstWorker
+ */
+void gst_worker_get_queue_level (GstWorker * worker, guint64 * bytes,
+    guint64 * time, guint * buffers);
+
+/**
+ *  @param worker The GstWorker instance.
+ *  @param element An element of the worker pipeline.
+ *  @param signal The signal name.
+ *  @param callback The signal handler.
+ *  @param data The data passed to the handler.
+ *
+ *  Connect a signal handler of a pipeline element, for use in "prepare".
+ *  Nothing is connected if the same handler is connected already, since a
+ *  pipeline is prepared again when it is reused. The handlers are
+ *  disconnected when the pipeline is released by the worker.
+ *
+ *  @return the handler id
+ *  @memberof GstWorker
+ */
+gulong gst_worker_connect_element (GstWorker * worker, GstElement * element,
+    const gchar * signal, GCallback callback, gpointer data);
+
+/**
+ *  @param worker The GstWorker instance.
+ *
+ *  Describe the pipeline the worker builds as a pipeline string, for
+ *  debugging. Workers using a builder build a pipeline to describe it.
+ *
+ *  @return the pipeline string, needs freeing after used
+ *  @memberof GstWorker
+ */
+GString *gst_worker_get_pipeline_dump (GstWorker * worker);
+
+/**
+ *  Get the timings of the worker phases: describing and parsing or
+ *  building the pipeline, preparing it, each state change up to PLAYING,
+ *  and the first buffer at each sink, by worker name. Each is a tuple of
+ *  the worker name, the phase, the number of times recorded, the min,
+ *  median, 95th percentile and max in microseconds and a histogram with
+ *  buckets up to 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000 ms and
+ *  beyond, all of the last 64 times.
+ *
+ *  @return a floating GVariant of type a(ssuuuuuau)
+ *  @memberof GstWorker
+ */
+GVariant *gst_worker_get_timings (void);
+
+/**
+ *  Print the timings of gst_worker_get_timings().
+ *
+ *  @memberof GstWorker
+ */
+void gst_worker_dump_timings (void);
+
+/**
+ *  @param threads The number of threads, 0 to dispatch in the default
+ *  main context.
+ *
+ *  Dispatch the bus messages of the workers started from now on in
+ *  dedicated threads instead of the default main context, each worker in
+ *  the thread with the fewest workers. Their handlers, the signals of the
+ *  workers included, then run in these threads. Only the first call with
+ *  threads takes effect.
+ *
+ *  @memberof GstWorker
+ */
+void gst_worker_set_bus_threads (gint threads);
+
+/**
+ *  Get the bus dispatch metrics, by worker name. Each is a tuple of the
+ *  worker name, its bus thread or -1 for the default main context, the
+ *  messages waiting to be dispatched, the most ever waiting, the number
+ *  dispatched, and the mean and max microseconds from posting a message
+ *  to dispatching it.
+ *
+ *  @return a floating GVariant of type a(siuuuuu)
+ *  @memberof GstWorker
+ */
+GVariant *gst_worker_get_bus_stats (void);
+
+/**
+ *  @param priority A priority class.
+ *  @param qos Filled with the QoS reported by the workers of the class
+ *  since the last call.
+ *
+ *  Take the QoS the sinks of the workers of a class posted for buffers
+ *  they got late or dropped, and start accounting it anew.
+ *
+ *  @memberof GstWorker
+ */
+void gst_worker_take_qos (GstWorkerPriority priority, GstWorkerQos * qos);
+
 #endif //__GST_WORKER_H__
@@ -0,0 +1,1062 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gobject/gvaluecollector.h>
+#include <gst/video/video.h>
+#include "gstworkerbuilder.h"
+#include "../logutils.h"
+
+#define GST_WORKER_BUILDER_LINK_FLAGS GST_PAD_LINK_CHECK_HIERARCHY
+#define GST_WORKER_BUILDER_RECORD "gst-worker-builder-record"
+#define GST_WORKER_BUILDER_CAPS "gst-worker-builder-caps"
+
+/*!< @internal Element factories by name, shared by all pipelines. */
+static GHashTable *gst_worker_factories = NULL;
+G_LOCK_DEFINE_STATIC (gst_worker_factories);
+
+/*!< @internal Prebuilt caps by caps string, shared by all pipelines. */
+static GHashTable *gst_worker_caps = NULL;
+G_LOCK_DEFINE_STATIC (gst_worker_caps);
+
+/*!< @internal The memory and latency budget of the queues of all
+ *   pipelines, and the queues sharing it. */
+static guint64 gst_worker_budget_bytes = 0;
+static GstClockTime gst_worker_budget_time = 0;
+static GPtrArray *gst_worker_budget_queues = NULL;
+G_LOCK_DEFINE_STATIC (gst_worker_budget);
+
+/*!< @internal The latency profiles. The first is the default and keeps
+ *   the element defaults, the others only set what they change. */
+static const GstWorkerLatency gst_worker_latencies[] = {
+  {"balanced", 1000 * GST_MSECOND, FALSE, TRUE, TRUE,
+      1000 * GST_MSECOND, 1000 * GST_MSECOND, 100 * GST_MSECOND,
+      25 * GST_MSECOND},
+  {"ultra-low", 100 * GST_MSECOND, TRUE, FALSE, FALSE,
+      200 * GST_MSECOND, 100 * GST_MSECOND, 10 * GST_MSECOND,
+      5 * GST_MSECOND},
+  {"safe", 3000 * GST_MSECOND, FALSE, TRUE, TRUE,
+      5000 * GST_MSECOND, 2000 * GST_MSECOND, 200 * GST_MSECOND,
+      50 * GST_MSECOND},
+};
+
+static const GstWorkerLatency *gst_worker_latency = &gst_worker_latencies[0];
+
+/**
+ * @brief A queue sharing the budget.
+ * @param queue The queue, gone once the pipeline is freed.
+ * @param frame The size of a raw video frame through it, 0 if unknown.
+ * @param duration The duration of a frame, 0 if unknown.
+ */
+typedef struct _GstWorkerBudgetQueue
+{
+  GWeakRef queue;
+  guint64 frame;
+  GstClockTime duration;
+} GstWorkerBudgetQueue;
+
+static void
+gst_worker_budget_queue_free (GstWorkerBudgetQueue * entry)
+{
+  g_weak_ref_clear (&entry->queue);
+  g_free (entry);
+}
+
+/**
+ * @brief A link to make when a sometimes pad appears.
+ * @param sink The element to link the pad to.
+ * @param pad The sink pad name, or NULL for any.
+ */
+typedef struct _GstWorkerBuilderLink
+{
+  GstElement *sink;
+  gchar *pad;
+} GstWorkerBuilderLink;
+
+/**
+ * @brief How a pipeline was built, kept on the pipeline for updating it.
+ * @param shape The pipeline string without property values.
+ * @param elements The elements in the order they were added.
+ */
+typedef struct _GstWorkerBuilderRecord
+{
+  gchar *shape;
+  GPtrArray *elements;
+} GstWorkerBuilderRecord;
+
+static void
+gst_worker_builder_record_free (GstWorkerBuilderRecord * record)
+{
+  g_free (record->shape);
+  g_ptr_array_unref (record->elements);
+  g_free (record);
+}
+
+/**
+ * @param name The element factory name.
+ * @return The factory, owned by the cache, or NULL if not installed.
+ *
+ * Look up an element factory, only the first look up for a name searches
+ * the registry.
+ */
+static GstElementFactory *
+gst_worker_builder_find_factory (const gchar * name)
+{
+  GstElementFactory *factory;
+
+  G_LOCK (gst_worker_factories);
+  if (gst_worker_factories == NULL)
+    gst_worker_factories = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, gst_object_unref);
+
+  factory = g_hash_table_lookup (gst_worker_factories, name);
+  if (factory == NULL) {
+    factory = gst_element_factory_find (name);
+    if (factory)
+      g_hash_table_insert (gst_worker_factories, g_strdup (name), factory);
+  }
+  G_UNLOCK (gst_worker_factories);
+  return factory;
+}
+
+/**
+ * @param str The caps string.
+ * @return The caps, needs unref after used.
+ *
+ * Get the caps of a caps string, each distinct string is parsed once and
+ * the caps are shared from then on.
+ */
+GstCaps *
+gst_worker_caps_from_string (const gchar * str)
+{
+  GstCaps *caps;
+
+  G_LOCK (gst_worker_caps);
+  if (gst_worker_caps == NULL)
+    gst_worker_caps = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) gst_caps_unref);
+
+  caps = g_hash_table_lookup (gst_worker_caps, str);
+  if (caps == NULL) {
+    caps = gst_caps_from_string (str);
+    if (caps)
+      g_hash_table_insert (gst_worker_caps, g_strdup (str), caps);
+  }
+  if (caps)
+    gst_caps_ref (caps);
+  G_UNLOCK (gst_worker_caps);
+  return caps;
+}
+
+/**
+ * @param name The pipeline name.
+ * @return A new builder, free it with gst_worker_builder_free().
+ */
+GstWorkerBuilder *
+gst_worker_builder_new (const gchar * name)
+{
+  GstWorkerBuilder *builder = g_new0 (GstWorkerBuilder, 1);
+
+  builder->pipeline = gst_pipeline_new (name);
+  builder->desc = g_string_new ("");
+  builder->shape = g_string_new ("");
+  builder->elements = g_ptr_array_new ();
+  builder->missing = g_ptr_array_new_with_free_func (g_free);
+  return builder;
+}
+
+/**
+ * @param pipeline A pipeline built by a builder before.
+ * @return A new builder, or NULL if the pipeline wasn't built by a builder.
+ *
+ * Make a builder which updates the elements of a pipeline instead of
+ * adding new ones. The pipeline should be in the NULL state.
+ */
+GstWorkerBuilder *
+gst_worker_builder_new_update (GstElement * pipeline)
+{
+  GstWorkerBuilderRecord *record;
+  GstWorkerBuilder *builder;
+
+  record = g_object_get_data (G_OBJECT (pipeline), GST_WORKER_BUILDER_RECORD);
+  if (record == NULL)
+    return NULL;
+
+  builder = g_new0 (GstWorkerBuilder, 1);
+  builder->pipeline = gst_object_ref (pipeline);
+  builder->desc = g_string_new ("");
+  builder->shape = g_string_new ("");
+  builder->elements = g_ptr_array_ref (record->elements);
+  builder->missing = g_ptr_array_new_with_free_func (g_free);
+  builder->update = TRUE;
+  return builder;
+}
+
+/**
+ * @param builder The builder.
+ *
+ * Free the builder and the pipeline, unless it was taken with
+ * gst_worker_builder_finish().
+ */
+void
+gst_worker_builder_free (GstWorkerBuilder * builder)
+{
+  if (builder == NULL)
+    return;
+  if (builder->pipeline)
+    gst_object_unref (builder->pipeline);
+  g_string_free (builder->desc, TRUE);
+  g_string_free (builder->shape, TRUE);
+  g_ptr_array_unref (builder->elements);
+  g_ptr_array_free (builder->missing, TRUE);
+  gst_caps_replace (&builder->caps, NULL);
+  g_free (builder);
+}
+
+/**
+ * @param builder The builder.
+ * @return The pipeline, or NULL if anything failed or was missing, or if
+ *         an updated pipeline changed in more than property values.
+ *
+ * Take the built pipeline out of the builder.
+ */
+GstElement *
+gst_worker_builder_finish (GstWorkerBuilder * builder)
+{
+  GstWorkerBuilderRecord *record;
+  GstElement *pipeline = NULL;
+
+  if (builder->failed || builder->missing->len)
+    return NULL;
+
+  if (builder->update) {
+    record = g_object_get_data (G_OBJECT (builder->pipeline),
+        GST_WORKER_BUILDER_RECORD);
+    if (builder->position != builder->elements->len ||
+        g_strcmp0 (record->shape, builder->shape->str) != 0)
+      return NULL;
+  } else {
+    record = g_new0 (GstWorkerBuilderRecord, 1);
+    record->shape = g_strdup (builder->shape->str);
+    record->elements = g_ptr_array_ref (builder->elements);
+    g_object_set_data_full (G_OBJECT (builder->pipeline),
+        GST_WORKER_BUILDER_RECORD, record,
+        (GDestroyNotify) gst_worker_builder_record_free);
+  }
+
+  pipeline = builder->pipeline;
+  builder->pipeline = NULL;
+  return pipeline;
+}
+
+/**
+ * @param builder The builder, in update mode.
+ * @param factory The factory of the element added.
+ * @return The existing element, or NULL if it is not the same.
+ */
+static GstElement *
+gst_worker_builder_next (GstWorkerBuilder * builder,
+    GstElementFactory * factory)
+{
+  GstElement *element;
+
+  if (builder->failed || builder->position >= builder->elements->len) {
+    builder->failed = TRUE;
+    return NULL;
+  }
+
+  element = g_ptr_array_index (builder->elements, builder->position++);
+  if (gst_element_get_factory (element) != factory) {
+    builder->failed = TRUE;
+    return NULL;
+  }
+  return element;
+}
+
+/**
+ * @param builder The builder.
+ * @param object The element or pad to set the properties of.
+ * @param first_property The first property name.
+ * @param args The property values followed by more names, NULL terminated.
+ *
+ * Set typed properties and add them to the pipeline string. When updating,
+ * only properties with a different value are set.
+ */
+static void
+gst_worker_builder_set_valist (GstWorkerBuilder * builder,
+    GstObject * object, const gchar * first_property, va_list args)
+{
+  const gchar *name = first_property;
+
+  while (name) {
+    GValue value = G_VALUE_INIT;
+    GParamSpec *pspec;
+    gboolean changed = TRUE;
+    gchar *error = NULL;
+    gchar *str;
+
+    pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (object), name);
+    if (pspec == NULL) {
+      ERROR ("%s has no property %s", GST_OBJECT_NAME (object), name);
+      builder->failed = TRUE;
+      return;
+    }
+
+    G_VALUE_COLLECT_INIT (&value, pspec->value_type, args, 0, &error);
+    if (error) {
+      ERROR ("%s.%s: %s", GST_OBJECT_NAME (object), name, error);
+      g_free (error);
+      builder->failed = TRUE;
+      return;
+    }
+
+    if (builder->update && (pspec->flags & G_PARAM_READABLE)) {
+      GValue current = G_VALUE_INIT;
+      g_value_init (&current, pspec->value_type);
+      g_object_get_property (G_OBJECT (object), name, &current);
+      changed = g_param_values_cmp (pspec, &value, &current) != 0;
+      g_value_unset (&current);
+    }
+    if (changed)
+      g_object_set_property (G_OBJECT (object), name, &value);
+
+    str = gst_value_serialize (&value);
+    g_string_append_printf (builder->desc, "%s=%s ", name, str ? str : "?");
+    g_string_append_printf (builder->shape, "%s= ", name);
+    g_free (str);
+    g_value_unset (&value);
+
+    name = va_arg (args, const gchar *);
+  }
+}
+
+/**
+ * @param src The element that added the pad.
+ * @param pad The new pad.
+ * @param link The link to make.
+ *
+ * Link a sometimes pad, e.g. of decodebin, once it appears. The handler
+ * stays connected, the pad appears again each time the pipeline is reused.
+ */
+static void
+gst_worker_builder_pad_added (GstElement * src, GstPad * pad,
+    GstWorkerBuilderLink * link)
+{
+  if (GST_PAD_DIRECTION (pad) != GST_PAD_SRC || gst_pad_is_linked (pad))
+    return;
+
+  if (!gst_element_link_pads_full (src, GST_PAD_NAME (pad), link->sink,
+          link->pad, GST_WORKER_BUILDER_LINK_FLAGS)) {
+    WARN ("%s: can't link %s to %s", GST_ELEMENT_NAME (src),
+        GST_PAD_NAME (pad), GST_ELEMENT_NAME (link->sink));
+  }
+}
+
+static void
+gst_worker_builder_link_free (GstWorkerBuilderLink * link, GClosure * closure)
+{
+  g_free (link->pad);
+  g_free (link);
+}
+
+/**
+ * @param element The element.
+ * @return TRUE if the element adds source pads later on.
+ */
+static gboolean
+gst_worker_builder_has_sometimes_pads (GstElement * element)
+{
+  GList *templates =
+      gst_element_class_get_pad_template_list (GST_ELEMENT_GET_CLASS
+      (element));
+
+  for (; templates; templates = g_list_next (templates)) {
+    GstPadTemplate *templ = GST_PAD_TEMPLATE (templates->data);
+    if (GST_PAD_TEMPLATE_DIRECTION (templ) == GST_PAD_SRC &&
+        GST_PAD_TEMPLATE_PRESENCE (templ) == GST_PAD_SOMETIMES)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/**
+ * @param builder The builder.
+ * @param src The upstream element.
+ * @param sink The downstream element.
+ * @param pad The sink pad name, or NULL for any.
+ *
+ * Link two elements directly, request pads are requested as needed.
+ */
+static void
+gst_worker_builder_link (GstWorkerBuilder * builder, GstElement * src,
+    GstElement * sink, const gchar * pad)
+{
+  GstWorkerBuilderLink *link;
+
+  if (gst_element_link_pads_full (src, NULL, sink, pad,
+          GST_WORKER_BUILDER_LINK_FLAGS))
+    return;
+
+  if (!gst_worker_builder_has_sometimes_pads (src)) {
+    ERROR ("can't link %s to %s", GST_ELEMENT_NAME (src),
+        GST_ELEMENT_NAME (sink));
+    builder->failed = TRUE;
+    return;
+  }
+
+  link = g_new0 (GstWorkerBuilderLink, 1);
+  link->sink = sink;
+  link->pad = g_strdup (pad);
+  g_signal_connect_data (src, "pad-added",
+      G_CALLBACK (gst_worker_builder_pad_added), link,
+      (GClosureNotify) gst_worker_builder_link_free, 0);
+}
+
+/**
+ * @param builder The builder.
+ * @param factory The element factory name.
+ * @param name The element name, or NULL.
+ * @param first_property The first property name, or NULL.
+ * @param ... The property values followed by more names, NULL terminated.
+ * @return The element, owned by the pipeline, or NULL if not installed.
+ *
+ * Add an element to the end of the current chain, like "! factory" in a
+ * pipeline string. Property values must have the type of the property.
+ * When updating, the element added at this point before is used.
+ */
+GstElement *
+gst_worker_builder_add (GstWorkerBuilder * builder, const gchar * factory,
+    const gchar * name, const gchar * first_property, ...)
+{
+  GstElementFactory *elementfactory;
+  GstElement *element = NULL;
+  va_list args;
+
+  g_string_append_printf (builder->desc, "%s%s ",
+      builder->last ? "! " : "", factory);
+  g_string_append_printf (builder->shape, "%s%s ",
+      builder->last ? "! " : "", factory);
+  if (name) {
+    g_string_append_printf (builder->desc, "name=%s ", name);
+    g_string_append_printf (builder->shape, "name=%s ", name);
+  }
+
+  elementfactory = gst_worker_builder_find_factory (factory);
+  if (elementfactory == NULL) {
+    g_ptr_array_add (builder->missing, g_strdup (factory));
+    builder->last = NULL;
+    return NULL;
+  }
+
+  if (builder->update) {
+    element = gst_worker_builder_next (builder, elementfactory);
+  } else {
+    element = gst_element_factory_create (elementfactory, name);
+    if (element == NULL)
+      g_ptr_array_add (builder->missing, g_strdup (factory));
+  }
+  if (element == NULL) {
+    builder->last = NULL;
+    return NULL;
+  }
+
+  va_start (args, first_property);
+  gst_worker_builder_set_valist (builder, GST_OBJECT (element),
+      first_property, args);
+  va_end (args);
+
+  if (!builder->update) {
+    gst_bin_add (GST_BIN (builder->pipeline), element);
+    g_ptr_array_add (builder->elements, element);
+    if (builder->last)
+      gst_worker_builder_link (builder, builder->last, element, NULL);
+  }
+  // Chains continued from the element carry the same caps
+  g_object_set_data_full (G_OBJECT (element), GST_WORKER_BUILDER_CAPS,
+      builder->caps ? gst_caps_ref (builder->caps) : NULL,
+      (GDestroyNotify) gst_caps_unref);
+  builder->last = element;
+  return element;
+}
+
+/**
+ * @param builder The builder.
+ * @param first_property The first property name.
+ * @param ... The property values followed by more names, NULL terminated.
+ *
+ * Set more typed properties of the element added last.
+ */
+void
+gst_worker_builder_set (GstWorkerBuilder * builder,
+    const gchar * first_property, ...)
+{
+  va_list args;
+
+  if (builder->last == NULL)
+    return;
+
+  va_start (args, first_property);
+  gst_worker_builder_set_valist (builder, GST_OBJECT (builder->last),
+      first_property, args);
+  va_end (args);
+}
+
+/**
+ * @param builder The builder.
+ * @param name The element.
+ * @param pad The pad of the element.
+ * @param first_property The first property name.
+ * @param ... The property values followed by more names, NULL terminated.
+ *
+ * Set typed properties of a pad, e.g. a request pad of a mixer once it
+ * was linked, like "name. pad::property" in a pipeline string.
+ */
+void
+gst_worker_builder_set_pad (GstWorkerBuilder * builder, const gchar * name,
+    const gchar * pad, const gchar * first_property, ...)
+{
+  GstElement *element = NULL;
+  GstPad *elementpad = NULL;
+  va_list args;
+
+  g_string_append_printf (builder->desc, "\n%s.%s:: ", name, pad);
+  g_string_append_printf (builder->shape, "\n%s.%s:: ", name, pad);
+  element = gst_bin_get_by_name (GST_BIN (builder->pipeline), name);
+  if (element) {
+    elementpad = gst_element_get_static_pad (element, pad);
+    gst_object_unref (element);
+  }
+  if (elementpad == NULL) {
+    // The element may be missing, which is reported when it was added
+    if (element)
+      ERROR ("no pad %s.%s", name, pad);
+    builder->failed = TRUE;
+    return;
+  }
+
+  va_start (args, first_property);
+  gst_worker_builder_set_valist (builder, GST_OBJECT (elementpad),
+      first_property, args);
+  va_end (args);
+  gst_object_unref (elementpad);
+}
+
+/**
+ * @param builder The builder.
+ * @param property The property name.
+ * @param value The property value as a string.
+ *
+ * Set a property of the element added last from a string, for enums and
+ * flags which are known by their nicks.
+ */
+void
+gst_worker_builder_set_arg (GstWorkerBuilder * builder,
+    const gchar * property, const gchar * value)
+{
+  g_string_append_printf (builder->desc, "%s=%s ", property, value);
+  g_string_append_printf (builder->shape, "%s= ", property);
+  if (builder->last)
+    gst_util_set_object_arg (G_OBJECT (builder->last), property, value);
+}
+
+/**
+ * @param builder The builder.
+ * @param format The caps string format.
+ * @param ... The format arguments.
+ *
+ * Add a capsfilter to the current chain, the caps are shared with every
+ * other pipeline using the same caps. When updating, the caps of the
+ * capsfilter added at this point before are replaced if different.
+ */
+void
+gst_worker_builder_caps (GstWorkerBuilder * builder, const gchar * format,
+    ...)
+{
+  GstElement *last = builder->last;
+  GstElement *filter;
+  GstCaps *caps;
+  va_list args;
+  gchar *str;
+
+  va_start (args, format);
+  str = g_strdup_vprintf (format, args);
+  va_end (args);
+
+  caps = gst_worker_caps_from_string (str);
+  if (caps == NULL) {
+    ERROR ("invalid caps: %s", str);
+    builder->failed = TRUE;
+    builder->last = NULL;
+    g_free (str);
+    return;
+  }
+
+  g_string_append_printf (builder->desc, "%s%s ", last ? "! " : "", str);
+  g_string_append_printf (builder->shape, "%scaps ", last ? "! " : "");
+  g_free (str);
+
+  gst_caps_replace (&builder->caps, caps);
+
+  if (builder->update) {
+    GstCaps *current = NULL;
+
+    filter = gst_worker_builder_next (builder,
+        gst_worker_builder_find_factory ("capsfilter"));
+    if (filter)
+      g_object_get (filter, "caps", &current, NULL);
+    if (filter && (current == NULL || !gst_caps_is_equal (current, caps)))
+      g_object_set (filter, "caps", caps, NULL);
+    if (current)
+      gst_caps_unref (current);
+    gst_caps_unref (caps);
+    builder->last = filter;
+    return;
+  }
+
+  filter = gst_element_factory_create (gst_worker_builder_find_factory
+      ("capsfilter"), NULL);
+  g_object_set (filter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  gst_bin_add (GST_BIN (builder->pipeline), filter);
+  g_ptr_array_add (builder->elements, filter);
+  if (last)
+    gst_worker_builder_link (builder, last, filter, NULL);
+  builder->last = filter;
+}
+
+/**
+ * @param builder The builder.
+ * @param enc The encoder spec, see parse_encoder().
+ * @param name The name of the (first) encoder element, or NULL.
+ *
+ * Add the elements of an encoder spec to the current chain. Nothing is
+ * added for raw video, an invalid spec fails the build.
+ */
+void
+gst_worker_builder_encoder (GstWorkerBuilder * builder,
+    const GstSwitchEncoder * enc, const gchar * name)
+{
+  if (!gst_switch_encoder_is_valid (enc)) {
+    ERROR ("invalid encoder for %s", name ? name : "encoder");
+    builder->failed = TRUE;
+    builder->last = NULL;
+    return;
+  }
+
+  // The caps are unknown past an encoder
+  if (enc->type != GST_SWITCH_ENCODER_RAW)
+    gst_caps_replace (&builder->caps, NULL);
+
+  switch (enc->type) {
+    case GST_SWITCH_ENCODER_MJPEG:
+      gst_worker_builder_add (builder, "jpegenc", name,
+          "quality", (gint) enc->quality, NULL);
+      break;
+    case GST_SWITCH_ENCODER_H264:
+      if (!gst_worker_builder_add (builder, "x264enc", name, NULL))
+        break;
+      gst_worker_builder_set_arg (builder, "speed-preset", enc->preset);
+      if (enc->crf) {
+        gst_worker_builder_set_arg (builder, "pass", "qual");
+        gst_worker_builder_set (builder, "quantizer", enc->crf, NULL);
+      } else {
+        gst_worker_builder_set (builder, "bitrate", enc->bitrate, NULL);
+      }
+      if (enc->zerolatency)
+        gst_worker_builder_set_arg (builder, "tune", "zerolatency");
+      if (enc->threads)
+        gst_worker_builder_set (builder, "threads", enc->threads, NULL);
+      if (enc->keyint)
+        gst_worker_builder_set (builder, "key-int-max", enc->keyint, NULL);
+      gst_worker_builder_add (builder, "h264parse", NULL,
+          "config-interval", (gint) 1, NULL);
+      break;
+    case GST_SWITCH_ENCODER_FFV1:
+      gst_worker_builder_add (builder, "avenc_ffv1", name, NULL);
+      if (enc->threads)
+        gst_worker_builder_set (builder, "threads", (gint) enc->threads, NULL);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @param builder The builder.
+ * @param name The element to continue from, or NULL to start a new chain.
+ *
+ * Start a new chain from an element added before, like "name." in a
+ * pipeline string.
+ */
+void
+gst_worker_builder_from (GstWorkerBuilder * builder, const gchar * name)
+{
+  GstElement *element = NULL;
+
+  g_string_append_printf (builder->desc, "\n");
+  g_string_append_printf (builder->shape, "\n");
+  gst_caps_replace (&builder->caps, NULL);
+  builder->last = NULL;
+  if (name == NULL)
+    return;
+
+  g_string_append_printf (builder->desc, "%s. ", name);
+  g_string_append_printf (builder->shape, "%s. ", name);
+  element = gst_bin_get_by_name (GST_BIN (builder->pipeline), name);
+  if (element == NULL) {
+    ERROR ("no element %s to link from", name);
+    builder->failed = TRUE;
+    return;
+  }
+  // The pipeline holds a reference
+  builder->last = element;
+  gst_caps_replace (&builder->caps,
+      g_object_get_data (G_OBJECT (element), GST_WORKER_BUILDER_CAPS));
+  gst_object_unref (element);
+}
+
+/**
+ * @param builder The builder.
+ * @param name The element to link the current chain to.
+ * @param pad The pad name or request pad template, or NULL for any.
+ *
+ * Link the end of the current chain to an element added before, like
+ * "! name.pad" in a pipeline string, and end the chain.
+ */
+void
+gst_worker_builder_link_to (GstWorkerBuilder * builder, const gchar * name,
+    const gchar * pad)
+{
+  GstElement *element = NULL;
+
+  g_string_append_printf (builder->desc, "! %s.%s ", name, pad ? pad : "");
+  g_string_append_printf (builder->shape, "! %s.%s ", name, pad ? pad : "");
+  if (builder->last)
+    element = gst_bin_get_by_name (GST_BIN (builder->pipeline), name);
+  if (element) {
+    if (!builder->update)
+      gst_worker_builder_link (builder, builder->last, element, pad);
+    gst_object_unref (element);
+  } else if (builder->last) {
+    ERROR ("no element %s to link to", name);
+    builder->failed = TRUE;
+  }
+  builder->last = NULL;
+}
+
+/**
+ * @param bytes The memory all queues may hold, 0 for no budget.
+ * @param latency The time each queue may hold, 0 for the default.
+ *
+ * Budget the queues added by gst_worker_builder_queue() from now on.
+ */
+void
+gst_worker_builder_set_budget (guint64 bytes, GstClockTime latency)
+{
+  G_LOCK (gst_worker_budget);
+  gst_worker_budget_bytes = bytes;
+  gst_worker_budget_time = latency;
+  if (gst_worker_budget_queues == NULL) {
+    gst_worker_budget_queues = g_ptr_array_new_with_free_func
+        ((GDestroyNotify) gst_worker_budget_queue_free);
+  }
+  G_UNLOCK (gst_worker_budget);
+}
+
+/**
+ * @param caps The negotiated caps of a queue, or NULL.
+ * @param duration Set to the duration of a frame, 0 if unknown.
+ * @return The size of a raw video frame, 0 if unknown.
+ */
+static guint64
+gst_worker_budget_frame (GstCaps * caps, GstClockTime * duration)
+{
+  GstVideoInfo info;
+  guint64 size = 0;
+
+  *duration = 0;
+  if (caps == NULL || !gst_structure_has_name (gst_caps_get_structure (caps,
+              0), "video/x-raw"))
+    return 0;
+
+  if (gst_video_info_from_caps (&info, caps)) {
+    size = GST_VIDEO_INFO_SIZE (&info);
+    if (GST_VIDEO_INFO_FPS_N (&info) > 0)
+      *duration = gst_util_uint64_scale_int (GST_SECOND,
+          GST_VIDEO_INFO_FPS_D (&info), GST_VIDEO_INFO_FPS_N (&info));
+  }
+  return size;
+}
+
+/**
+ * @brief Split the budget evenly between the queues still alive.
+ *
+ * Each queue holds its share of the memory and the latency budget, and as
+ * many raw frames as fit in both. Called with the budget lock held, from
+ * whichever thread added a queue or negotiated its caps.
+ */
+static void
+gst_worker_budget_rebalance (void)
+{
+  GPtrArray *live = g_ptr_array_new_with_free_func (gst_object_unref);
+  guint64 share;
+  guint n;
+
+  for (n = 0; n < gst_worker_budget_queues->len;) {
+    GstWorkerBudgetQueue *entry = g_ptr_array_index (gst_worker_budget_queues,
+        n);
+    GstElement *queue = g_weak_ref_get (&entry->queue);
+
+    if (queue == NULL) {
+      g_ptr_array_remove_index_fast (gst_worker_budget_queues, n);
+      continue;
+    }
+    g_ptr_array_add (live, queue);
+    ++n;
+  }
+
+  // The queues gone are removed, so the entries match the live queues
+  share = live->len ? gst_worker_budget_bytes / live->len : 0;
+  for (n = 0; n < live->len; ++n) {
+    GstWorkerBudgetQueue *entry = g_ptr_array_index (gst_worker_budget_queues,
+        n);
+    GstElement *queue = g_ptr_array_index (live, n);
+    guint buffers = 0;
+
+    if (entry->frame && gst_worker_budget_bytes) {
+      guint64 frames = share / entry->frame;
+      if (entry->duration && gst_worker_budget_time)
+        frames = MIN (frames, gst_worker_budget_time / entry->duration);
+      buffers = (guint) CLAMP (frames, 1, G_MAXUINT);
+    }
+    if (gst_worker_budget_bytes)
+      g_object_set (queue, "max-size-bytes", (guint) MIN (share, G_MAXUINT),
+          "max-size-buffers", buffers, NULL);
+    if (gst_worker_budget_time)
+      g_object_set (queue, "max-size-time", gst_worker_budget_time, NULL);
+  }
+
+  g_ptr_array_free (live, TRUE);
+}
+
+/**
+ * @brief Size the frames of a queue once its caps are negotiated.
+ * @param pad The sink pad of the queue.
+ *
+ * Invoked from the streaming thread. The caps of the chain at build time
+ * may leave the size or format open, the negotiated caps don't.
+ */
+static void
+gst_worker_budget_caps_changed (GstPad * pad, GParamSpec * pspec,
+    gpointer data)
+{
+  GstCaps *caps = gst_pad_get_current_caps (pad);
+  GstObject *queue = gst_pad_get_parent (pad);
+  guint n;
+
+  G_LOCK (gst_worker_budget);
+  for (n = 0; queue && n < gst_worker_budget_queues->len; ++n) {
+    GstWorkerBudgetQueue *entry = g_ptr_array_index (gst_worker_budget_queues,
+        n);
+    GstElement *element = g_weak_ref_get (&entry->queue);
+    if (element) {
+      gst_object_unref (element);
+      if (GST_OBJECT (element) == queue) {
+        entry->frame = gst_worker_budget_frame (caps, &entry->duration);
+        gst_worker_budget_rebalance ();
+        break;
+      }
+    }
+  }
+  G_UNLOCK (gst_worker_budget);
+
+  if (queue)
+    gst_object_unref (queue);
+  if (caps)
+    gst_caps_unref (caps);
+}
+
+/**
+ * @param builder The builder.
+ * @param name The queue name, or NULL.
+ * @param raw_video TRUE if the queue holds raw video frames.
+ * @return The queue, or NULL if it could not be added.
+ *
+ * Add a queue to the current chain, holding a share of the budget set by
+ * gst_worker_builder_set_budget() instead of the default limits. Raw video
+ * queues are limited to whole frames of their negotiated caps, so a backed
+ * up queue never holds more than its share of memory or latency. The
+ * shares are rebalanced as queues come and go. Raw video queues of a leaky
+ * latency profile drop the oldest frames when full, audio and encoded
+ * data can't be dropped without breaking what follows.
+ */
+GstElement *
+gst_worker_builder_queue (GstWorkerBuilder * builder, const gchar * name,
+    gboolean raw_video)
+{
+  GstElement *queue = gst_worker_builder_add (builder, "queue", name, NULL);
+  GstWorkerBudgetQueue *entry;
+  guint n;
+
+  if (queue == NULL)
+    return NULL;
+
+  if (raw_video && gst_worker_latency->leaky)
+    gst_worker_builder_set_arg (builder, "leaky", "downstream");
+
+  G_LOCK (gst_worker_budget);
+  if (gst_worker_budget_bytes == 0 && gst_worker_budget_time == 0) {
+    G_UNLOCK (gst_worker_budget);
+    return queue;
+  }
+
+  // An updated pipeline keeps the queues it already had
+  for (n = 0; n < gst_worker_budget_queues->len; ++n) {
+    GstWorkerBudgetQueue *other = g_ptr_array_index (gst_worker_budget_queues,
+        n);
+    GstElement *element = g_weak_ref_get (&other->queue);
+    if (element) {
+      gst_object_unref (element);
+      if (element == queue)
+        break;
+    }
+  }
+  if (n == gst_worker_budget_queues->len) {
+    GstPad *pad = gst_element_get_static_pad (queue, "sink");
+    entry = g_new0 (GstWorkerBudgetQueue, 1);
+    g_weak_ref_init (&entry->queue, queue);
+    g_ptr_array_add (gst_worker_budget_queues, entry);
+    g_signal_connect (pad, "notify::caps",
+        G_CALLBACK (gst_worker_budget_caps_changed), NULL);
+    gst_object_unref (pad);
+  }
+  gst_worker_budget_rebalance ();
+  G_UNLOCK (gst_worker_budget);
+
+  return queue;
+}
+
+/**
+ * @param element The element.
+ * @param property A property name.
+ * @return TRUE if the element has the property, which inter elements of
+ *         older versions may not have.
+ */
+static gboolean
+gst_worker_builder_has_property (GstElement * element, const gchar * property)
+{
+  return g_object_class_find_property (G_OBJECT_GET_CLASS (element),
+      property) != NULL;
+}
+
+/**
+ * @param builder The builder.
+ * @param factory The inter element, e.g. intervideosrc.
+ * @param name The element name, or NULL.
+ * @param channel The channel name.
+ * @return The element, or NULL if it could not be added.
+ *
+ * Add an inter element on a channel, set up to wait as long as the latency
+ * profile does: sinks sync to the clock or not, video sources send black
+ * after the profile timeout and audio sources hold the profile buffer.
+ * Settings equal to those of the default profile are left unset.
+ */
+GstElement *
+gst_worker_builder_inter (GstWorkerBuilder * builder, const gchar * factory,
+    const gchar * name, const gchar * channel)
+{
+  const GstWorkerLatency *latency = gst_worker_latency;
+  const GstWorkerLatency *defaults = &gst_worker_latencies[0];
+  GstElement *element;
+
+  element = gst_worker_builder_add (builder, factory, name,
+      "channel", channel, NULL);
+  if (element == NULL)
+    return NULL;
+
+  if (latency == defaults)
+    return element;
+
+  if (g_str_has_suffix (factory, "sink")) {
+    if (latency->inter_sync != defaults->inter_sync)
+      gst_worker_builder_set (builder, "sync", latency->inter_sync, NULL);
+  } else if (gst_worker_builder_has_property (element, "timeout")) {
+    gst_worker_builder_set (builder, "timeout", latency->inter_timeout, NULL);
+  } else if (gst_worker_builder_has_property (element, "period-time")) {
+    gst_worker_builder_set (builder,
+        "buffer-time", latency->audio_buffer_time,
+        "latency-time", latency->audio_latency_time,
+        "period-time", latency->audio_period_time, NULL);
+  }
+  return element;
+}
+
+/**
+ * @param builder The builder.
+ *
+ * Let the client sink just added wait for the clock or not, as the latency
+ * profile does. Left at the element default unless the profile changes it.
+ */
+void
+gst_worker_builder_serve_sync (GstWorkerBuilder * builder)
+{
+  if (gst_worker_latency->serve_sync != gst_worker_latencies[0].serve_sync)
+    gst_worker_builder_set (builder, "sync", gst_worker_latency->serve_sync,
+        NULL);
+}
+
+/**
+ * @param name The profile name: ultra-low, balanced or safe, or NULL for
+ *        the default.
+ * @return TRUE if the profile exists
+ *
+ * Select the latency profile of the pipelines built from now on.
+ */
+gboolean
+gst_worker_latency_configure (const gchar * name)
+{
+  guint n;
+
+  if (name == NULL) {
+    gst_worker_latency = &gst_worker_latencies[0];
+    return TRUE;
+  }
+  for (n = 0; n < G_N_ELEMENTS (gst_worker_latencies); ++n) {
+    if (g_str_equal (name, gst_worker_latencies[n].name)) {
+      gst_worker_latency = &gst_worker_latencies[n];
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+ * @return The latency profile in use.
+ */
+const GstWorkerLatency *
+gst_worker_latency_get (void)
+{
+  return gst_worker_latency;
+}
@@ -0,0 +1,113 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_WORKER_BUILDER_H__
+#define __GST_WORKER_BUILDER_H__
+
+#include <gst/gst.h>
+#include "gstswitchopts.h"
+
+typedef struct _GstWorkerBuilder GstWorkerBuilder;
+typedef struct _GstWorkerLatency GstWorkerLatency;
+
+/**
+ *  @struct _GstWorkerBuilder
+ *  @brief Builds a pipeline element by element.
+ *
+ *  Elements are added to a chain and linked to the end of it as they are
+ *  added, like the "!" of a pipeline string. Element factories and caps
+ *  are looked up once per process and shared, nothing is parsed. The
+ *  pipeline string equivalent is kept for debugging only.
+ *
+ *  A builder made with gst_worker_builder_new_update() walks a pipeline
+ *  built before instead, setting properties and caps on its elements. It
+ *  only succeeds if the same elements are added in the same way.
+ */
+struct _GstWorkerBuilder
+{
+  GstElement *pipeline;         /*!< the pipeline being built */
+  GstElement *last;             /*!< the end of the current chain */
+  GString *desc;                /*!< the pipeline string equivalent */
+  GString *shape;               /*!< the pipeline string without values */
+  GPtrArray *elements;          /*!< the elements in the order added */
+  GPtrArray *missing;           /*!< names of elements not installed */
+  gboolean failed;              /*!< an element could not be set up */
+  gboolean update;              /*!< updating an existing pipeline */
+  guint position;               /*!< the next element to update */
+  GstCaps *caps;                /*!< the caps of the current chain */
+};
+
+GstWorkerBuilder *gst_worker_builder_new (const gchar * name);
+GstWorkerBuilder *gst_worker_builder_new_update (GstElement * pipeline);
+void gst_worker_builder_free (GstWorkerBuilder * builder);
+GstElement *gst_worker_builder_finish (GstWorkerBuilder * builder);
+
+GstElement *gst_worker_builder_add (GstWorkerBuilder * builder,
+    const gchar * factory, const gchar * name,
+    const gchar * first_property, ...) G_GNUC_NULL_TERMINATED;
+void gst_worker_builder_set (GstWorkerBuilder * builder,
+    const gchar * first_property, ...) G_GNUC_NULL_TERMINATED;
+void gst_worker_builder_set_pad (GstWorkerBuilder * builder,
+    const gchar * name, const gchar * pad,
+    const gchar * first_property, ...) G_GNUC_NULL_TERMINATED;
+void gst_worker_builder_set_arg (GstWorkerBuilder * builder,
+    const gchar * property, const gchar * value);
+void gst_worker_builder_caps (GstWorkerBuilder * builder,
+    const gchar * format, ...) G_GNUC_PRINTF (2, 3);
+void gst_worker_builder_encoder (GstWorkerBuilder * builder,
+    const GstSwitchEncoder * enc, const gchar * name);
+void gst_worker_builder_from (GstWorkerBuilder * builder, const gchar * name);
+void gst_worker_builder_link_to (GstWorkerBuilder * builder,
+    const gchar * name, const gchar * pad);
+GstElement *gst_worker_builder_queue (GstWorkerBuilder * builder,
+    const gchar * name, gboolean raw_video);
+void gst_worker_builder_set_budget (guint64 bytes, GstClockTime latency);
+
+GstElement *gst_worker_builder_inter (GstWorkerBuilder * builder,
+    const gchar * factory, const gchar * name, const gchar * channel);
+void gst_worker_builder_serve_sync (GstWorkerBuilder * builder);
+
+GstCaps *gst_worker_caps_from_string (const gchar * str);
+
+/**
+ *  @struct _GstWorkerLatency
+ *  @brief How much every pipeline trades latency for smoothness.
+ *
+ *  One profile is used by all pipelines, so the queues, sinks and inter
+ *  channels of a path all wait about as long as each other.
+ */
+struct _GstWorkerLatency
+{
+  const gchar *name;            /*!< the profile name */
+  GstClockTime queue_time;      /*!< the time a queue holds by default */
+  gboolean leaky;               /*!< queues drop the oldest when full */
+  gboolean inter_sync;          /*!< inter sinks wait for the clock */
+  gboolean serve_sync;          /*!< client sinks wait for the clock */
+  GstClockTime inter_timeout;   /*!< until an inter source sends black */
+  GstClockTime audio_buffer_time;       /*!< the audio held by a channel */
+  GstClockTime audio_latency_time;      /*!< the audio read at once */
+  GstClockTime audio_period_time;       /*!< the audio written at once */
+};
+
+gboolean gst_worker_latency_configure (const gchar * name);
+const GstWorkerLatency *gst_worker_latency_get (void);
+
+#endif //__GST_WORKER_BUILDER_H__
@@ -0,0 +1,308 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstworkerscheduler.h"
+#include "../logutils.h"
+
+/*!< @internal The threads starting and stopping workers, shared by all
+ *   schedulers. */
+static GThreadPool *gst_worker_scheduler_pool = NULL;
+static gint gst_worker_scheduler_threads = 0;
+G_LOCK_DEFINE_STATIC (gst_worker_scheduler_pool);
+
+/**
+ * @brief Starting or stopping one worker of a batch.
+ * @param scheduler The scheduler running the task.
+ * @param worker The worker to start or stop.
+ * @param stop TRUE to stop the worker, FALSE to start it.
+ * @param waiting The number of dependencies not done yet.
+ * @param dependents The tasks depending on this one.
+ * @param done TRUE once the task has run.
+ * @param ok TRUE if the task succeeded.
+ * @param blocked TRUE if a worker it depends on failed to start.
+ */
+typedef struct _GstWorkerTask
+{
+  GstWorkerScheduler *scheduler;
+  GstWorker *worker;
+  gboolean stop;
+  guint waiting;
+  GPtrArray *dependents;
+  gboolean done;
+  gboolean ok;
+  gboolean blocked;
+} GstWorkerTask;
+
+static void
+gst_worker_task_free (GstWorkerTask * task)
+{
+  g_ptr_array_unref (task->dependents);
+  g_object_unref (task->worker);
+  g_free (task);
+}
+
+/**
+ * @param threads The number of threads, 0 for one per processor.
+ *
+ * Set how many workers may be started or stopped at the same time. It
+ * only takes effect before the first batch is run.
+ */
+void
+gst_worker_scheduler_set_threads (gint threads)
+{
+  G_LOCK (gst_worker_scheduler_pool);
+  gst_worker_scheduler_threads = MAX (threads, 0);
+  G_UNLOCK (gst_worker_scheduler_pool);
+}
+
+/**
+ * @return A new empty batch.
+ */
+GstWorkerScheduler *
+gst_worker_scheduler_new (void)
+{
+  GstWorkerScheduler *scheduler = g_new0 (GstWorkerScheduler, 1);
+
+  g_mutex_init (&scheduler->lock);
+  g_cond_init (&scheduler->cond);
+  scheduler->tasks = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_worker_task_free);
+  return scheduler;
+}
+
+void
+gst_worker_scheduler_free (GstWorkerScheduler * scheduler)
+{
+  g_return_if_fail (scheduler->pending == 0);
+
+  g_ptr_array_unref (scheduler->tasks);
+  g_cond_clear (&scheduler->cond);
+  g_mutex_clear (&scheduler->lock);
+  g_free (scheduler);
+}
+
+/**
+ * @return The task of the worker in the batch, or NULL.
+ */
+static GstWorkerTask *
+gst_worker_scheduler_find (GstWorkerScheduler * scheduler, GstWorker * worker)
+{
+  guint n;
+
+  for (n = 0; n < scheduler->tasks->len; ++n) {
+    GstWorkerTask *task = g_ptr_array_index (scheduler->tasks, n);
+    if (task->worker == worker)
+      return task;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Queue a task depending on the tasks of the workers in the list.
+ */
+static void
+gst_worker_scheduler_add (GstWorkerScheduler * scheduler, GstWorker * worker,
+    gboolean stop, va_list var_args)
+{
+  GstWorkerTask *task;
+  GstWorker *dependency;
+
+  g_return_if_fail (GST_IS_WORKER (worker));
+  g_return_if_fail (gst_worker_scheduler_find (scheduler, worker) == NULL);
+
+  task = g_new0 (GstWorkerTask, 1);
+  task->scheduler = scheduler;
+  task->worker = GST_WORKER (g_object_ref (worker));
+  task->stop = stop;
+  task->dependents = g_ptr_array_new ();
+
+  while ((dependency = va_arg (var_args, GstWorker *))) {
+    GstWorkerTask *before = gst_worker_scheduler_find (scheduler, dependency);
+
+    // A worker not in this batch is already where it should be
+    if (before) {
+      g_ptr_array_add (before->dependents, task);
+      task->waiting += 1;
+    }
+  }
+
+  g_ptr_array_add (scheduler->tasks, task);
+}
+
+/**
+ * @param worker The worker to start.
+ * @param ... The workers it depends on, terminated by NULL.
+ *
+ * Queue starting a worker once the workers it depends on are done.
+ */
+void
+gst_worker_scheduler_start (GstWorkerScheduler * scheduler,
+    GstWorker * worker, ...)
+{
+  va_list var_args;
+
+  va_start (var_args, worker);
+  gst_worker_scheduler_add (scheduler, worker, FALSE, var_args);
+  va_end (var_args);
+}
+
+/**
+ * @param worker The worker to stop.
+ * @param ... The workers it depends on, terminated by NULL.
+ *
+ * Queue stopping a worker once the workers it depends on are done.
+ */
+void
+gst_worker_scheduler_stop (GstWorkerScheduler * scheduler,
+    GstWorker * worker, ...)
+{
+  va_list var_args;
+
+  va_start (var_args, worker);
+  gst_worker_scheduler_add (scheduler, worker, TRUE, var_args);
+  va_end (var_args);
+}
+
+/**
+ * @brief Run a task on a pool thread, then release its dependents.
+ */
+static void
+gst_worker_scheduler_execute (GstWorkerTask * task, gpointer data)
+{
+  GstWorkerScheduler *scheduler = task->scheduler;
+  gboolean ok = FALSE;
+  guint n;
+
+  if (task->blocked) {
+    ERROR ("not %s %s, a worker it depends on failed to start",
+        task->stop ? "stopping" : "starting", task->worker->name);
+  } else if (task->stop) {
+    ok = gst_worker_stop (task->worker);
+  } else {
+    ok = gst_worker_start (task->worker);
+  }
+
+  g_mutex_lock (&scheduler->lock);
+  task->ok = ok;
+  task->done = TRUE;
+  for (n = 0; n < task->dependents->len; ++n) {
+    GstWorkerTask *next = g_ptr_array_index (task->dependents, n);
+    // Stopping only orders the batch, a stop which failed blocks nothing
+    next->blocked |= !ok && !task->stop;
+    if (--next->waiting == 0 && gst_worker_scheduler_pool)
+      g_thread_pool_push (gst_worker_scheduler_pool, next, NULL);
+  }
+  scheduler->pending -= 1;
+  g_cond_broadcast (&scheduler->cond);
+  g_mutex_unlock (&scheduler->lock);
+}
+
+/**
+ * @return The shared thread pool.
+ */
+static GThreadPool *
+gst_worker_scheduler_get_pool (void)
+{
+  GError *error = NULL;
+
+  G_LOCK (gst_worker_scheduler_pool);
+  if (gst_worker_scheduler_pool == NULL) {
+    gint threads = gst_worker_scheduler_threads;
+    if (threads <= 0)
+      threads = MAX (g_get_num_processors (), 2);
+    gst_worker_scheduler_pool = g_thread_pool_new ((GFunc)
+        gst_worker_scheduler_execute, NULL, threads, FALSE, &error);
+    if (error) {
+      ERROR ("worker scheduler: %s", error->message);
+      g_error_free (error);
+    }
+  }
+  G_UNLOCK (gst_worker_scheduler_pool);
+
+  return gst_worker_scheduler_pool;
+}
+
+/**
+ * @return TRUE if every worker of the batch was started or stopped.
+ *
+ * Start and stop the workers of the batch, each as soon as the workers it
+ * depends on are done, and wait for all of them. Workers are only
+ * prepared and set to READY concurrently, the rest of their start up
+ * happens in the main loop as usual.
+ */
+gboolean
+gst_worker_scheduler_run (GstWorkerScheduler * scheduler)
+{
+  GThreadPool *pool = gst_worker_scheduler_get_pool ();
+  gboolean ok = TRUE;
+  gint64 start = g_get_monotonic_time ();
+  guint n;
+
+  g_mutex_lock (&scheduler->lock);
+  scheduler->pending = scheduler->tasks->len;
+  for (n = 0; n < scheduler->tasks->len; ++n) {
+    GstWorkerTask *task = g_ptr_array_index (scheduler->tasks, n);
+    if (task->waiting > 0)
+      continue;
+    if (pool) {
+      g_thread_pool_push (pool, task, NULL);
+    } else {
+      // Without threads, the queued order satisfies the dependencies
+      g_mutex_unlock (&scheduler->lock);
+      gst_worker_scheduler_execute (task, NULL);
+      g_mutex_lock (&scheduler->lock);
+    }
+  }
+  while (scheduler->pending > 0)
+    g_cond_wait (&scheduler->cond, &scheduler->lock);
+
+  for (n = 0; n < scheduler->tasks->len; ++n) {
+    GstWorkerTask *task = g_ptr_array_index (scheduler->tasks, n);
+    ok = ok && task->ok;
+  }
+  g_mutex_unlock (&scheduler->lock);
+
+  INFO ("%u workers done in %" G_GINT64_FORMAT " us",
+      scheduler->tasks->len, g_get_monotonic_time () - start);
+  return ok;
+}
+
+/**
+ * @param worker A worker of the batch.
+ * @return TRUE if the worker was started or stopped by the last run.
+ */
+gboolean
+gst_worker_scheduler_succeeded (GstWorkerScheduler * scheduler,
+    GstWorker * worker)
+{
+  GstWorkerTask *task;
+  gboolean ok;
+
+  g_mutex_lock (&scheduler->lock);
+  task = gst_worker_scheduler_find (scheduler, worker);
+  ok = task && task->done && task->ok;
+  g_mutex_unlock (&scheduler->lock);
+  return ok;
+}
@@ -0,0 +1,59 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_WORKER_SCHEDULER_H__
+#define __GST_WORKER_SCHEDULER_H__
+
+#include "gstworker.h"
+
+typedef struct _GstWorkerScheduler GstWorkerScheduler;
+
+/**
+ *  @struct _GstWorkerScheduler
+ *  @brief Starts and stops a batch of workers concurrently.
+ *
+ *  Workers are queued with the workers they depend on, which must have
+ *  been queued in the same batch before. gst_worker_scheduler_run() then
+ *  starts or stops every worker on a shared thread pool as soon as its
+ *  dependencies are done, and waits for the whole batch. A worker is not
+ *  started or stopped if a worker it depends on failed to start.
+ */
+struct _GstWorkerScheduler
+{
+  GMutex lock;                  /*!< protects the tasks while running */
+  GCond cond;                   /*!< signaled when a task is done */
+  GPtrArray *tasks;             /*!< the tasks in the order queued */
+  guint pending;                /*!< the tasks not done yet */
+};
+
+GstWorkerScheduler *gst_worker_scheduler_new (void);
+void gst_worker_scheduler_free (GstWorkerScheduler * scheduler);
+void gst_worker_scheduler_set_threads (gint threads);
+
+void gst_worker_scheduler_start (GstWorkerScheduler * scheduler,
+    GstWorker * worker, ...) G_GNUC_NULL_TERMINATED;
+void gst_worker_scheduler_stop (GstWorkerScheduler * scheduler,
+    GstWorker * worker, ...) G_GNUC_NULL_TERMINATED;
+gboolean gst_worker_scheduler_run (GstWorkerScheduler * scheduler);
+gboolean gst_worker_scheduler_succeeded (GstWorkerScheduler * scheduler,
+    GstWorker * worker);
+
+#endif //__GST_WORKER_SCHEDULER_H__
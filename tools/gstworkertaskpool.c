@@ -0,0 +1,492 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#include <stdlib.h>
+#include "gstworkertaskpool.h"
+#include "../logutils.h"
+
+#define gst_worker_task_pool_parent_class parent_class
+G_DEFINE_TYPE (GstWorkerTaskPool, gst_worker_task_pool, GST_TYPE_TASK_POOL);
+
+/*!< @internal The shared pools by worker class, none until configured. */
+static GHashTable *gst_worker_task_pools = NULL;
+G_LOCK_DEFINE_STATIC (gst_worker_task_pools);
+
+/**
+ * @brief A task pushed to a pool.
+ */
+typedef struct _GstWorkerTaskJob
+{
+  GstWorkerTaskPool *pool;
+  GstTaskPoolFunction func;
+  gpointer data;
+} GstWorkerTaskJob;
+
+/**
+ * @brief The setting of a priority class.
+ * @param name The class name.
+ * @param nice The nice value of its threads.
+ * @param realtime The SCHED_RR priority of its threads, 0 for none.
+ * @param cpus The processors to pin its threads to, or NULL.
+ * @param pool The dedicated pool, if the class has a setting.
+ * @param warned A setting was reported failed.
+ */
+typedef struct _GstWorkerPriorityClass
+{
+  const gchar *name;
+  gint nice;
+  gint realtime;
+  GArray *cpus;
+  GstWorkerTaskPool *pool;
+  gint warned;
+} GstWorkerPriorityClass;
+
+/*!< @internal The priority classes, by GstWorkerPriority. */
+static GstWorkerPriorityClass gst_worker_priorities[] = {
+  {NULL, 0, 0, NULL, NULL, FALSE},
+  {"program", 0, 0, NULL, NULL, FALSE},
+  {"ingest", 0, 0, NULL, NULL, FALSE},
+  {"preview", 0, 0, NULL, NULL, FALSE},
+  {"ui", 0, 0, NULL, NULL, FALSE},
+};
+
+static void
+gst_worker_task_pool_init (GstWorkerTaskPool * pool)
+{
+  pool->name = NULL;
+  pool->threads = NULL;
+  pool->size = 0;
+  pool->cpus = g_array_new (FALSE, FALSE, sizeof (gint));
+  pool->active = 0;
+  pool->peak = 0;
+  pool->warned = FALSE;
+  pool->dedicated = FALSE;
+}
+
+static void
+gst_worker_task_pool_finalize (GstWorkerTaskPool * pool)
+{
+  g_free (pool->name);
+  g_array_free (pool->cpus, TRUE);
+
+  G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (pool));
+}
+
+/**
+ * @brief Run a task in a pool thread, pinned to the processors of the pool.
+ */
+static void
+gst_worker_task_pool_run (GstWorkerTaskJob * job, GstWorkerTaskPool * pool)
+{
+  gint active, peak;
+#ifdef __linux__
+  cpu_set_t saved, set;
+  gboolean pinned = FALSE;
+  guint n;
+
+  // Pool threads are shared with other pools, pin for this task only
+  if (pool->cpus->len && sched_getaffinity (0, sizeof (saved), &saved) == 0) {
+    CPU_ZERO (&set);
+    for (n = 0; n < pool->cpus->len; ++n)
+      CPU_SET (g_array_index (pool->cpus, gint, n), &set);
+    pinned = sched_setaffinity (0, sizeof (set), &set) == 0;
+  }
+#endif
+
+  active = g_atomic_int_add (&pool->active, 1) + 1;
+  do {
+    peak = g_atomic_int_get (&pool->peak);
+  } while (peak < active &&
+      !g_atomic_int_compare_and_exchange (&pool->peak, peak, active));
+
+  if (pool->size && active > (gint) pool->size &&
+      g_atomic_int_compare_and_exchange (&pool->warned, FALSE, TRUE)) {
+    WARN ("%s streaming threads over budget: %d running, %u budgeted",
+        pool->name, active, pool->size);
+  }
+
+  job->func (job->data);
+
+  g_atomic_int_add (&pool->active, -1);
+#ifdef __linux__
+  if (pinned)
+    sched_setaffinity (0, sizeof (saved), &saved);
+#endif
+  g_slice_free (GstWorkerTaskJob, job);
+}
+
+static gpointer
+gst_worker_task_pool_run_thread (GstWorkerTaskJob * job)
+{
+  gst_worker_task_pool_run (job, job->pool);
+  return NULL;
+}
+
+static void
+gst_worker_task_pool_prepare (GstTaskPool * base, GError ** error)
+{
+  GstWorkerTaskPool *pool = GST_WORKER_TASK_POOL (base);
+
+  GST_OBJECT_LOCK (pool);
+  if (pool->threads == NULL && !pool->dedicated) {
+    pool->threads = g_thread_pool_new ((GFunc) gst_worker_task_pool_run,
+        pool, -1, FALSE, error);
+  }
+  GST_OBJECT_UNLOCK (pool);
+}
+
+static void
+gst_worker_task_pool_cleanup (GstTaskPool * base)
+{
+  GstWorkerTaskPool *pool = GST_WORKER_TASK_POOL (base);
+  GThreadPool *threads;
+
+  GST_OBJECT_LOCK (pool);
+  threads = pool->threads;
+  pool->threads = NULL;
+  GST_OBJECT_UNLOCK (pool);
+
+  if (threads)
+    g_thread_pool_free (threads, FALSE, TRUE);
+}
+
+static gpointer
+gst_worker_task_pool_push (GstTaskPool * base, GstTaskPoolFunction func,
+    gpointer data, GError ** error)
+{
+  GstWorkerTaskPool *pool = GST_WORKER_TASK_POOL (base);
+  GstWorkerTaskJob *job;
+  GThread *thread;
+
+  if (pool->threads == NULL && !pool->dedicated) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "%s task pool is not prepared", pool->name);
+    return NULL;
+  }
+
+  job = g_slice_new (GstWorkerTaskJob);
+  job->pool = pool;
+  job->func = func;
+  job->data = data;
+
+  if (pool->dedicated) {
+    thread = g_thread_try_new (pool->name,
+        (GThreadFunc) gst_worker_task_pool_run_thread, job, error);
+    if (thread == NULL)
+      g_slice_free (GstWorkerTaskJob, job);
+    return thread;
+  }
+
+  g_thread_pool_push (pool->threads, job, error);
+  return NULL;
+}
+
+static void
+gst_worker_task_pool_join (GstTaskPool * base, gpointer id)
+{
+  /* GstTask waits for its function to return, a shared thread is kept */
+  if (id)
+    g_thread_join ((GThread *) id);
+}
+
+static void
+gst_worker_task_pool_class_init (GstWorkerTaskPoolClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstTaskPoolClass *pool_class = GST_TASK_POOL_CLASS (klass);
+
+  object_class->finalize = (GObjectFinalizeFunc) gst_worker_task_pool_finalize;
+
+  pool_class->prepare = gst_worker_task_pool_prepare;
+  pool_class->cleanup = gst_worker_task_pool_cleanup;
+  pool_class->push = gst_worker_task_pool_push;
+  pool_class->join = gst_worker_task_pool_join;
+}
+
+/**
+ * @param cpus A list of processors like 0-3+8.
+ * @return TRUE if the list is valid.
+ */
+static gboolean
+gst_worker_task_pool_parse_cpus (GArray * array, const gchar * cpus)
+{
+  gchar **ranges = g_strsplit (cpus, "+", 0);
+  gboolean ok = TRUE;
+  gint i, first, last;
+  gchar *end;
+
+  for (i = 0; ok && ranges[i]; ++i) {
+    first = last = (gint) strtol (ranges[i], &end, 10);
+    if (*end == '-')
+      last = (gint) strtol (end + 1, &end, 10);
+    ok = end != ranges[i] && *end == '\0' && 0 <= first && first <= last &&
+        last < 1024;
+    for (; ok && first <= last; ++first)
+      g_array_append_val (array, first);
+  }
+
+  g_strfreev (ranges);
+  return ok;
+}
+
+/**
+ * @return A new prepared pool.
+ */
+static GstWorkerTaskPool *
+gst_worker_task_pool_new (const gchar * name, guint size, const gchar * cpus,
+    gboolean dedicated)
+{
+  GstWorkerTaskPool *pool;
+  GError *error = NULL;
+
+  pool = GST_WORKER_TASK_POOL (g_object_new (GST_TYPE_WORKER_TASK_POOL, NULL));
+  gst_object_ref_sink (pool);
+  pool->name = g_strdup (name);
+  pool->size = size;
+  pool->dedicated = dedicated;
+
+  if (cpus && !gst_worker_task_pool_parse_cpus (pool->cpus, cpus)) {
+    ERROR ("invalid processors for %s: %s", name, cpus);
+    gst_object_unref (pool);
+    return NULL;
+  }
+
+  gst_task_pool_prepare (GST_TASK_POOL (pool), &error);
+  if (error) {
+    ERROR ("failed to prepare %s task pool: %s", name, error->message);
+    g_error_free (error);
+    gst_object_unref (pool);
+    return NULL;
+  }
+  return pool;
+}
+
+gboolean
+gst_worker_task_pool_configure (const gchar * spec)
+{
+  gchar **items = g_strsplit (spec ? spec : "", ",", 0);
+  gboolean ok = TRUE;
+  gint i;
+
+  G_LOCK (gst_worker_task_pools);
+  if (gst_worker_task_pools == NULL) {
+    gst_worker_task_pools = g_hash_table_new_full (g_str_hash, g_str_equal,
+        NULL, (GDestroyNotify) gst_object_unref);
+    g_thread_pool_set_max_unused_threads (MAX (g_get_num_processors (), 2));
+  }
+
+  for (i = 0; ok && items[i]; ++i) {
+    gchar **fields = g_strsplit (items[i], ":", 3);
+    GstWorkerTaskPool *pool = NULL;
+
+    if (fields[0] && *fields[0] && fields[1]) {
+      pool = gst_worker_task_pool_new (fields[0],
+          (guint) MAX (atoi (fields[1]), 0), fields[2], FALSE);
+    } else if (*items[i]) {
+      ERROR ("invalid task pool: %s", items[i]);
+    }
+    if (pool) {
+      g_hash_table_replace (gst_worker_task_pools, pool->name, pool);
+    } else {
+      ok = *items[i] == '\0';
+    }
+    g_strfreev (fields);
+  }
+
+  if (!g_hash_table_lookup (gst_worker_task_pools,
+          GST_WORKER_TASK_POOL_DEFAULT)) {
+    GstWorkerTaskPool *pool = gst_worker_task_pool_new
+        (GST_WORKER_TASK_POOL_DEFAULT, 0, NULL, FALSE);
+    if (pool)
+      g_hash_table_replace (gst_worker_task_pools, pool->name, pool);
+  }
+  G_UNLOCK (gst_worker_task_pools);
+
+  g_strfreev (items);
+  return ok;
+}
+
+GstTaskPool *
+gst_worker_task_pool_get (const gchar * task_class)
+{
+  GstTaskPool *pool = NULL;
+
+  G_LOCK (gst_worker_task_pools);
+  if (gst_worker_task_pools) {
+    if (task_class)
+      pool = g_hash_table_lookup (gst_worker_task_pools, task_class);
+    if (pool == NULL)
+      pool = g_hash_table_lookup (gst_worker_task_pools,
+          GST_WORKER_TASK_POOL_DEFAULT);
+  }
+  G_UNLOCK (gst_worker_task_pools);
+  return pool;
+}
+
+void
+gst_worker_task_pool_dump (void)
+{
+  GHashTableIter iter;
+  GstWorkerTaskPool *pool;
+
+  G_LOCK (gst_worker_task_pools);
+  if (gst_worker_task_pools) {
+    g_hash_table_iter_init (&iter, gst_worker_task_pools);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & pool)) {
+      INFO ("%s streaming threads: %d running, %d at most, %u budgeted",
+          pool->name, g_atomic_int_get (&pool->active),
+          g_atomic_int_get (&pool->peak), pool->size);
+    }
+  }
+  G_UNLOCK (gst_worker_task_pools);
+}
+
+/**
+ * @return The class of the name, or NULL.
+ */
+static GstWorkerPriorityClass *
+gst_worker_priority_find (const gchar * name)
+{
+  guint n;
+
+  for (n = GST_WORKER_PRIORITY_NONE + 1; n < GST_WORKER_PRIORITY__LAST; ++n) {
+    if (g_strcmp0 (gst_worker_priorities[n].name, name) == 0)
+      return &gst_worker_priorities[n];
+  }
+  return NULL;
+}
+
+gboolean
+gst_worker_priority_configure (const gchar * spec)
+{
+  gchar **items = g_strsplit (spec ? spec : "", ",", 0);
+  GstWorkerPriorityClass *priority;
+  gboolean ok = TRUE;
+  gchar *end;
+  guint n;
+
+  G_LOCK (gst_worker_task_pools);
+  for (n = 0; ok && items[n]; ++n) {
+    gchar **fields = g_strsplit (items[n], ":", 3);
+
+    priority = gst_worker_priority_find (fields[0]);
+    ok = priority != NULL && fields[1] && *fields[1];
+    if (ok && g_str_has_prefix (fields[1], "rt")) {
+      priority->realtime = (gint) strtol (fields[1] + 2, &end, 10);
+      ok = *end == '\0' && 0 < priority->realtime &&
+          priority->realtime <= 99;
+    } else if (ok) {
+      priority->nice = (gint) strtol (fields[1], &end, 10);
+      priority->realtime = 0;
+      ok = *end == '\0' && -20 <= priority->nice && priority->nice <= 19;
+    }
+    if (ok && fields[2]) {
+      if (priority->cpus == NULL)
+        priority->cpus = g_array_new (FALSE, FALSE, sizeof (gint));
+      g_array_set_size (priority->cpus, 0);
+      ok = gst_worker_task_pool_parse_cpus (priority->cpus, fields[2]);
+    }
+    if (!ok && *items[n])
+      ERROR ("invalid priority: %s", items[n]);
+    ok = ok || *items[n] == '\0';
+    g_strfreev (fields);
+  }
+
+  for (n = GST_WORKER_PRIORITY_NONE + 1; n < GST_WORKER_PRIORITY__LAST; ++n) {
+    priority = &gst_worker_priorities[n];
+    if (priority->pool || !(priority->nice || priority->realtime ||
+            (priority->cpus && priority->cpus->len)))
+      continue;
+    priority->pool = gst_worker_task_pool_new (priority->name, 0, NULL, TRUE);
+  }
+  G_UNLOCK (gst_worker_task_pools);
+
+  g_strfreev (items);
+  return ok;
+}
+
+GstTaskPool *
+gst_worker_priority_get_pool (GstWorkerPriority priority)
+{
+  GstTaskPool *pool = NULL;
+
+  g_return_val_if_fail (priority < GST_WORKER_PRIORITY__LAST, NULL);
+
+  G_LOCK (gst_worker_task_pools);
+  pool = (GstTaskPool *) gst_worker_priorities[priority].pool;
+  G_UNLOCK (gst_worker_task_pools);
+  return pool;
+}
+
+void
+gst_worker_priority_enter (GstWorkerPriority priority)
+{
+  GstWorkerPriorityClass *class;
+#ifdef __linux__
+  gboolean realtime = FALSE;
+  struct sched_param param;
+  cpu_set_t set;
+  guint n;
+#endif
+
+  g_return_if_fail (priority < GST_WORKER_PRIORITY__LAST);
+
+  class = &gst_worker_priorities[priority];
+  if (class->pool == NULL)
+    return;
+
+#ifdef __linux__
+  if (class->realtime) {
+    param.sched_priority = class->realtime;
+    realtime = pthread_setschedparam (pthread_self (), SCHED_RR, &param) == 0;
+    if (!realtime && g_atomic_int_compare_and_exchange (&class->warned,
+            FALSE, TRUE))
+      WARN ("%s threads: no privilege for SCHED_RR, using nice %d",
+          class->name, class->nice);
+  }
+  if (!realtime && class->nice &&
+      setpriority (PRIO_PROCESS, (id_t) syscall (SYS_gettid),
+          class->nice) != 0 &&
+      g_atomic_int_compare_and_exchange (&class->warned, FALSE, TRUE))
+    WARN ("%s threads: no privilege for nice %d", class->name, class->nice);
+  if (class->cpus && class->cpus->len) {
+    CPU_ZERO (&set);
+    for (n = 0; n < class->cpus->len; ++n)
+      CPU_SET (g_array_index (class->cpus, gint, n), &set);
+    sched_setaffinity (0, sizeof (set), &set);
+  }
+#endif
+}
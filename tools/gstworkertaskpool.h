@@ -0,0 +1,140 @@
+/* gst-switch							    -*- c -*-
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This file is part of gst-switch.
+ *
+ * gst-switch is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*! @file */
+
+#ifndef __GST_WORKER_TASK_POOL_H__
+#define __GST_WORKER_TASK_POOL_H__
+
+#include <gst/gst.h>
+
+#define GST_TYPE_WORKER_TASK_POOL (gst_worker_task_pool_get_type ())
+#define GST_WORKER_TASK_POOL(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), GST_TYPE_WORKER_TASK_POOL, GstWorkerTaskPool))
+#define GST_WORKER_TASK_POOL_CLASS(class) (G_TYPE_CHECK_CLASS_CAST ((class), GST_TYPE_WORKER_TASK_POOL, GstWorkerTaskPoolClass))
+#define GST_IS_WORKER_TASK_POOL(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), GST_TYPE_WORKER_TASK_POOL))
+
+#define GST_WORKER_TASK_POOL_DEFAULT "default"
+
+/**
+ * @enum GstWorkerPriority
+ *
+ * The priority classes of the streaming threads of workers.
+ */
+typedef enum
+{
+  GST_WORKER_PRIORITY_NONE,     /*!< Threads are left as they are. */
+  GST_WORKER_PRIORITY_PROGRAM,  /*!< The composite, output and recordings. */
+  GST_WORKER_PRIORITY_INGEST,   /*!< Reading the inputs. */
+  GST_WORKER_PRIORITY_PREVIEW,  /*!< Serving previews of the inputs. */
+  GST_WORKER_PRIORITY_UI,       /*!< Displaying in the user interface. */
+  GST_WORKER_PRIORITY__LAST,    /*!< @internal */
+} GstWorkerPriority;
+
+typedef struct _GstWorkerTaskPool GstWorkerTaskPool;
+typedef struct _GstWorkerTaskPoolClass GstWorkerTaskPoolClass;
+
+/**
+ *  @class GstWorkerTaskPool
+ *  @struct _GstWorkerTaskPool
+ *  @brief The streaming threads of one class of workers.
+ *
+ *  One pool is shared by all pipelines of the workers of a class, instead
+ *  of every task of every pipeline starting and joining its own thread.
+ *  A streaming task keeps its thread for as long as it runs, so the size
+ *  of a class is a budget which is warned about when passed, not a hard
+ *  limit that would stall pipelines. Threads left idle are reused by the
+ *  next tasks, up to a number that depends on the processors.
+ *
+ *  A dedicated pool starts a thread per task instead, which is left with
+ *  the task's priority and processors when it ends rather than reused.
+ */
+struct _GstWorkerTaskPool
+{
+  GstTaskPool base;             /*!< the parent object */
+
+  gchar *name;                  /*!< the worker class */
+  GThreadPool *threads;         /*!< the threads running the tasks */
+  guint size;                   /*!< the thread budget, 0 for none */
+  GArray *cpus;                 /*!< the processors to pin to, or empty */
+  gint active;                  /*!< the tasks running */
+  gint peak;                    /*!< the most tasks ever running */
+  gboolean warned;              /*!< the budget was reported passed */
+  gboolean dedicated;           /*!< a new thread for every task */
+};
+
+/**
+ *  @class GstWorkerTaskPoolClass
+ *  @struct _GstWorkerTaskPoolClass
+ *  @brief The class of GstWorkerTaskPool.
+ */
+struct _GstWorkerTaskPoolClass
+{
+  GstTaskPoolClass base_class;  /*!< the parent class */
+};
+
+GType gst_worker_task_pool_get_type (void);
+
+/**
+ *  @param spec Comma separated CLASS:THREADS[:CPUS] items, CPUS a list of
+ *  processors like 0-3+8, or NULL.
+ *  @return TRUE if the spec is valid
+ *
+ *  Enable the shared pools and size them. Classes not in the spec share
+ *  the "default" pool.
+ */
+gboolean gst_worker_task_pool_configure (const gchar * spec);
+
+/**
+ *  @param task_class The class of a worker, or NULL.
+ *  @return the shared pool of the class, NULL if the shared pools were not
+ *  enabled by gst_worker_task_pool_configure()
+ */
+GstTaskPool *gst_worker_task_pool_get (const gchar * task_class);
+
+/**
+ *  Print the peak number of tasks of each pool.
+ */
+void gst_worker_task_pool_dump (void);
+
+/**
+ *  @param spec Comma separated CLASS:SETTING[:CPUS] items, CLASS one of
+ *  program, ingest, preview and ui, SETTING a nice value or rtN for
+ *  SCHED_RR at priority N, or NULL for the defaults.
+ *  @return TRUE if the spec is valid
+ *
+ *  Enable the priority classes. No class has a setting by default, and a
+ *  class with a setting gets dedicated threads.
+ */
+gboolean gst_worker_priority_configure (const gchar * spec);
+
+/**
+ *  @param priority A priority class.
+ *  @return the dedicated pool of the class, or NULL if it has no setting
+ */
+GstTaskPool *gst_worker_priority_get_pool (GstWorkerPriority priority);
+
+/**
+ *  @param priority The priority class of the task.
+ *
+ *  Apply the setting of the class to the calling streaming thread, falling
+ *  back to a nice value without the privilege for SCHED_RR.
+ */
+void gst_worker_priority_enter (GstWorkerPriority priority);
+
+#endif //__GST_WORKER_TASK_POOL_H__